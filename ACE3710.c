@@ -12,10 +12,19 @@ Written by Adam Billings
 #include "Help/MainHelp.h"
 #include "MiscAssembler.h"
 #include "DataStructures/List.h"
+#include "DataStructures/StringTable.h"
 #include "ConfigReader.h"
+#include "SourceIndex.h"
 #include "MacroReading.h"
 #include "VarEvaluation.h"
 #include "Assemble.h"
+#include "PassTimer.h"
+#include "TraceEvents.h"
+#include "AssemblerStats.h"
+#include "RecordOutput.h"
+#include "BankOutput.h"
+#include "RawOutput.h"
+#include "AllocTrace.h"
 
 /*
 set a default configuration
@@ -50,6 +59,11 @@ void printVersion() {
 }
 
 int main(int argc, char* argv[]) {
+    // report allocations in the instrumented build
+    #ifdef ALLOC_TRACE
+    atexit(printAllocTrace);
+    #endif
+
     // handle args
     char* fileName = NULL;
     char hasConfig = 0;
@@ -58,9 +72,15 @@ int main(int argc, char* argv[]) {
     char isDefaultConfig = 1;
     char isLittleEndian = 1;
     char isHex = 0;
+    char isOnePass = 0;
+    char isTimed = 0;
+    char isStats = 0;
+    char isCounted = 0;
+    char* timesFileName = NULL;
     char* outputFileName = NULL;
     unsigned int wordSize = 2;
     List* segments = getDefaultConfig();
+    List* banks = newList();
     for (int i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "--help")) {
             if (i < argc - 1 && argv[i + 1][0] != '-') {
@@ -69,7 +89,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -91,6 +111,69 @@ int main(int argc, char* argv[]) {
         else if (!strcmp(argv[i], "--text-byte")) {isHex = 1; continue;}
         else if (!strcmp(argv[i], "--text-word")) {isHex = 2; continue;}
         else if (!strcmp(argv[i], "--raw")) {isHex = 0; continue;}
+        else if (!strcmp(argv[i], "--ihex")) {isHex = 3; continue;}
+        else if (!strcmp(argv[i], "--srec")) {isHex = 4; continue;}
+        else if (!strcmp(argv[i], "--readmemh")) {isHex = 5; continue;}
+        else if (!strcmp(argv[i], "--coe")) {isHex = 6; continue;}
+        else if (!strcmp(argv[i], "--mif")) {isHex = 7; continue;}
+        else if (!strcmp(argv[i], "--one-pass")) {isOnePass = 1; continue;}
+        else if (!strcmp(argv[i], "--time-passes")) {isTimed = 1; continue;}
+        else if (!strcmp(argv[i], "--stats")) {isStats = 1; enableStats(); continue;}
+        else if (!strcmp(argv[i], "--perf-counters")) {
+            // keep assembling without counters, the report says why they are missing
+            isCounted = 1;
+            startPassCounters();
+            continue;
+        }
+        else if (!strcmp(argv[i], "--time-passes-json")) {
+            i++;
+            if (i >= argc || argv[i][0] == '-') {
+                // delete segments
+                if (!isDefaultConfig) {
+                    for (Node* node = segments->head; node != NULL; node = node->next) {
+                        SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
+                        free(segDef->name);
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
+                    }
+                }
+                deleteList(segments);
+                printf("\e[1;31mERROR:\e[0m Expected pass times file\n\n");
+                return -2;
+            }
+            timesFileName = argv[i];
+            continue;
+        }
+        else if (!strcmp(argv[i], "--trace")) {
+            i++;
+            if (i >= argc || argv[i][0] == '-') {
+                // delete segments
+                if (!isDefaultConfig) {
+                    for (Node* node = segments->head; node != NULL; node = node->next) {
+                        SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
+                        free(segDef->name);
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
+                    }
+                }
+                deleteList(segments);
+                printf("\e[1;31mERROR:\e[0m Expected trace file\n\n");
+                return -2;
+            }
+
+            // opened now, before the assembler moves to the directory of the source
+            if (!openTraceEvents(argv[i])) {
+                if (!isDefaultConfig) {
+                    for (Node* node = segments->head; node != NULL; node = node->next) {
+                        SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
+                        free(segDef->name);
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
+                    }
+                }
+                deleteList(segments);
+                printf("\e[1;31mERROR:\e[0m Could not open %s\n\n", argv[i]);
+                return -2;
+            }
+            continue;
+        }
         else if (!strcmp(argv[i], "--config")) {
             if (hasConfig) {
                 // delete segments
@@ -98,7 +181,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -127,9 +210,13 @@ int main(int argc, char* argv[]) {
             cfgHandle.length = ftell(cfgHandle.fptr);
             rewind(cfgHandle.fptr);
             List* errorList = newList();
+            startPass(PASS_VALIDATE);
             validateFile(&cfgHandle, errorList);
+            endPass();
             if (errorList->size == 0) {
-                segments = readConfigFile(&cfgHandle, errorList);
+                startPass(PASS_CONFIG);
+                segments = readConfigFile(&cfgHandle, errorList, banks);
+                endPass();
             }
 
             // handle the errors
@@ -162,7 +249,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -178,7 +265,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -196,7 +283,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -213,7 +300,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -230,7 +317,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -246,7 +333,7 @@ int main(int argc, char* argv[]) {
                 for (Node* node = segments->head; node != NULL; node = node->next) {
                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                     free(segDef->name);
-                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                 }
             }
             deleteList(segments);
@@ -259,7 +346,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -273,7 +360,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -289,7 +376,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -301,7 +388,7 @@ int main(int argc, char* argv[]) {
                     for (Node* node = segments->head; node != NULL; node = node->next) {
                         SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                        if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                        if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                     }
                 }
                 deleteList(segments);
@@ -317,7 +404,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -340,6 +427,7 @@ int main(int argc, char* argv[]) {
                     else if (argv[i][j] == 't') {isHex = 1; continue;}
                     else if (argv[i][j] == 'T') {isHex = 2; continue;}
                     else if (argv[i][j] == 'r') {isHex = 0; continue;}
+                    else if (argv[i][j] == '1') {isOnePass = 1; continue;}
                     else if (argv[i][j] == 'c') {
                         if (hasConfig) {
                             // delete segments
@@ -347,7 +435,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -369,7 +457,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             printf("\e[1;31mERROR:\e[0m Expected configuration file\n\n");
@@ -384,9 +472,13 @@ int main(int argc, char* argv[]) {
                         cfgHandle.length = ftell(cfgHandle.fptr);
                         rewind(cfgHandle.fptr);
                         List* errorList = newList();
+                        startPass(PASS_VALIDATE);
                         validateFile(&cfgHandle, errorList);
+                        endPass();
                         if (errorList->size == 0) {
-                            segments = readConfigFile(&cfgHandle, errorList);
+                            startPass(PASS_CONFIG);
+                            segments = readConfigFile(&cfgHandle, errorList, banks);
+                            endPass();
                         }
 
                         // handle the errors
@@ -419,7 +511,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -435,7 +527,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -453,7 +545,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -470,7 +562,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -487,7 +579,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -503,7 +595,7 @@ int main(int argc, char* argv[]) {
                             for (Node* node = segments->head; node != NULL; node = node->next) {
                                 SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                 free(segDef->name);
-                                if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                             }
                         }
                         deleteList(segments);
@@ -516,7 +608,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -530,7 +622,7 @@ int main(int argc, char* argv[]) {
                                 for (Node* node = segments->head; node != NULL; node = node->next) {
                                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                                 }
                             }
                             deleteList(segments);
@@ -545,7 +637,7 @@ int main(int argc, char* argv[]) {
                             for (Node* node = segments->head; node != NULL; node = node->next) {
                                 SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                                     free(segDef->name);
-                                if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                                if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                             }
                         }
                         deleteList(segments);
@@ -565,7 +657,7 @@ int main(int argc, char* argv[]) {
                 for (Node* node = segments->head; node != NULL; node = node->next) {
                     SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                     free(segDef->name);
-                    if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                    if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
                 }
             }
             deleteList(segments);
@@ -586,7 +678,7 @@ int main(int argc, char* argv[]) {
             for (Node* node = segments->head; node != NULL; node = node->next) {
                 SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                 free(segDef->name);
-                if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
             }
         }
         deleteList(segments);
@@ -606,7 +698,7 @@ int main(int argc, char* argv[]) {
             for (Node* node = segments->head; node != NULL; node = node->next) {
                 SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                 free(segDef->name);
-                if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
             }
         }
         deleteList(segments);
@@ -625,7 +717,7 @@ int main(int argc, char* argv[]) {
             for (Node* node = segments->head; node != NULL; node = node->next) {
                 SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                 free(segDef->name);
-                if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
             }
         }
         deleteList(segments);
@@ -648,21 +740,53 @@ int main(int argc, char* argv[]) {
         appendList(handles, &mainFileHandle, sizeof(FileHandle));
 
         // validate the main file
+        startPassAt(PASS_VALIDATE, &mainFileHandle, 0);
         validateFile(&mainFileHandle, errorList);
+        endPass();
 
         // assemble
         StringTable macros = NULL;
         StringTable vars = NULL;
-        if (errorList->size == 0) {macros = readMacros(&mainFileHandle, errorList, handles, macroDeleteTracker);}
-        if (errorList->size == 0) {rewind(mainFileHandle.fptr); vars = readGlobalVars(&mainFileHandle, errorList, handles, segments, macros, wordSize);}
-        if (errorList->size == 0) {rewind(mainFileHandle.fptr); assemble(&mainFileHandle, errorList, handles, segments, macros, vars, wordSize, isLittleEndian);}
+        if (errorList->size == 0) {
+            startPassAt(PASS_MACROS, &mainFileHandle, 0);
+            macros = readMacros(&mainFileHandle, errorList, handles, macroDeleteTracker);
+            endPass();
+        }
+        if (errorList->size == 0 && isOnePass) {vars = newStringTable(); addRegisterVars(vars);}
+        else if (errorList->size == 0) {
+            startPassAt(PASS_GLOBALS, &mainFileHandle, 0);
+            countPassRewind(mainFileHandle.fptr, 0);
+            rewind(mainFileHandle.fptr);
+            vars = readGlobalVars(&mainFileHandle, errorList, handles, segments, macros, wordSize);
+            endPass();
+        }
+        if (errorList->size == 0) {
+            startPassAt(PASS_ASSEMBLE, &mainFileHandle, 0);
+            countPassRewind(mainFileHandle.fptr, 0);
+            rewind(mainFileHandle.fptr);
+            assemble(&mainFileHandle, errorList, handles, segments, macros, vars, wordSize, isLittleEndian, isOnePass);
+            endPass();
+        }
 
         // output
         if (errorList->size == 0) {
-            FILE* output;
-            output = fopen(outputFileName, isHex ? "w" : "wb");
-            if (output == NULL) {
+            startPass(PASS_OUTPUT);
+            FILE* output = NULL;
+            if (isHex < 5) {output = fopen(outputFileName, isHex ? "w" : "wb");}
+            if (isHex >= 5) {
+                // one file for each bank and lane of the configuration
+                writeBanks(segments, banks, wordSize, isLittleEndian, (BankFormat)(isHex - 5), outputFileName);
+            } else if (output == NULL) {
                 printf("\e[1,31mERROR:\e[0m could not open output file\n\n");
+            } else if (isHex == 3 || isHex == 4) {
+                // only the written bytes, at the address of each segment
+                if (isHex == 3) {writeIntelHex(segments, wordSize, output);}
+                else {writeSRecords(segments, wordSize, output);}
+                fclose(output);
+            } else if (isHex == 0) {
+                // zero runs are left as holes
+                if (!writeRawImage(segments, wordSize, output)) {printf("\e[1;31mERROR:\e[0m Could not write %s\n\n", outputFileName);}
+                fclose(output);
             } else {
                 long pos = 0;
                 for (Node* node = segments->head; node != NULL; node = node->next) {
@@ -694,19 +818,19 @@ int main(int argc, char* argv[]) {
                                 for (int i = 0; i < seg->size * (wordSize == 1 ? 2 : 1); i++) {
                                     if (isHex == 1) {
                                         int linePos = (pos + i) % 16;
-                                        if (linePos == 15) {fprintf(output, "%02x\n", seg->outputArr[i]);}
-                                        else if (linePos == 7) {fprintf(output, "%02x  ", seg->outputArr[i]);}
-                                        else {fprintf(output, "%02x ", seg->outputArr[i]);}
+                                        if (linePos == 15) {fprintf(output, "%02x\n", readSegmentByte(seg->image, i));}
+                                        else if (linePos == 7) {fprintf(output, "%02x  ", readSegmentByte(seg->image, i));}
+                                        else {fprintf(output, "%02x ", readSegmentByte(seg->image, i));}
                                     } else {
                                         if (i == seg->size * (wordSize == 1 ? 2 : 1) - 1 && !(i & 0x0001)) {
                                             int linePos = (pos + i + 1) % 16;
-                                            if (linePos == 15) {fprintf(output, "%04x\n", seg->outputArr[i]);}
-                                            else if (linePos == 7) {fprintf(output, "%04x  ", seg->outputArr[i]);}
-                                            else {fprintf(output, "%04x ", seg->outputArr[i]);}
+                                            if (linePos == 15) {fprintf(output, "%04x\n", readSegmentByte(seg->image, i));}
+                                            else if (linePos == 7) {fprintf(output, "%04x  ", readSegmentByte(seg->image, i));}
+                                            else {fprintf(output, "%04x ", readSegmentByte(seg->image, i));}
                                         }
-                                        else if (!(i & 0x0001)) {data = isLittleEndian ? seg->outputArr[i] : (seg->outputArr[i] << 8);}
+                                        else if (!(i & 0x0001)) {data = isLittleEndian ? readSegmentByte(seg->image, i) : (readSegmentByte(seg->image, i) << 8);}
                                         else {
-                                            data |= isLittleEndian ? (seg->outputArr[i] << 8) : seg->outputArr[i];
+                                            data |= isLittleEndian ? (readSegmentByte(seg->image, i) << 8) : readSegmentByte(seg->image, i);
                                             int linePos = (pos + i) % 16;
                                             if (linePos == 15) {fprintf(output, "%04x\n", data);}
                                             else if (linePos == 7) {fprintf(output, "%04x  ", data);}
@@ -714,7 +838,7 @@ int main(int argc, char* argv[]) {
                                         }
                                     }
                                 }
-                            } else {fwrite(seg->outputArr, 1, seg->size * (wordSize == 1 ? 2 : 1), output);}
+                            } else {writeSegmentImage(seg->image, seg->size * (wordSize == 1 ? 2 : 1), output);}
                             pos += seg->size * (wordSize == 1 ? 2 : 1);
                         } else {
                             if (isHex) {
@@ -722,19 +846,19 @@ int main(int argc, char* argv[]) {
                                 for (int i = 0; i < seg->writeAddr; i++) {
                                     if (isHex == 1) {
                                         int linePos = (pos + i) % 16;
-                                        if (linePos == 15) {fprintf(output, "%02x\n", seg->outputArr[i]);}
-                                        else if (linePos == 7) {fprintf(output, "%02x  ", seg->outputArr[i]);}
-                                        else {fprintf(output, "%02x ", seg->outputArr[i]);}
+                                        if (linePos == 15) {fprintf(output, "%02x\n", readSegmentByte(seg->image, i));}
+                                        else if (linePos == 7) {fprintf(output, "%02x  ", readSegmentByte(seg->image, i));}
+                                        else {fprintf(output, "%02x ", readSegmentByte(seg->image, i));}
                                     } else {
                                         if (i == seg->writeAddr - 1 && !(i & 0x0001)) {
                                             int linePos = (pos + i + 1) % 16;
-                                            if (linePos == 15) {fprintf(output, "%04x\n", seg->outputArr[i]);}
-                                            else if (linePos == 7) {fprintf(output, "%04x  ", seg->outputArr[i]);}
-                                            else {fprintf(output, "%04x ", seg->outputArr[i]);}
+                                            if (linePos == 15) {fprintf(output, "%04x\n", readSegmentByte(seg->image, i));}
+                                            else if (linePos == 7) {fprintf(output, "%04x  ", readSegmentByte(seg->image, i));}
+                                            else {fprintf(output, "%04x ", readSegmentByte(seg->image, i));}
                                         }
-                                        else if (!(i & 0x0001)) {data = isLittleEndian ? seg->outputArr[i] : (seg->outputArr[i] << 8);}
+                                        else if (!(i & 0x0001)) {data = isLittleEndian ? readSegmentByte(seg->image, i) : (readSegmentByte(seg->image, i) << 8);}
                                         else {
-                                            data |= isLittleEndian ? (seg->outputArr[i] << 8) : seg->outputArr[i];
+                                            data |= isLittleEndian ? (readSegmentByte(seg->image, i) << 8) : readSegmentByte(seg->image, i);
                                             int linePos = (pos + i) % 16;
                                             if (linePos == 15) {fprintf(output, "%04x\n", data);}
                                             else if (linePos == 7) {fprintf(output, "%04x  ", data);}
@@ -742,16 +866,19 @@ int main(int argc, char* argv[]) {
                                         }
                                     }
                                 }
-                            } else {fwrite(seg->outputArr, 1, seg->writeAddr, output);}
+                            } else {writeSegmentImage(seg->image, seg->writeAddr, output);}
                             pos += seg->writeAddr;
                         }
                     }
                 }
                 fclose(output);
             }
+            endPass();
         }
 
         // assembly cleanup
+        if (vars != NULL) {recordTableStats("varDefs", vars);}
+        if (macros != NULL) {recordTableStats("macroDefs", macros);}
         if (macros != NULL) {deleteStringTable(macros);}
         if (vars != NULL) {deleteStringTable(vars);}
     } else {
@@ -761,7 +888,7 @@ int main(int argc, char* argv[]) {
             for (Node* node = segments->head; node != NULL; node = node->next) {
                 SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
                         free(segDef->name);
-                if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+                if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
             }
         }
         deleteList(segments);
@@ -778,13 +905,9 @@ int main(int argc, char* argv[]) {
     }
     deleteList(macroDeleteTracker);
 
-    // print all errors
+    // print all errors, skipping repeats reported by rescans of the same line
     int hasError = errorList->size;
-    for (Node* node = errorList->head; node != NULL; node = node->next) {
-        ErrorData errorData = *(ErrorData*)(node->dataptr);
-        printError(errorData);
-        free(errorData.errorMsg);
-    }
+    printErrors(errorList);
     deleteList(errorList);
 
     // close all files
@@ -792,18 +915,49 @@ int main(int argc, char* argv[]) {
         FileHandle handle = *(FileHandle*)(node->dataptr);
         free(handle.name);
         fclose(handle.fptr);
+        if (handle.ifJumps != NULL) {deleteStringTable(handle.ifJumps);}
+        if (handle.index != NULL) {deleteSourceIndex(handle.index);}
+        if (handle.repts != NULL) {deleteStringTable(handle.repts);}
     }
     deleteList(handles);
 
+    // the passes use the main file through its own handle, not the copy in the list
+    if (mainFileHandle.ifJumps != NULL) {deleteStringTable(mainFileHandle.ifJumps);}
+    if (mainFileHandle.index != NULL) {deleteSourceIndex(mainFileHandle.index);}
+    if (mainFileHandle.repts != NULL) {deleteStringTable(mainFileHandle.repts);}
+
     // delete segments
     if (!isDefaultConfig) {
         for (Node* node = segments->head; node != NULL; node = node->next) {
             SegmentDef* segDef = ((SegmentDef*)(node->dataptr));
             free(segDef->name);
-            if (segDef->outputArr != NULL) {free(segDef->outputArr);}
+            if (segDef->image != NULL) {deleteSegmentImage(segDef->image);}
         }
     }
     deleteList(segments);
+    for (Node* node = banks->head; node != NULL; node = node->next) {
+        free(((BankDef*)(node->dataptr))->name);
+    }
+    deleteList(banks);
+
+    // report the structure counts
+    if (isStats) {printStats(stdout);}
+
+    // finish the timeline
+    closeTraceEvents();
+
+    // report pass times
+    if (isTimed) {printPassTimes(stdout);}
+    if (isCounted) {printPassCounters(stdout);}
+    if (timesFileName != NULL) {
+        FILE* timesFile = fopen(timesFileName, "w");
+        if (timesFile == NULL) {printf("\e[1;31mERROR:\e[0m Could not open %s\n\n", timesFileName);}
+        else {
+            writePassTimesJson(timesFile);
+            fclose(timesFile);
+        }
+    }
+    closePerfCounters();
 
     // fail on errors
     if (hasError) {return -1;}
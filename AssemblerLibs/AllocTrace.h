@@ -0,0 +1,111 @@
+/*
+allocation counters for the instrumented build
+every malloc, calloc, realloc and free is counted against its call site and the running pass
+only active when built with "make instrumented", which includes this file first in every file
+
+Written by Adam Billings
+*/
+
+#ifndef AllocTrace_h
+#define AllocTrace_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ALLOC_TRACE
+
+// number of call sites in the report
+#ifndef ALLOC_TRACE_TOP
+#define ALLOC_TRACE_TOP 20
+#endif
+
+// counts of one call site
+typedef struct AllocSite {
+    const char* file;
+    const char* func;
+    int line;
+    unsigned long count;
+    unsigned long bytes;
+} AllocSite;
+
+/*
+counted malloc
+
+size: bytes to allocate
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: new block
+*/
+void* traceMalloc(size_t size, const char* file, int line, const char* func);
+
+/*
+counted calloc
+
+count: number of elements
+size: size of an element
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: new zeroed block
+*/
+void* traceCalloc(size_t count, size_t size, const char* file, int line, const char* func);
+
+/*
+counted realloc
+
+ptr: block to resize, may be NULL
+size: new size of the block
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: resized block
+*/
+void* traceRealloc(void* ptr, size_t size, const char* file, int line, const char* func);
+
+/*
+counted free
+
+ptr: block to free, may be NULL
+*/
+void traceFree(void* ptr);
+
+/*
+prints the allocation report, registered to run at exit
+*/
+void printAllocTrace();
+
+/*
+finds or adds the counts of a call site
+
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: counts of the call site
+*/
+static AllocSite* getAllocSite(const char* file, int line, const char* func);
+
+/*
+records a new block
+
+size: size of the block
+file: file of the call
+line: line of the call
+func: function of the call
+*/
+static void countAlloc(size_t size, const char* file, int line, const char* func);
+
+// send allocations through the counters
+#define malloc(size) traceMalloc((size), __FILE__, __LINE__, __func__)
+#define calloc(count, size) traceCalloc((count), (size), __FILE__, __LINE__, __func__)
+#define realloc(ptr, size) traceRealloc((ptr), (size), __FILE__, __LINE__, __func__)
+#define free(ptr) traceFree(ptr)
+
+#endif
+
+#endif
@@ -13,6 +13,186 @@ Written by Adam Billings
 #include "ExpressionEvaluation.h"
 #include "CodeGeneration.h"
 
+// macro expansion being recorded for the expansion cache
+typedef struct ExpansionRecord {
+    char* key;
+    SegmentDef* seg;
+    uint16_t start;
+    unsigned int depth;
+    unsigned int errorCount;
+} ExpansionRecord;
+
+// global assignment waiting on later globals in one-pass mode
+typedef struct DeferredVar {
+    char* name;
+    char* expr;
+    unsigned int line;
+    unsigned int col;
+    FileHandle* handle;
+} DeferredVar;
+
+// instruction encoded once the later globals it uses are known in one-pass mode
+typedef struct Fixup {
+    SegmentDef* seg;
+    uint16_t writeAddr;
+    uint16_t curAddr;
+    InstData* instData;
+    char* operands;
+    uint16_t* args;
+    int argCount;
+    unsigned int line;
+    unsigned int col;
+    unsigned int len;
+    FileHandle* handle;
+} Fixup;
+
+/*
+saves the write address of every segment before a look ahead
+
+segArr: dense array of the segments
+segCount: number of segments
+saved: output write addresses, one per segment
+wordSize: addresses occupied by a 16-bit word
+*/
+static void checkpointSegments(SegmentDef** segArr, int segCount, uint16_t* saved, int wordSize);
+
+/*
+restores the write address of every segment after a look ahead
+
+segArr: dense array of the segments
+segCount: number of segments
+saved: write addresses from checkpointSegments
+*/
+static void restoreSegments(SegmentDef** segArr, int segCount, const uint16_t* saved);
+
+/*
+extracts the next name from operand text, skipping numbers and character literals
+
+cursor: position to scan from, moved past the name
+
+returns: the name in a new string, NULL at the end of the operands
+*/
+static char* nextOperandName(char** cursor);
+
+/*
+determines if every expansion of a macro with the same arguments assembles to the same bytes
+the body may only hold non-branch instructions and .word data without labels, local names or defines
+
+macroData: macro to check
+name: name of the macro
+purity: results of earlier checks by macro name
+instTable: instruction lookup table
+varDefs: defined vars, operands may only name these since defines can change between calls
+
+returns: if the expansion can be cached
+*/
+static char isPureMacro(MacroDefData* macroData, char* name, StringTable purity, StringTable instTable, StringTable varDefs);
+
+/*
+stores the bytes of every recorded expansion whose macro call has returned
+
+recordings: stack of expansions being recorded
+expansions: cached expansions by macro name and argument values
+macroStack: stack of macro returns
+errorList: list of errors
+activeSeg: current segment
+*/
+static void finishExpansions(Stack* recordings, StringTable expansions, PersistentStack* macroStack, List* errorList, SegmentDef* activeSeg);
+
+/*
+evaluates the operands of an instruction
+
+operands: text after the mnemonic
+varDefs: defined vars
+defines: current defines
+argEvals: output list of operand values
+
+returns: the first evaluation error in a new string, NULL if every operand evaluated
+*/
+static char* evalOperands(char* operands, StringTable varDefs, StringTable defines, List* argEvals);
+
+/*
+encodes an instruction from its evaluated operands, range errors cover the whole operand text
+
+instData: instruction to encode
+argEvals: operand values
+curAddr: address of the instruction
+wordSize: addresses occupied by a 16-bit word
+inst: output instruction
+errorList: list of errors
+line: line of the instruction
+col: column of the operands
+len: length of the operands
+handle: file of the instruction
+
+returns: if the instruction was encoded
+*/
+static char encodeInstruction(InstData* instData, List* argEvals, uint16_t curAddr, int wordSize, uint16_t* inst, List* errorList, unsigned int line, unsigned int col, unsigned int len, FileHandle* handle);
+
+/*
+writes an instruction to a segment
+
+seg: segment to write to
+writeAddr: byte offset in the segment
+inst: instruction to write
+isLittleEndian: if the code is little endian
+*/
+static void writeInstruction(SegmentDef* seg, uint16_t writeAddr, uint16_t inst, char isLittleEndian);
+
+/*
+determines if operands that failed to evaluate only wait on globals defined later
+local names and defines are excluded since they change before the end of the file
+
+operands: text of the operands
+varDefs: defined vars
+defines: current defines
+
+returns: if the operands can be evaluated at the end of the file
+*/
+static char canDeferOperands(char* operands, StringTable varDefs, StringTable defines);
+
+/*
+reports a segment that has grown past its size in one-pass mode
+
+seg: segment to check
+errorList: list of errors
+lineCount: current line
+handle: current file
+wordSize: addresses occupied by a 16-bit word
+
+returns: if the segment overflowed
+*/
+static char checkSegmentSize(SegmentDef* seg, List* errorList, unsigned int lineCount, FileHandle* handle, int wordSize);
+
+/*
+defines a global label or assignment in one-pass mode, assignments that use later globals are deferred
+
+handle: current file
+errorList: list of errors
+line: line starting with the name
+lineCount: current line
+activeSeg: current segment
+macroStack: stack of macro returns
+varDefs: defined vars
+defines: current defines
+deferred: assignments waiting on later globals
+deferredLut: names of the deferred assignments
+wordSize: addresses occupied by a 16-bit word
+*/
+static void defineGlobal(FileHandle* handle, List* errorList, char* line, unsigned int lineCount, SegmentDef* activeSeg, PersistentStack* macroStack, StringTable varDefs, StringTable defines, List* deferred, StringTable deferredLut, int wordSize);
+
+/*
+evaluates the deferred assignments and patches every instruction that waited on later globals
+
+errorList: list of errors
+deferred: assignments waiting on later globals, freed
+fixups: instructions to patch, freed
+varDefs: defined vars
+wordSize: addresses occupied by a 16-bit word
+isLittleEndian: if the code is little endian
+*/
+static void resolveForwardRefs(List* errorList, List* deferred, List* fixups, StringTable varDefs, int wordSize, char isLittleEndian);
+
 /*
 assembles a file into the output segment
 
@@ -24,7 +204,8 @@ macroDefs: defined macros
 varDefs: defined vars
 wordSize: addresses occupied by a 16-bit word
 isLittleEndian: if the code is little endian
+isOnePass: if globals are defined while assembling instead of by readGlobalVars
 */
-char assemble(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, int wordSize, char isLittleEndian);
+char assemble(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, int wordSize, char isLittleEndian, char isOnePass);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+/*
+counts of how the symbol tables, include and macro stacks and .if skips behaved on a run
+nothing is counted unless the --stats option turned the counts on
+
+Written by Adam Billings
+*/
+
+#ifndef AssemblerStats_h
+#define AssemblerStats_h
+
+#include <stdio.h>
+#include "DataStructures/StringTable.h"
+
+// most tables kept in the report
+#define STATS_TABLE_COUNT 16
+
+// number of macros listed in the report
+#define STATS_MACRO_TOP 20
+
+// chain lengths of the histogram, the last entry counts every longer chain
+#define STATS_CHAIN_LENGTHS 9
+
+// shape of one StringTable when it was recorded
+typedef struct TableStats {
+    const char* name;
+    unsigned long entries;
+    unsigned int usedBuckets;
+    unsigned int longestChain;
+    unsigned int chains[STATS_CHAIN_LENGTHS];
+} TableStats;
+
+// expansions of one macro in the assembly pass
+typedef struct MacroStats {
+    unsigned long calls;
+    unsigned long cached;
+} MacroStats;
+
+/*
+turns on the counts
+*/
+void enableStats();
+
+/*
+records the entries and chain lengths of a table, call before it is deleted
+
+name: name of the table in the report
+table: table to record
+*/
+void recordTableStats(const char* name, StringTable table);
+
+/*
+records the depth of the include stack after an include is entered
+
+depth: number of files being included
+*/
+void countIncludeDepth(int depth);
+
+/*
+records the depth of the macro stack after a macro call or .rept is entered
+
+depth: number of macro calls and repetitions being read
+*/
+void countMacroDepth(int depth);
+
+/*
+counts an expansion of a macro in the assembly pass
+
+name: name of the macro
+isCached: if the expansion was copied from an earlier call
+*/
+void countMacroExpansion(char* name, char isCached);
+
+/*
+counts lines passed over by a false .if condition
+
+lines: number of lines skipped
+*/
+void countSkippedLines(unsigned int lines);
+
+/*
+prints the report
+
+stream: where to print
+*/
+void printStats(FILE* stream);
+
+#endif
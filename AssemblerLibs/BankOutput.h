@@ -0,0 +1,117 @@
+/*
+verilog $readmemh, xilinx coe and intel mif output for fpga block memories
+the segment images are laid out at their addresses and split into the banks and byte lanes of the configuration
+
+Written by Adam Billings
+*/
+
+#ifndef BankOutput_h
+#define BankOutput_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include "DataStructures/List.h"
+#include "ConfigReader.h"
+
+// memory file formats
+typedef enum BankFormat {
+    BANK_READMEMH, BANK_COE, BANK_MIF
+} BankFormat;
+
+// size of the text buffered for each file before it is written
+#define BANK_BUFFER_SIZE 16384
+
+// bytes of the address space read from the segments at a time
+#define BANK_CHUNK_SIZE 4096
+
+// text waiting to be written to one bank file
+typedef struct BankFile {
+    FILE* output;
+    size_t used;
+    char text[BANK_BUFFER_SIZE];
+} BankFile;
+
+// a bank definition being written
+typedef struct BankStream {
+    const BankDef* bank;
+    uint32_t startByte;
+    uint32_t endByte;
+    int wordBytes;
+    int laneBits;
+    uint64_t word;
+    int wordUsed;
+    uint32_t wordIndex;
+    int addrDigits;
+    BankFile** files; // count * lanes files, the lanes of a bank are next to each other
+} BankStream;
+
+/*
+writes the segments as memory files, one for each bank and lane
+
+segments: list of segments
+banks: bank definitions of the configuration, one bank over the written addresses if empty
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+isLittleEndian: if the first byte of a word is the least significant
+format: memory file format
+outputName: output file name, banks add their name, bank and lane to it
+
+returns: if every file could be opened
+*/
+char writeBanks(List* segments, List* banks, int wordSize, char isLittleEndian, BankFormat format, char* outputName);
+
+/*
+writes the buffered text to the file
+
+file: file to empty
+*/
+static void flushBankFile(BankFile* file);
+
+/*
+adds the hex digits of a value
+
+file: file to add to
+val: value to add
+digits: number of digits
+*/
+static void putBankHex(BankFile* file, uint64_t val, int digits);
+
+/*
+copies a range of the address space out of the segments, where segments overlap the later one wins
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+addr: byte address to start at
+len: number of bytes
+data: output bytes, unwritten addresses read as 0
+*/
+static void readBankBytes(List* segments, int wordSize, uint32_t addr, uint32_t len, uint8_t* data);
+
+/*
+adds a complete word to the lane files of its bank
+
+stream: bank being written
+format: memory file format
+*/
+static void putBankWord(BankStream* stream, BankFormat format);
+
+/*
+opens the files of a bank definition and writes their headers
+
+stream: bank to open
+format: memory file format
+outputName: output file name
+isNamed: if the bank name is added to the file name
+
+returns: if every file could be opened
+*/
+static char openBankStream(BankStream* stream, BankFormat format, char* outputName, char isNamed);
+
+/*
+writes the footers of a bank definition and closes its files
+
+stream: bank to close
+format: memory file format
+*/
+static void closeBankStream(BankStream* stream, BankFormat format);
+
+#endif
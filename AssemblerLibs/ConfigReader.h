@@ -11,6 +11,7 @@ Written by Adam Billings
 #include "DataStructures/StringTable.h"
 #include "ExpressionEvaluation.h"
 #include "MiscAssembler.h"
+#include "SegmentImage.h"
 
 // memory access type
 typedef enum AccessType {
@@ -26,7 +27,7 @@ typedef struct SegmentDef {
     AccessType accessType;
     char fill;
     uint16_t writeAddr;
-    uint8_t* outputArr;
+    SegmentImage* image;
 } SegmentDef;
 
 // information on what has been parsed for a segment
@@ -39,9 +40,37 @@ typedef struct SegmentParseData {
     char readAlign;
 } SegmentParseData;
 
+// memory bank geometry for fpga memory files
+typedef struct BankDef {
+    char* name;
+    uint16_t startAddr;
+    uint16_t width;
+    uint32_t depth;
+    uint16_t count;
+    uint16_t lanes;
+} BankDef;
+
+// information on what has been parsed for a bank
+typedef struct BankParseData {
+    char readStart;
+    char readWidth;
+    char readDepth;
+    char readCount;
+    char readLanes;
+} BankParseData;
+
+// widest bank word in bits
+#define BANK_MAX_WIDTH 64
+
+// most bytes a bank definition can cover
+#define BANK_MAX_BYTES 0x20000
+
 // sample uninitialized segment
 extern const SegmentDef NEW_SEGMENT;
 
+// sample uninitialized bank
+extern const BankDef NEW_BANK;
+
 /*
 determines if the line ending is valid
 
@@ -105,14 +134,41 @@ returns: memory information as segments
 */
 List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigned int* curLine);
 
+/*
+read one attribute for a bank definition
+
+handle: file handle
+errorList: list of errors
+line: line to read from
+curLine: current line count
+curCol: start column
+bank: bank to update
+bankData: parse data for the bank
+nullST: null string table (avoid malloc)
+
+returns: number of chars read
+*/
+unsigned int readBankAttribute(FileHandle* handle, List* errorList, char* line, int curLine, int curCol, BankDef* bank, BankParseData* bankData, StringTable nullST);
+
+/*
+read the optional bank information
+
+handle: file handle
+errorList: list of errors
+bankList: list to add the banks to
+curLine: current line count
+*/
+void readBanks(FileHandle* handle, List* errorList, List* bankList, unsigned int* curLine);
+
 /*
 reads a configuration file
 
 handle: file handle
 errorList: list of errors
+bankList: list to add the banks to, empty if there is no BANKS block
 
 returns: configuration segment information
 */
-List* readConfigFile(FileHandle* handle, List* errorList);
+List* readConfigFile(FileHandle* handle, List* errorList, List* bankList);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+/*
+stack of immutable, reference counted frames
+copies share every frame, so a snapshot costs a pointer copy
+note: data in a shared frame should not be modified, pop it and push a new value instead
+
+Written by Adam Billings
+*/
+
+#ifndef PersistentStack_h
+#define PersistentStack_h
+
+#include <stdlib.h>
+#include <string.h>
+
+// single stack entry, shared between all stacks that reach it
+typedef struct StackFrame {
+    struct StackFrame* next;
+    unsigned int refCount;
+    size_t dataSize;
+    void* dataptr;
+} StackFrame;
+
+// view of a chain of frames
+typedef struct PersistentStack {
+    StackFrame* head;
+    int size;
+} PersistentStack;
+
+/*
+create an empty persistent stack
+
+returns: empty stack
+*/
+PersistentStack* newPersistentStack();
+
+/*
+releases a stack, freeing the frames no other stack uses
+
+stack: stack to free
+
+returns: NULL
+*/
+PersistentStack* deletePersistentStack(PersistentStack* stack);
+
+/*
+creates a stack sharing all frames of another stack
+
+stack: stack to copy
+
+returns: new stack with the same contents
+*/
+PersistentStack* copyPersistentStack(PersistentStack* stack);
+
+/*
+pushes an element to a stack
+
+stack: stack to modify
+dataptr: pointer to data
+dataSize: size of data (in bytes)
+*/
+void pushPersistentStack(PersistentStack* stack, const void* dataptr, size_t dataSize);
+
+/*
+pops an element from a stack (should be freed after use)
+
+stack: stack to pop from
+
+returns: pointer to element data, copied if the frame is shared
+*/
+void* popPersistentStack(PersistentStack* stack);
+
+/*
+peek at the top element of the stack
+
+stack: stack to peek at
+
+returns: data pointer at the top of the stack
+*/
+void* peekPersistentStack(PersistentStack* stack);
+
+#endif
@@ -17,9 +17,13 @@ Written by Adam Billings
 #include "DataStructures/Stack.h"
 #include "DataStructures/StringTable.h"
 
+// macro parameters are bound to single byte markers when a macro body is captured
+#define MACRO_SLOT_MARKER 0x80
+#define MACRO_SLOT_COUNT 127
+
 // used to determine the type of parse
 enum ParseType {
-    op, dec, hex, bin, chr, var
+    op, dec, hex, bin, chr, var, slot
 };
 
 // return type for list with error encoding
@@ -35,6 +39,15 @@ returns a variable name in a new string and updates the string pointer to after
 */
 char* extractVar(char** exprptr, int exprLen);
 
+/*
+sets the argument values that macro parameter markers resolve to
+
+args: values of the active macro's arguments, NULL outside of a macro
+argCount: number of arguments
+known: per argument, if its value is known, NULL when they all are
+*/
+void setMacroArgs(const uint16_t* args, int argCount, const char* known);
+
 /*
 Evaluates the expressed short integer expression
 
@@ -13,6 +13,8 @@ Written by Adam Billings
 #include "ExpressionEvaluation.h"
 #include "DataStructures/StringTable.h"
 #include "DataStructures/Stack.h"
+#include "DataStructures/PersistentStack.h"
+#include "SourceIndex.h"
 
 // information needed to find a macro
 typedef struct MacroDefData {
@@ -22,6 +24,8 @@ typedef struct MacroDefData {
     unsigned int line;
     unsigned int lines;
     List* vars;
+    FileHandle* body;
+    char readsArgs; // if the directives of the body read its arguments, 0 until checked, 1 for no, 2 for yes
 } MacroDefData;
 
 // information needed to track if macros
@@ -30,12 +34,27 @@ typedef struct PosData {
     unsigned int col;
 } PosData;
 
+// recorded destination of a skipped conditional block
+typedef struct IfJumpData {
+    long filePosition;
+    unsigned int lineDelta;
+    unsigned int col;
+    char atEnd;
+    char line[256];
+} IfJumpData;
+
 // information needed to track include nesting
 typedef struct IncludeReturnData {
     FileHandle* returnFile;
     long filePosition;
     unsigned int returnLine;
     unsigned int errorCount;
+    uint16_t* args; // argument values of a macro call, NULL for includes
+    int argCount;
+    char* known; // per argument, if the look ahead passes could evaluate it, NULL when they all could
+    MacroDefData* rept; // repeated block, NULL for includes and macro calls
+    unsigned int repeatsLeft;
+    List* locals; // local labels of the current iteration, NULL until the assembler reads them
 } IncludeReturnData;
 
 /*
@@ -92,8 +111,59 @@ returns: handle to open file or NULL
 */
 FileHandle* getHandle(List* handleList, char* name, char isBin);
 
+/*
+determines if a character can be in an operand name
+
+c: character to evaluate
+
+returns: if the character can be in an operand name
+*/
+static char isOperandChar(char c);
+
+/*
+replaces macro parameter names in an operand list with slot markers
+
+operands: text to rewrite in place
+length: length of the text
+params: names of the macro parameters
+*/
+static void bindParamOperands(char* operands, int length, List* params);
+
+/*
+replaces macro parameter names on one line of a macro body with slot markers
+only instruction operands, .word/.byte data, .rept counts and assignments are bound
+
+line: line to rewrite in place
+length: length of the line
+params: names of the macro parameters
+*/
+static void bindParamLine(char* line, int length, List* params);
+
+/*
+captures a macro body into an in-memory stream so invocations do not reread the source file
+
+handle: file the macro is defined in
+handleList: list of open handles, the body handle is added to it
+params: names of the macro parameters to bind to slots, NULL for none
+start: file position of the first line of the body
+end: file position after the .endmacro line
+
+returns: handle to the captured body, NULL if it could not be captured
+*/
+FileHandle* captureMacroBody(FileHandle* handle, List* handleList, List* params, long start, long end);
+
+/*
+moves reading to the first line of a macro body
+
+macroData: macro to enter
+
+returns: handle to read the body from
+*/
+FileHandle* enterMacroBody(MacroDefData* macroData);
+
 /*
 reads to the end of an if statement
+the destination is recorded on the handle so later skips of the same block jump straight to it
 
 handle: handle to the file
 errorList: list of errors
@@ -112,7 +182,7 @@ lineptr: pointer to line to update
 
 returns: pointer to handle to update
 */
-FileHandle* includeReturn(Stack* includeStack, unsigned int* lineptr);
+FileHandle* includeReturn(PersistentStack* includeStack, unsigned int* lineptr);
 
 /*
 determines if an "if" condition was met
@@ -130,6 +200,69 @@ returns: if the condition is true
 */
 char macroIf(FileHandle* handle, List* errorList, char* name, char* expr, unsigned int exprLen, int line, int col, StringTable defines);
 
+/*
+locates the body of a .rept block, capturing it the first time the block is reached
+
+handle: file positioned after the .rept line
+errorList: list of errors
+handleList: list of open handles
+line: line of the .rept
+col: column of the .rept
+argBase: number of argument slots of the enclosing macro call
+counter: name of the iteration counter, NULL for none
+
+returns: block information, NULL if there is no matching .endr
+*/
+static MacroDefData* findRept(FileHandle* handle, List* errorList, List* handleList, unsigned int line, unsigned int col, int argBase, char* counter);
+
+/*
+starts a .rept block, entering its body unless the count is 0
+
+handle: file positioned after the .rept line
+errorList: list of errors
+handleList: list of open handles
+args: text after the directive name
+lineCount: pointer to the current line, moved to the .rept line of the body
+col: column of the .rept
+macroStack: stack of macro returns, the repetition is pushed onto it
+varDefs: defined vars
+defines: current defined vars
+
+returns: handle to continue reading from
+*/
+FileHandle* startRept(FileHandle* handle, List* errorList, List* handleList, char* args, unsigned int* lineCount, unsigned int col, PersistentStack* macroStack, StringTable varDefs, StringTable defines);
+
+/*
+ends one iteration of a .rept block, rereading the body until the count runs out
+
+handle: file being read
+errorList: list of errors
+lineCount: pointer to the current line
+col: column of the .endr
+macroStack: stack of macro returns
+varDefs: defined vars, the local labels of the block are removed from it once it ends
+
+returns: handle to continue reading from
+*/
+FileHandle* endRept(FileHandle* handle, List* errorList, unsigned int* lineCount, unsigned int col, PersistentStack* macroStack, StringTable varDefs);
+
+/*
+determines if reading is at the first line of an iteration of the innermost .rept block
+
+handle: file being read
+macroStack: stack of macro returns
+
+returns: if an iteration is starting
+*/
+char isReptStart(FileHandle* handle, PersistentStack* macroStack);
+
+/*
+binds the arguments of the innermost macro call or repetition for expressions
+
+macroStack: stack of macro returns
+*/
+void restoreMacroArgs(PersistentStack* macroStack);
+
 /*
 counts the args in a macro
 
@@ -17,6 +17,7 @@ Written by Adam Billings
       Configuration files are split into two blocks: MEMORY and SEGMENTS.\n\
       The MEMORY block defines the layout of the address space used by the program.\n\
       The SEGMENTS block defines the segments used by the assembler to generat an output file.\n\
+      An optional BANKS block after SEGMENTS defines the block memories for --readmemh, --coe and --mif.\n\
 \n\
     - MEMORY Attributes -\n\
       start : start of the address range\n\
@@ -27,6 +28,14 @@ Written by Adam Billings
       load  : address range from MEMORY to load to\n\
       align : (optional) alignment in the output file\n\
       fill  : (optional, default yes) if the segment should be filled entirely\n\
+\n\
+    - BANKS Attributes -\n\
+      start : (optional, default 0) first address of the banks\n\
+      width : bits in each memory word, a multiple of 8 up to 64\n\
+      depth : words in each bank\n\
+      count : (optional, default 1) number of banks, one after another\n\
+      lanes : (optional, default 1) byte lanes each word is split into, lane 0 is the low bits\n\
+      Files are named <output>_<bank name>, then _b<bank> and _l<lane> when there are several.\n\
 \n\
     - Access Types -\n\
       ro  : read only\n\
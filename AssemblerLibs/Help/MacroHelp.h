@@ -24,12 +24,14 @@ Written by Adam Billings
       .endif                                : end .if-.elseif-.else chain\n\
       .macro <param>, <param>, ...          : define a macro (pseudoinstruction)\n\
       .endmacro                             : end macro definition\n\
+      .rept <expression>, <counter>         : repeat code <expression> times, counting from 0\n\
+      .endr                                 : end .rept block\n\
       .define <define> <expression>         : define a constant\n\
       .redef <define> <expression>          : redefine a constant\n\
       .undef <define>                       : undefine constant\n\
       .align <expression>                   : align to multiple of <expression>\n\
       .res <expression>                     : reserve <expression> addresses\n\
-      .byte <expression>, <expression>, ... : write byte(s)\n\
+      .byte <expression>, <expression>, ... : write byte(s), -128 to 255\n\
       .word <expression>, <expression>, ... : write word(s)\n\
       .ascii \"<string>\"                     : write string\n\
       .asciiz \"<string>\"                    : write zero-terminated string\n\
@@ -42,6 +44,7 @@ Written by Adam Billings
       .error \"<string>\"                     : assembler error\n\
 \n\
   Note: expressions can only referenced macro-defined values.\n\
+  Note: .rept counts can also use macro parameters and constants assigned before the block.\n\
 \n\
 "
 
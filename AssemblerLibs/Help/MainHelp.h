@@ -34,6 +34,17 @@ Written by Adam Billings
       -r, --raw                    : output raw binary\n\
       -t, --text-byte              : output hex as text bytes\n\
       -T, --text-word              : output hex as words\n\
+      --ihex                       : output intel hex of the written addresses\n\
+      --srec                       : output motorola s-records of the written addresses\n\
+      --readmemh                   : output verilog $readmemh files of the configured banks\n\
+      --coe                        : output xilinx coe files of the configured banks\n\
+      --mif                        : output intel mif files of the configured banks\n\
+      -1, --one-pass               : define globals while assembling\n\
+      --time-passes                : print the time and lines read of each pass\n\
+      --time-passes-json <file>    : write the pass times to a json file\n\
+      --perf-counters              : print cycles, instructions and misses of each pass\n\
+      --trace <file>               : write a timeline of passes, includes and macros\n\
+      --stats                      : print symbol table, stack and .if skip counts\n\
       -o <file>, --output <file>   : set output file name\n\
 \n\
     - Help Pages -\n\
@@ -10,24 +10,102 @@ Written by Adam Billings
 #include <stdio.h>
 #include <ctype.h>
 #include "DataStructures/List.h"
+#include "DataStructures/StringTable.h"
 
 // package of file read information
 typedef struct FileHandle {
     FILE* fptr;
     char* name;
     long length;
-    char isBin;
+    char isBin; // 2 for in-memory macro bodies
+    struct FileHandle* source; // file the lines were captured from, NULL for real files
+    StringTable ifJumps; // resolved .if skips keyed by start position, NULL until the first skip
+    struct SourceIndex* index; // line records, NULL until the file is first scanned
+    StringTable repts; // .rept blocks keyed by the position after the .rept line, NULL until the first block
 } FileHandle;
 
+// kind of error, the message is only formatted when the error is printed
+typedef enum ErrorCode {
+    ERR_MESSAGE,
+    ERR_TRAILING_GARBAGE,
+    ERR_LINE_SIZE,
+    ERR_NO_SEGMENT,
+    ERR_EXPECTED_IDENTIFIER,
+    ERR_EXPECTED_STRING,
+    ERR_EXPECTED_ASSIGNMENT,
+    ERR_GLOBAL_IN_MACRO,
+    ERR_DEFINE_IN_MACRO,
+    ERR_MACRO_TRACE,
+    ERR_REPT_TRACE,
+    ERR_MACRO_ARG_COUNT,
+    ERR_CANONICALIZE,
+    ERR_OPEN_FILE,
+    ERR_CIRCULAR_INCLUDE,
+    ERR_PARSE_PARAMETERS,
+    ERR_EMPTY_SEGMENT_STACK,
+    ERR_EXPECTED_ENDIF,
+    ERR_EXPECTED_ENDR,
+    ERR_EXPECTED_IF,
+    ERR_EXPECTED_MACRO,
+    ERR_EXPECTED_REPT,
+    ERR_UNDEFINED,
+    ERR_INVALID_SEGMENT,
+    ERR_INVALID_MACRO,
+    ERR_MEMORY_BLOCK,
+    ERR_SEGMENTS_BLOCK,
+    ERR_MEMORY_HEADER,
+    ERR_SEGMENTS_HEADER,
+    ERR_EXPECTED_COLON,
+    ERR_EXPECTED_EQUALS,
+    ERR_EXPECTED_ATTRIBUTE,
+    ERR_EXPECTED_LOAD,
+    ERR_EXPECTED_SIZE,
+    ERR_EXPECTED_START,
+    ERR_EXPECTED_TYPE,
+    ERR_BANKS_BLOCK,
+    ERR_BANKS_HEADER,
+    ERR_EXPECTED_WIDTH,
+    ERR_EXPECTED_DEPTH,
+    ERR_BANK_WIDTH,
+    ERR_BANK_LANES,
+    ERR_BANK_SIZE,
+    ERR_ACCESS_TYPE,
+    ERR_MEMORY_LOCATION,
+    ERR_FILL_OPTION,
+    ERR_UNKNOWN_ATTRIBUTE,
+    ERR_REDECLARATION,
+    ERR_REPEAT_ENTRY,
+    ERR_SEGMENT_SIZE,
+    ERR_RESERVE_READ_ONLY,
+    ERR_ARG_PARSE,
+    ERR_INVALID_NAME,
+    ERR_REPEAT_DEFINITION,
+    ERR_CIRCULAR_DEPENDENCY,
+    ERR_INVALID_INSTRUCTION,
+    ERR_SINGLE_ARG_RANGE,
+    ERR_BRANCH_RANGE,
+    ERR_ARG_COUNT,
+    ERR_ARG_RANGE
+} ErrorCode;
+
 // package of error information
 typedef struct ErrorData {
-    char* errorMsg;
+    char* errorMsg; // full message for ERR_MESSAGE, otherwise an owned string argument or NULL
     int line;
     int col;
     int len;
     FileHandle* handle;
+    ErrorCode code;
+    int arg;
+    const char* textArg; // string argument that outlives the error list
 } ErrorData;
 
+// error and its place in the error list, sorted to find repeats
+typedef struct ErrorOrder {
+    const ErrorData* errorData;
+    int index;
+} ErrorOrder;
+
 /*
 gets the directory a file is stored in from the canonical path
 
@@ -36,6 +114,30 @@ returns: directory
 */
 char* getDir(char* path);
 
+/*
+records an error without formatting its message
+
+errorList: list of errors
+code: kind of error
+arg: integer argument of the message
+textArg: string argument that outlives the error list, NULL if unused
+detail: owned string argument, NULL if unused
+line: line of the error
+col: column of the error
+len: length of the error
+handle: file of the error
+*/
+void appendError(List* errorList, ErrorCode code, int arg, const char* textArg, char* detail, int line, int col, int len, FileHandle* handle);
+
+/*
+formats the message of an error
+
+errorData: error to format
+
+returns: message in a new string
+*/
+char* formatError(const ErrorData* errorData);
+
 /*
 prints an error message
 
@@ -43,6 +145,33 @@ errorData: error to print
 */
 char printError(ErrorData errorData);
 
+/*
+compares everything that shows in a printed error except its place in the error list
+
+a: first error
+b: second error
+
+returns: negative, zero or positive like strcmp
+*/
+static int compareErrorData(const ErrorData* a, const ErrorData* b);
+
+/*
+orders errors by file, position, kind and arguments, ties by their place in the error list
+
+a: first ErrorOrder
+b: second ErrorOrder
+
+returns: negative, zero or positive like strcmp
+*/
+static int compareErrorOrder(const void* a, const void* b);
+
+/*
+prints all errors in the order they were reported, skipping repeats reported by rescans of the same line, and frees their messages
+
+errorList: list of errors
+*/
+void printErrors(List* errorList);
+
 /*
 determines if a character can be in a valid name
 
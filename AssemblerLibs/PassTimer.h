@@ -0,0 +1,125 @@
+/*
+wall and cpu time of each assembler pass with counts of the lines each pass reads
+a pass started inside another pass is timed on its own and paused time is not counted twice
+
+Written by Adam Billings
+*/
+
+#ifndef PassTimer_h
+#define PassTimer_h
+
+#include <stdio.h>
+#include "MiscAssembler.h"
+#include "PerfCounters.h"
+
+// passes that are timed
+typedef enum Pass {
+    PASS_CONFIG, PASS_VALIDATE, PASS_MACROS, PASS_GLOBALS, PASS_LOCALS, PASS_ASSEMBLE, PASS_OUTPUT, PASS_COUNT
+} Pass;
+
+// totals of one pass
+typedef struct PassStats {
+    double wall; // seconds
+    double cpu; // seconds
+    unsigned long calls;
+    unsigned long lines;
+    unsigned long rereadBytes;
+    double counters[PERF_COUNTER_COUNT]; // hardware counts, 0 unless the counters were started
+} PassStats;
+
+/*
+opens the hardware counters and reads them around every pass from now on
+
+returns: number of counters opened
+*/
+int startPassCounters();
+
+/*
+starts timing a pass, pausing the running pass
+
+pass: pass to start
+*/
+void startPass(Pass pass);
+
+/*
+starts timing a pass that begins at a line of a file, pausing the running pass
+
+pass: pass to start
+handle: file the pass starts in
+line: line the pass starts on
+*/
+void startPassAt(Pass pass, FileHandle* handle, unsigned int line);
+
+/*
+stops timing the running pass, resuming the pass it paused
+*/
+void endPass();
+
+/*
+counts a line read by the running pass
+*/
+void countPassLine();
+
+/*
+counts the bytes that will be read again when a file moves back
+
+fptr: file about to move
+target: file position it will move to
+*/
+void countPassRewind(FILE* fptr, long target);
+
+/*
+gets the pass being timed
+
+returns: running pass, PASS_COUNT if no pass is running
+*/
+Pass getRunningPass();
+
+/*
+gets the name of a pass
+
+pass: pass to name
+
+returns: name of the pass
+*/
+const char* getPassName(Pass pass);
+
+/*
+prints a table of the pass totals
+
+stream: where to print
+*/
+void printPassTimes(FILE* stream);
+
+/*
+writes the pass totals as a json object
+
+stream: where to write
+*/
+void writePassTimesJson(FILE* stream);
+
+/*
+prints a table of the hardware counters of each pass
+
+stream: where to print
+*/
+void printPassCounters(FILE* stream);
+
+/*
+adds the time since the running pass was started or resumed to it
+
+wall: wall time (in seconds)
+cpu: process cpu time (in seconds)
+counters: hardware counters
+*/
+static void addRunningTime(double wall, double cpu, double* counters);
+
+/*
+reads both clocks
+
+wall: wall time (in seconds)
+cpu: process cpu time (in seconds)
+*/
+static void readClocks(double* wall, double* cpu);
+
+#endif
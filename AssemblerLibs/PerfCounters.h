@@ -0,0 +1,60 @@
+/*
+hardware performance counters of the assembler process, read around each pass by the pass timer
+only available on linux through perf_event_open, counters that cannot be opened read as 0
+
+Written by Adam Billings
+*/
+
+#ifndef PerfCounters_h
+#define PerfCounters_h
+
+// counters that are read
+typedef enum PerfCounter {
+    PERF_CYCLES, PERF_INSTRUCTIONS, PERF_CACHE_MISSES, PERF_BRANCH_MISSES, PERF_COUNTER_COUNT
+} PerfCounter;
+
+/*
+opens every counter the system allows
+
+returns: number of counters opened
+*/
+int openPerfCounters();
+
+/*
+closes the open counters
+*/
+void closePerfCounters();
+
+/*
+reads every counter, scaled up when the kernel shared the hardware between counters
+
+counts: output of PERF_COUNTER_COUNT counts
+*/
+void readPerfCounters(double* counts);
+
+/*
+determines if a counter is open
+
+counter: counter to check
+
+returns: if the counter is open
+*/
+char isPerfCounterOpen(PerfCounter counter);
+
+/*
+gets the name of a counter
+
+counter: counter to name
+
+returns: name of the counter
+*/
+const char* getPerfCounterName(PerfCounter counter);
+
+/*
+gets why the first counter that failed could not be opened
+
+returns: reason, NULL if nothing failed
+*/
+const char* getPerfCounterError();
+
+#endif
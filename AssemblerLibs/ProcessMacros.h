@@ -11,6 +11,7 @@ Written by Adam Billings
 #include "GeneralMacros.h"
 #include "ExpressionEvaluation.h"
 #include "DataStructures/Stack.h"
+#include "DataStructures/PersistentStack.h"
 #include "DataStructures/StringTable.h"
 #include "ConfigReader.h"
 
@@ -34,7 +35,7 @@ macroDeleteTracker: list of the argument lists for the macros
 
 returns: handle to new "main" file
 */
-FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, Stack* includeStack, Stack* ifStack, StringTable defines, StringTable macroDefs, char* isInMacro, PosData* macroData, List* macroDeleteTracker);
+FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, PersistentStack* includeStack, PersistentStack* ifStack, StringTable defines, StringTable macroDefs, char* isInMacro, PosData* macroData, List* macroDeleteTracker);
 
 /*
 process type 2 macro
@@ -55,10 +56,39 @@ activeSeg: active segment
 segments: list of segments
 macroDefs: macro definitions
 wordSize: size of the word in addresses accessed
+vars: variable table
 
 returns: handle to new "main" file
 */
-FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, Stack* includeStack, Stack* ifStack, Stack* segStack, Stack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize);
+FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, PersistentStack* includeStack, PersistentStack* ifStack, PersistentStack* segStack, PersistentStack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize, StringTable vars);
+
+/*
+finds the first value that does not fit in a byte, signed or unsigned
+
+vals: values to check
+count: number of values
+
+returns: index of the first value out of range, -1 if every value fits
+*/
+static int findByteRangeError(const uint16_t* vals, int count);
+
+/*
+evaluates the operands of a .word or .byte directive and stores them in one pass
+
+handle: current file handle
+errorList: list of errors
+line: current line, expects the directive at the start
+afterName: operands of the directive
+lineCount: current line number
+curCol: start index for the error messages
+activeSeg: active segment
+vars: variable table
+defines: defined constant information
+wordSize: size of the word in addresses accessed
+isLittleEndian: if the code is little endian
+isByte: if the operands are bytes
+*/
+static void emitData(FileHandle* handle, List* errorList, char* line, char* afterName, unsigned int lineCount, unsigned int curCol, SegmentDef* activeSeg, StringTable vars, StringTable defines, int wordSize, char isLittleEndian, char isByte);
 
 /*
 process type 3 macro
@@ -85,6 +115,6 @@ vars: variable table
 
 returns: handle to new "main" file
 */
-FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, Stack* includeStack, Stack* ifStack, Stack* segStack, Stack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize, char isLittleEndian, List* macroVars, StringTable vars);
+FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, PersistentStack* includeStack, PersistentStack* ifStack, PersistentStack* segStack, PersistentStack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize, char isLittleEndian, List* macroVars, StringTable vars);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*
+raw binary output of the segments, laid out one after another with their alignment padding
+long runs of zeros are left as holes in regular files instead of being written
+
+Written by Adam Billings
+*/
+
+#ifndef RawOutput_h
+#define RawOutput_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include "DataStructures/List.h"
+#include "SegmentImage.h"
+
+// shortest run of zeros left as a hole, shorter runs are cheaper to write than to skip
+#define RAW_HOLE_SIZE 4096
+
+// most ranges gathered into one write
+#define RAW_IOV_COUNT 64
+
+// ranges waiting to be written
+typedef struct RawWriter {
+    int fd;
+    char isSeekable;
+    char hasFailed;
+    off_t offset; // file offset of the first waiting range
+    uint64_t zeroLen; // zeros after the waiting ranges that are not yet placed
+    int iovCount;
+    struct iovec iov[RAW_IOV_COUNT];
+} RawWriter;
+
+/*
+writes the segments as a raw binary
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+output: file to write to, nothing can have been written through it yet
+
+returns: if every byte was written
+*/
+char writeRawImage(List* segments, int wordSize, FILE* output);
+
+/*
+writes the waiting ranges at the offset of the writer
+
+writer: writer to empty
+*/
+static void flushRawWriter(RawWriter* writer);
+
+/*
+adds a range to the next write
+
+writer: writer to add to
+data: bytes to write, kept until the writer is flushed
+len: number of bytes
+*/
+static void putRawRange(RawWriter* writer, const uint8_t* data, size_t len);
+
+/*
+places the zeros waiting in the writer, long runs are skipped over to leave a hole
+
+writer: writer to update
+*/
+static void placeRawZeros(RawWriter* writer);
+
+/*
+adds the start of an image, pages of zeros are only counted
+
+writer: writer to add to
+image: image to output
+len: number of bytes to output
+*/
+static void putRawImage(RawWriter* writer, SegmentImage* image, uint32_t len);
+
+#endif
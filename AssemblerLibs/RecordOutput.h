@@ -0,0 +1,106 @@
+/*
+intel hex and motorola s-record output
+only the bytes each segment wrote are output, at the address of the segment
+
+Written by Adam Billings
+*/
+
+#ifndef RecordOutput_h
+#define RecordOutput_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include "DataStructures/List.h"
+
+// data bytes in each record
+#define RECORD_DATA_SIZE 16
+
+// size of the text buffered before it is written
+#define RECORD_BUFFER_SIZE 65536
+
+// text waiting to be written
+typedef struct RecordBuffer {
+    FILE* output;
+    size_t used;
+    uint8_t checksum;
+    char text[RECORD_BUFFER_SIZE];
+} RecordBuffer;
+
+/*
+writes the segments as intel hex
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+output: file to write to
+*/
+void writeIntelHex(List* segments, int wordSize, FILE* output);
+
+/*
+writes the segments as motorola s-records
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+output: file to write to
+*/
+void writeSRecords(List* segments, int wordSize, FILE* output);
+
+/*
+writes the buffered text to the file
+
+buffer: buffer to empty
+*/
+static void flushRecords(RecordBuffer* buffer);
+
+/*
+adds a byte as two hex digits, counting it in the checksum
+
+buffer: buffer to add to
+val: byte to add
+*/
+static void putRecordByte(RecordBuffer* buffer, uint8_t val);
+
+/*
+adds text that is not part of the checksum
+
+buffer: buffer to add to
+text: text to add
+*/
+static void putRecordText(RecordBuffer* buffer, const char* text);
+
+/*
+adds one intel hex record
+
+buffer: buffer to add to
+type: record type
+addr: lower 16 bits of the address
+data: data bytes
+len: number of data bytes
+*/
+static void putIntelRecord(RecordBuffer* buffer, uint8_t type, uint16_t addr, const uint8_t* data, int len);
+
+/*
+adds one s-record
+
+buffer: buffer to add to
+type: record type digit
+addrBytes: number of address bytes
+addr: address
+data: data bytes
+len: number of data bytes
+*/
+static void putSRecord(RecordBuffer* buffer, char type, int addrBytes, uint32_t addr, const uint8_t* data, int len);
+
+/*
+adds the data records of every written range of the segments
+
+buffer: buffer to add to
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+isSRecord: if s-records are written instead of intel hex
+addrBytes: number of address bytes of s-records
+
+returns: number of data records
+*/
+static unsigned long putDataRecords(RecordBuffer* buffer, List* segments, int wordSize, char isSRecord, int addrBytes);
+
+#endif
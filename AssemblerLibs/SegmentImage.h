@@ -0,0 +1,112 @@
+/*
+sparse output image of a segment
+pages are only allocated once something is written to them
+
+Written by Adam Billings
+*/
+
+#ifndef SegmentImage_h
+#define SegmentImage_h
+
+#include <stdio.h>
+#include <stdint.h>
+
+// bytes per lazily committed page
+#define SEGMENT_PAGE_SIZE 256
+
+// segment output split into pages, untouched pages read as 0
+typedef struct SegmentImage {
+    uint32_t size;
+    uint32_t pageCount;
+    uint8_t** pages;
+    uint64_t* pageBitmap;
+} SegmentImage;
+
+/*
+creates an empty image, no pages are committed
+
+size: size of the image (in bytes)
+
+returns: new image
+*/
+SegmentImage* newSegmentImage(uint32_t size);
+
+/*
+frees an image and all of its pages
+
+image: image to free
+
+returns: NULL
+*/
+SegmentImage* deleteSegmentImage(SegmentImage* image);
+
+/*
+checks if a page has been written to
+
+image: image to inspect
+page: page index
+
+returns: if the page is committed
+*/
+char isSegmentPageCommitted(SegmentImage* image, uint32_t page);
+
+/*
+gets the bytes of a page, untouched pages share a page of 0s
+
+image: image to read
+page: page index
+
+returns: pointer to SEGMENT_PAGE_SIZE readable bytes
+*/
+const uint8_t* readSegmentPage(SegmentImage* image, uint32_t page);
+
+/*
+reads a byte from an image
+
+image: image to read
+addr: byte address
+
+returns: the byte, 0 if never written
+*/
+uint8_t readSegmentByte(SegmentImage* image, uint32_t addr);
+
+/*
+writes a byte to an image, committing its page if needed
+
+image: image to write
+addr: byte address, ignored past the end of the image
+val: byte to write
+*/
+void writeSegmentByte(SegmentImage* image, uint32_t addr, uint8_t val);
+
+/*
+writes a run of bytes to an image, one copy per page
+
+image: image to write
+addr: byte address of the first byte
+data: bytes to write
+len: number of bytes
+*/
+void writeSegmentBytes(SegmentImage* image, uint32_t addr, const uint8_t* data, uint32_t len);
+
+/*
+sets a run of bytes to 0, only touching pages that are already committed
+
+image: image to write
+addr: byte address of the first byte
+len: number of bytes
+*/
+void clearSegmentBytes(SegmentImage* image, uint32_t addr, uint32_t len);
+
+/*
+writes the start of an image to a binary file, untouched pages are written from a shared page of 0s
+
+image: image to output
+len: number of bytes to write
+output: file to write to
+
+returns: number of bytes written
+*/
+size_t writeSegmentImage(SegmentImage* image, uint32_t len, FILE* output);
+
+#endif
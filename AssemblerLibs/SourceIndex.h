@@ -0,0 +1,104 @@
+/*
+line records of a source file, read once and shared by every pass
+lines are split the same way fgets splits them into a 256 byte buffer
+
+Written by Adam Billings
+*/
+
+#ifndef SourceIndex_h
+#define SourceIndex_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include "MiscAssembler.h"
+
+// size of the line buffer used by every pass
+#define SOURCE_LINE_BUFFER 256
+
+// what a line starts with
+enum LineKind {
+    LINE_EMPTY, LINE_LABEL, LINE_DIRECTIVE, LINE_STATEMENT
+};
+
+// directives the scanners look for, any other directive is DIR_OTHER
+enum DirectiveId {
+    DIR_NONE, DIR_OTHER, DIR_IF, DIR_IFDEF, DIR_IFNDEF, DIR_ELSE, DIR_ELSEIF, DIR_ELSEIFDEF, DIR_ELSEIFNDEF, DIR_ENDIF, DIR_MACRO, DIR_ENDMACRO, DIR_REPT, DIR_ENDR, DIR_DEFINE, DIR_REDEF, DIR_UNDEF
+};
+
+// one line as a pass reads it
+typedef struct SourceLine {
+    long offset;
+    uint8_t length;
+    uint8_t indent;
+    uint8_t kind;
+    uint8_t directive;
+} SourceLine;
+
+// every line of a file in order
+typedef struct SourceIndex {
+    unsigned int count;
+    SourceLine* lines;
+    unsigned int cursor; // line after the last one read with getSourceLine
+    SourceLine scratch; // line read from a position no record starts at
+} SourceIndex;
+
+/*
+gets the line records of a file, reading the file the first time
+
+handle: file to index
+
+returns: line records of the file
+*/
+SourceIndex* getSourceIndex(FileHandle* handle);
+
+/*
+frees the line records of a file
+
+index: records to free
+
+returns: NULL
+*/
+SourceIndex* deleteSourceIndex(SourceIndex* index);
+
+/*
+finds the first line starting at or after a file position
+
+index: line records
+offset: file position
+
+returns: index of the line, count of lines if the position is at the end
+*/
+unsigned int findSourceLine(SourceIndex* index, long offset);
+
+/*
+gets the record of a line a pass has just read, lines read in order are found without a search
+
+handle: file the line was read from
+offset: file position the line was read at
+line: text of the line, only classified when no record starts at the position
+
+returns: record of the line
+*/
+SourceLine* getSourceLine(FileHandle* handle, long offset, char* line);
+
+/*
+maps a directive name to its id
+
+name: directive name including the '.'
+length: length of the name
+
+returns: id of the directive
+*/
+static enum DirectiveId internDirective(char* name, int length);
+
+/*
+classifies a line read by fgets
+
+sourceLine: record to fill
+line: text of the line
+offset: file position of the line
+length: bytes read for the line
+*/
+static void indexLine(SourceLine* sourceLine, char* line, long offset, long length);
+
+#endif
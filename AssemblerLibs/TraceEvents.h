@@ -0,0 +1,80 @@
+/*
+timeline of the passes, included files, macro expansions and local label reads in the chrome trace event format
+the file can be opened in chrome://tracing or ui.perfetto.dev
+
+Written by Adam Billings
+*/
+
+#ifndef TraceEvents_h
+#define TraceEvents_h
+
+#include <stdio.h>
+#include "MiscAssembler.h"
+
+// deepest nesting of passes that is traced
+#define TRACE_PASS_STACK_SIZE 16
+
+/*
+starts writing trace events to a file
+
+fileName: file to write
+
+returns: if the file was opened
+*/
+char openTraceEvents(char* fileName);
+
+/*
+finishes the trace file, closing any event still open
+*/
+void closeTraceEvents();
+
+/*
+starts an event, does nothing when no trace file is open
+
+name: name of the event
+category: kind of event
+handle: file the event starts in, NULL for none
+line: line the event starts on
+*/
+void beginTraceEvent(const char* name, const char* category, FileHandle* handle, unsigned int line);
+
+/*
+ends the innermost event, events started before the running pass are left open
+*/
+void endTraceEvent();
+
+/*
+starts the event of a pass, the pass closes every event started inside of it when it ends
+
+name: name of the pass
+handle: file the pass starts in, NULL for none
+line: line the pass starts on
+*/
+void beginTracePass(const char* name, FileHandle* handle, unsigned int line);
+
+/*
+ends the event of the running pass and the events still open inside of it
+*/
+void endTracePass();
+
+/*
+writes a string with json escapes
+
+stream: where to write
+str: string to write
+*/
+static void writeJsonString(FILE* stream, const char* str);
+
+/*
+gets the time since the trace was opened
+
+returns: time (in microseconds)
+*/
+static double getTraceTime();
+
+/*
+writes the end of the innermost event
+*/
+static void writeEventEnd();
+
+#endif
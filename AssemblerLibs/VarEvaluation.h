@@ -14,6 +14,13 @@ Written by Adam Billings
 #include "ConfigReader.h"
 #include "ProcessMacros.h"
 #include <stdio.h>
+#include <pthread.h>
+
+// smallest level worth handing to the worker pool
+#define EVAL_PARALLEL_MIN 256
+
+// most threads used to evaluate a level, including the calling thread
+#define EVAL_MAX_THREADS 8
 
 // stores data to evaluate a variable
 typedef struct VarEvalData {
@@ -24,6 +31,7 @@ typedef struct VarEvalData {
     int line;
     int col;
     FileHandle* handle;
+    int index;
 } VarEvalData;
 
 // stores define data
@@ -34,6 +42,40 @@ typedef struct DefData {
     char hasValue;
 } DefData;
 
+// evaluation state of an assignment
+typedef enum VarStatus {VAR_PENDING, VAR_DONE, VAR_FAILED, VAR_SKIPPED, VAR_CYCLE} VarStatus;
+
+// dependency graph of the pending assignments
+typedef struct EvalGraph {
+    int count;
+    char** names;
+    VarEvalData** nodes;
+    int* edgeStart;
+    int* edges;
+    int* component;
+    int componentCount;
+    int* finishOrder;
+    int* levelNodes;
+    char* status;
+    ExprErrorShort* results;
+    StringTable varDefs;
+} EvalGraph;
+
+// worker threads evaluating one level of an EvalGraph at a time
+typedef struct EvalPool {
+    EvalGraph* graph;
+    pthread_t* threads;
+    int threadCount;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    int generation;
+    int active;
+    int next;
+    int end;
+    char stop;
+} EvalPool;
+
 /*
 enumerates the variables in an expression
 
@@ -45,15 +87,117 @@ returns: list of variables in the expression
 static List* getVars(char* expr, int exprLen);
 
 /*
-evaluates a variable assignment
+moves the dependencies captured by a define out of a dependency list
+
+dependencies: list of names in the expression
+defines: defines active at the assignment
+
+returns: list of captured define values
+*/
+static List* captureDefines(List* dependencies, StringTable defines);
+
+/*
+evaluates a single variable assignment whose dependencies are on earlier levels
+
+graph: assignment graph being evaluated
+v: index of the variable
+scratch: empty table to hold the captured defines, owned by the caller
+*/
+static void evaluateVar(EvalGraph* graph, int v, StringTable scratch);
+
+/*
+evaluation thread, takes variables from the current level until the pool stops
+
+arg: pool to work for
+
+returns: NULL
+*/
+static void* evalWorker(void* arg);
+
+/*
+evaluates one level of the graph, spreading it over the pool when it is large enough
 
-toEvaluate: name to resolve
-toEvaluateLut: LUT to get other vars to evaluate
-parse: output parse information
+graph: assignment graph being evaluated
+pool: worker pool, started on first use
+start: first index of the level in levelNodes
+end: index after the level in levelNodes
+scratch: scratch define table for the calling thread
+*/
+static void evaluateLevel(EvalGraph* graph, EvalPool* pool, int start, int end, StringTable scratch);
+
+/*
+reports a dependency cycle through a variable
+
+errorList: list of errors
+graph: assignment graph being evaluated
+root: index of the variable to start the cycle at
+*/
+static void reportCycle(List* errorList, EvalGraph* graph, int root);
+
+/*
+finds the strongly connected components of the graph with an iterative Tarjan search
+
+graph: assignment graph to search
+*/
+static void findComponents(EvalGraph* graph);
+
+/*
+evaluates all pending variable assignments in dependency order
+
+errorList: list of errors
+toEvaluate: names of the assignments in source order
+toEvaluateLut: LUT of the assignments, emptied of owned data on return
+varDefs: defined vars
 
 returns: if an error occured
 */
-static char evaluateVar(List* errorList, char* toEvaluate, StringTable toEvaluateLut, StringTable varDefs, StringTable macroDefs, List* visited);
+static char evaluateVars(List* errorList, List* toEvaluate, StringTable toEvaluateLut, StringTable varDefs);
+
+/*
+evaluates an assignment whose names are all already defined
+
+name: name of the var, freed if it is defined
+nameLength: length of the name
+expr: expression of the assignment
+exprLen: length of the expression
+dependencies: names in the expression, freed if the var is defined
+defs: defines captured at the assignment, freed if the var is defined
+varDefs: defined vars
+defines: current defined vars
+
+returns: if the var was defined
+*/
+static char evalKnownVar(char* name, int nameLength, char* expr, int exprLen, List* dependencies, List* defs, StringTable varDefs, StringTable defines);
+
+/*
+determines if the directives of a macro body read its arguments, through a .rept count or a call to a macro that does
+
+macroData: macro to check, the answer is kept in it
+macroDefs: macro definitions
+
+returns: if the arguments have to be evaluated before assembling
+*/
+static char macroReadsArgs(MacroDefData* macroData, StringTable macroDefs);
+
+/*
+evaluates the arguments of a macro call for the directives of its body
+
+args: text after the macro name
+argCount: number of parameters of the macro
+varDefs: defined vars
+defines: current defined vars
+known: output per argument if it could be evaluated, NULL when they all could
+
+returns: argument values
+*/
+static uint16_t* evalMacroCallArgs(char* args, int argCount, StringTable varDefs, StringTable defines, char** known);
+
+/*
+defines the register names as vars
+
+varDefs: table to add the registers to
+*/
+void addRegisterVars(StringTable varDefs);
 
 /*
 evaluates all local variables between global vars
@@ -85,6 +229,6 @@ macroStack_ macroStack to copy
 
 returns: parsed global vars
 */
-char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, StringTable defines, int instructionSize, List* localVars, SegmentDef* activeSeg, unsigned int lineCount, Stack* includeStack_, Stack* ifStack_, Stack* segStack_, Stack* macroStack_);
+char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, StringTable defines, int instructionSize, List* localVars, SegmentDef* activeSeg, unsigned int lineCount, PersistentStack* includeStack_, PersistentStack* ifStack_, PersistentStack* segStack_, PersistentStack* macroStack_);
 
 #endif
\ No newline at end of file
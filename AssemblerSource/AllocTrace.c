@@ -0,0 +1,212 @@
+/*
+allocation counters for the instrumented build
+every malloc, calloc, realloc and free is counted against its call site and the running pass
+only active when built with "make instrumented", which includes this file first in every file
+
+Written by Adam Billings
+*/
+
+#include "AllocTrace.h"
+
+#ifdef ALLOC_TRACE
+
+#include <stdint.h>
+#include <pthread.h>
+#include "PassTimer.h"
+
+// the counters use the real allocator
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+// slots in the call site table, larger than the number of allocations in the source
+#define ALLOC_SITE_SLOTS 2048
+
+// size of the block kept before every counted allocation, keeps the alignment of malloc
+#define ALLOC_HEADER_SIZE 16
+
+// counts of every call site
+static AllocSite allocSites[ALLOC_SITE_SLOTS];
+static int allocSiteCount = 0;
+
+// counts of every pass, the last entry is outside of any pass
+static unsigned long passCounts[PASS_COUNT + 1];
+static unsigned long passBytes[PASS_COUNT + 1];
+
+// totals
+static unsigned long totalCount = 0;
+static unsigned long totalBytes = 0;
+static unsigned long freeCount = 0;
+static size_t liveBytes = 0;
+static size_t peakBytes = 0;
+
+// variable evaluation allocates from worker threads
+static pthread_mutex_t allocLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+finds or adds the counts of a call site
+
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: counts of the call site
+*/
+static AllocSite* getAllocSite(const char* file, int line, const char* func) {
+    unsigned int slot = ((uintptr_t)file * 31 + line) % ALLOC_SITE_SLOTS;
+    while (allocSites[slot].file != NULL) {
+        if (allocSites[slot].file == file && allocSites[slot].line == line) {return allocSites + slot;}
+        slot = (slot + 1) % ALLOC_SITE_SLOTS;
+    }
+    allocSites[slot].file = file;
+    allocSites[slot].line = line;
+    allocSites[slot].func = func;
+    allocSiteCount++;
+    return allocSites + slot;
+}
+
+/*
+records a new block
+
+size: size of the block
+file: file of the call
+line: line of the call
+func: function of the call
+*/
+static void countAlloc(size_t size, const char* file, int line, const char* func) {
+    AllocSite* site = getAllocSite(file, line, func);
+    site->count++;
+    site->bytes += size;
+    Pass pass = getRunningPass();
+    passCounts[pass]++;
+    passBytes[pass] += size;
+    totalCount++;
+    totalBytes += size;
+    liveBytes += size;
+    if (liveBytes > peakBytes) {peakBytes = liveBytes;}
+}
+
+/*
+counted malloc
+
+size: bytes to allocate
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: new block
+*/
+void* traceMalloc(size_t size, const char* file, int line, const char* func) {
+    uint8_t* block = (uint8_t*)malloc(size + ALLOC_HEADER_SIZE);
+    if (block == NULL) {return NULL;}
+    *(size_t*)block = size;
+    pthread_mutex_lock(&allocLock);
+    countAlloc(size, file, line, func);
+    pthread_mutex_unlock(&allocLock);
+    return block + ALLOC_HEADER_SIZE;
+}
+
+/*
+counted calloc
+
+count: number of elements
+size: size of an element
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: new zeroed block
+*/
+void* traceCalloc(size_t count, size_t size, const char* file, int line, const char* func) {
+    uint8_t* block = (uint8_t*)traceMalloc(count * size, file, line, func);
+    if (block != NULL) {memset(block, 0, count * size);}
+    return block;
+}
+
+/*
+counted realloc
+
+ptr: block to resize, may be NULL
+size: new size of the block
+file: file of the call
+line: line of the call
+func: function of the call
+
+returns: resized block
+*/
+void* traceRealloc(void* ptr, size_t size, const char* file, int line, const char* func) {
+    if (ptr == NULL) {return traceMalloc(size, file, line, func);}
+    uint8_t* block = (uint8_t*)ptr - ALLOC_HEADER_SIZE;
+    size_t oldSize = *(size_t*)block;
+    block = (uint8_t*)realloc(block, size + ALLOC_HEADER_SIZE);
+    if (block == NULL) {return NULL;}
+    *(size_t*)block = size;
+
+    // a resize counts as freeing the old block and allocating the new one
+    pthread_mutex_lock(&allocLock);
+    liveBytes -= oldSize;
+    freeCount++;
+    countAlloc(size, file, line, func);
+    pthread_mutex_unlock(&allocLock);
+    return block + ALLOC_HEADER_SIZE;
+}
+
+/*
+counted free
+
+ptr: block to free, may be NULL
+*/
+void traceFree(void* ptr) {
+    if (ptr == NULL) {return;}
+    uint8_t* block = (uint8_t*)ptr - ALLOC_HEADER_SIZE;
+    pthread_mutex_lock(&allocLock);
+    liveBytes -= *(size_t*)block;
+    freeCount++;
+    pthread_mutex_unlock(&allocLock);
+    free(block);
+}
+
+/*
+prints the allocation report, registered to run at exit
+*/
+void printAllocTrace() {
+    fprintf(stderr, "  -- Allocations --\n");
+    fprintf(stderr, "    allocations: %lu (%lu bytes)\n", totalCount, totalBytes);
+    fprintf(stderr, "    frees: %lu\n", freeCount);
+    fprintf(stderr, "    peak live bytes: %zu\n", peakBytes);
+    fprintf(stderr, "    live bytes at exit: %zu\n\n", liveBytes);
+
+    // by pass
+    fprintf(stderr, "    %-16s %12s %14s\n", "pass", "allocations", "bytes");
+    for (int i = 0; i <= PASS_COUNT; i++) {
+        fprintf(stderr, "    %-16s %12lu %14lu\n", (i == PASS_COUNT) ? "(none)" : getPassName((Pass)i), passCounts[i], passBytes[i]);
+    }
+    fprintf(stderr, "\n");
+
+    // gather the call sites
+    AllocSite* sites = (AllocSite*)malloc((allocSiteCount + 1) * sizeof(AllocSite));
+    int siteCount = 0;
+    for (int i = 0; i < ALLOC_SITE_SLOTS; i++) {
+        if (allocSites[i].file != NULL) {sites[siteCount++] = allocSites[i];}
+    }
+
+    // print the call sites with the most bytes
+    int top = (siteCount < ALLOC_TRACE_TOP) ? siteCount : ALLOC_TRACE_TOP;
+    fprintf(stderr, "    top %d call sites by bytes\n", top);
+    fprintf(stderr, "    %12s %14s  %s\n", "allocations", "bytes", "site");
+    for (int i = 0; i < top; i++) {
+        int best = i;
+        for (int j = i + 1; j < siteCount; j++) {
+            if (sites[j].bytes > sites[best].bytes) {best = j;}
+        }
+        AllocSite swap = sites[i];
+        sites[i] = sites[best];
+        sites[best] = swap;
+        fprintf(stderr, "    %12lu %14lu  %s (%s:%d)\n", sites[i].count, sites[i].bytes, sites[i].func, sites[i].file, sites[i].line);
+    }
+    fprintf(stderr, "\n");
+    free(sites);
+}
+
+#endif
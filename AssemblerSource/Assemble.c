@@ -8,8 +8,494 @@ Written by Adam Billings
 #include "VarEvaluation.h"
 #include "ExpressionEvaluation.h"
 #include "CodeGeneration.h"
+#include "PassTimer.h"
+#include "TraceEvents.h"
+#include "AssemblerStats.h"
 #include "Assemble.h"
 
+/*
+saves the write address of every segment before a look ahead
+
+segArr: dense array of the segments
+segCount: number of segments
+saved: output write addresses, one per segment
+wordSize: addresses occupied by a 16-bit word
+*/
+static void checkpointSegments(SegmentDef** segArr, int segCount, uint16_t* saved, int wordSize) {
+    for (int i = 0; i < segCount; i++) {
+        saved[i] = segArr[i]->writeAddr;
+        if (wordSize == 1) {segArr[i]->writeAddr /= 2;}
+    }
+}
+
+/*
+restores the write address of every segment after a look ahead
+
+segArr: dense array of the segments
+segCount: number of segments
+saved: write addresses from checkpointSegments
+*/
+static void restoreSegments(SegmentDef** segArr, int segCount, const uint16_t* saved) {
+    for (int i = 0; i < segCount; i++) {
+        segArr[i]->writeAddr = saved[i];
+    }
+}
+
+/*
+extracts the next name from operand text, skipping numbers and character literals
+
+cursor: position to scan from, moved past the name
+
+returns: the name in a new string, NULL at the end of the operands
+*/
+static char* nextOperandName(char** cursor) {
+    for (char* c = *cursor; *c != '\0' && *c != ';'; c++) {
+        if (*c == '\'') {
+            c++;
+            if (*c == '\\') {c++;}
+            if (*c == '\0') {break;}
+            c++;
+            if (*c == '\0') {break;}
+        } else if (*c == '$' || *c == '%' || (*c >= '0' && *c <= '9')) {
+            while (isalnum(c[1])) {c++;}
+        } else if (isalpha(*c) || *c == '_' || *c == '@') {
+            char* varName = extractVar(&c, strlen(c));
+            *cursor = c;
+            return varName;
+        }
+    }
+    return NULL;
+}
+
+/*
+determines if every expansion of a macro with the same arguments assembles to the same bytes
+the body may only hold non-branch instructions and .word data without labels, local names or defines
+
+macroData: macro to check
+name: name of the macro
+purity: results of earlier checks by macro name
+instTable: instruction lookup table
+varDefs: defined vars, operands may only name these since defines can change between calls
+
+returns: if the expansion can be cached
+*/
+static char isPureMacro(MacroDefData* macroData, char* name, StringTable purity, StringTable instTable, StringTable varDefs) {
+    char* known = (char*)readStringTable(purity, name, strlen(name) + 1);
+    if (known != NULL) {return *known;}
+
+    // scan the captured body
+    char isPure = (macroData->body != NULL);
+    if (isPure) {
+        char buffer[256];
+        FILE* body = macroData->body->fptr;
+        long restorePoint = ftell(body);
+        rewind(body);
+        while (isPure && fgets(buffer, 256, body) != NULL) {
+            // labels and local names depend on the position
+            if (!isspace(buffer[0]) && buffer[0] != '.' && buffer[0] != ';') {isPure = 0;}
+            for (int i = 0; buffer[i] != '\0' && buffer[i] != ';'; i++) {
+                if (buffer[i] == '@') {isPure = 0;}
+            }
+
+            // only allow data and instructions that do not branch
+            int i = countWhitespaceChars(buffer, 256);
+            if (!isPure || isValidLineEnding(buffer + i, 256 - i)) {continue;}
+            char* afterName = buffer + i;
+            if (buffer[i] == '.') {
+                char* directive = extractMacro(buffer + i, 256 - i, &afterName);
+                char isEnd = !strcmp(directive, ".endmacro");
+                if (!isEnd && strcmp(directive, ".word")) {isPure = 0;}
+                free(directive);
+                if (isEnd) {break;}
+            } else {
+                char* mnemonic = extractVar(&afterName, 256 - i);
+                InstData* instData = (InstData*)readStringTable(instTable, mnemonic, strlen(mnemonic) + 1);
+                if (instData == NULL || instData->type == brc) {isPure = 0;}
+                free(mnemonic);
+            }
+
+            // operands may only name fixed vars
+            char* cursor = afterName;
+            char* varName;
+            while (isPure && (varName = nextOperandName(&cursor)) != NULL) {
+                if (readStringTable(varDefs, varName, strlen(varName) + 1) == NULL) {isPure = 0;}
+                free(varName);
+            }
+        }
+        clearerr(body);
+        fseek(body, restorePoint, SEEK_SET);
+    }
+
+    setStringTableValue(purity, name, strlen(name) + 1, &isPure, sizeof(char));
+    return isPure;
+}
+
+/*
+stores the bytes of every recorded expansion whose macro call has returned
+
+recordings: stack of expansions being recorded
+expansions: cached expansions by macro name and argument values
+macroStack: stack of macro returns
+errorList: list of errors
+activeSeg: current segment
+*/
+static void finishExpansions(Stack* recordings, StringTable expansions, PersistentStack* macroStack, List* errorList, SegmentDef* activeSeg) {
+    while (recordings->size > 0) {
+        ExpansionRecord* record = (ExpansionRecord*)peekStack(recordings);
+        if (macroStack->size >= record->depth) {break;}
+
+        // only keep clean expansions in the segment they started in
+        if (errorList->size == record->errorCount && activeSeg == record->seg && activeSeg->writeAddr >= record->start) {
+            uint16_t length = activeSeg->writeAddr - record->start;
+            uint8_t* expansion = (uint8_t*)malloc((length + sizeof(uint16_t)) * sizeof(uint8_t));
+            memcpy(expansion, &length, sizeof(uint16_t));
+            for (int i = 0; i < length; i++) {
+                expansion[sizeof(uint16_t) + i] = readSegmentByte(activeSeg->image, record->start + i);
+            }
+            setStringTableValue(expansions, record->key, strlen(record->key) + 1, expansion, length + sizeof(uint16_t));
+            free(expansion);
+        }
+
+        record = (ExpansionRecord*)popStack(recordings);
+        free(record->key);
+        free(record);
+    }
+}
+
+/*
+evaluates the operands of an instruction
+
+operands: text after the mnemonic
+varDefs: defined vars
+defines: current defines
+argEvals: output list of operand values
+
+returns: the first evaluation error in a new string, NULL if every operand evaluated
+*/
+static char* evalOperands(char* operands, StringTable varDefs, StringTable defines, List* argEvals) {
+    char* errorMessage1 = NULL;
+    List* args = extractArgs(operands, strlen(operands));
+    for (Node* node = args->head; node != NULL; node = node->next) {
+        char* expr = *(char**)(node->dataptr);
+        ExprErrorShort exprOut = evalShortExpr(expr, strlen(expr), varDefs, defines);
+        if (exprOut.errorMessage == NULL) {
+            appendList(argEvals, &(exprOut.val), 2);
+        } else if (args->size >= 1 && !isValidLineEnding(expr, strlen(expr) + 1)) {
+            if (errorMessage1 == NULL) {
+                errorMessage1 = (char*)malloc((strlen(exprOut.errorMessage) + 1) * sizeof(char));
+                strcpy(errorMessage1, exprOut.errorMessage);
+            }
+            free(exprOut.errorMessage);
+        }
+        free(expr);
+    }
+    deleteList(args);
+    return errorMessage1;
+}
+
+/*
+encodes an instruction from its evaluated operands, range errors cover the whole operand text
+
+instData: instruction to encode
+argEvals: operand values
+curAddr: address of the instruction
+wordSize: addresses occupied by a 16-bit word
+inst: output instruction
+errorList: list of errors
+line: line of the instruction
+col: column of the operands
+len: length of the operands
+handle: file of the instruction
+
+returns: if the instruction was encoded
+*/
+static char encodeInstruction(InstData* instData, List* argEvals, uint16_t curAddr, int wordSize, uint16_t* inst, List* errorList, unsigned int line, unsigned int col, unsigned int len, FileHandle* handle) {
+    // make sure that the arg count is correct
+    if (argEvals->size != instData->argCount) {
+        appendError(errorList, ERR_ARG_COUNT, instData->argCount, NULL, NULL, line, col, len, handle);
+        return 0;
+    }
+
+    // get args
+    uint16_t args[2] = {0, 0};
+    int argIndex = 0;
+    for (Node* node = argEvals->head; node != NULL; node = node->next) {
+        args[argIndex++] = *(uint16_t*)(node->dataptr);
+    }
+    if (instData->type == brc) {args[0] = args[0] - curAddr - wordSize;}
+
+    // error on size
+    char hasError = 0;
+    for (int i = 0; i < instData->argCount; i++) {
+        const OperandField* field = instData->args + i;
+        if (isOperandInRange(field, args[i])) {continue;}
+        hasError = 1;
+        ErrorCode code = (instData->type == brc) ? ERR_BRANCH_RANGE : ((instData->argCount == 1) ? ERR_SINGLE_ARG_RANGE : ERR_ARG_RANGE);
+        appendError(errorList, code, i + 1, field->range, NULL, line, col, len, handle);
+    }
+    if (hasError) {return 0;}
+
+    // generate the instruction
+    *inst = encodeFields(instData, args);
+    return 1;
+}
+
+/*
+writes an instruction to a segment
+
+seg: segment to write to
+writeAddr: byte offset in the segment
+inst: instruction to write
+isLittleEndian: if the code is little endian
+*/
+static void writeInstruction(SegmentDef* seg, uint16_t writeAddr, uint16_t inst, char isLittleEndian) {
+    uint8_t upperByte = (uint8_t)(inst >> 8);
+    uint8_t lowerByte = (uint8_t)(inst & 0x00ff);
+    if (isLittleEndian) {
+        writeSegmentByte(seg->image, writeAddr, lowerByte);
+        writeSegmentByte(seg->image, writeAddr + 1, upperByte);
+    } else {
+        writeSegmentByte(seg->image, writeAddr, upperByte);
+        writeSegmentByte(seg->image, writeAddr + 1, lowerByte);
+    }
+}
+
+/*
+determines if operands that failed to evaluate only wait on globals defined later
+local names and defines are excluded since they change before the end of the file
+
+operands: text of the operands
+varDefs: defined vars
+defines: current defines
+
+returns: if the operands can be evaluated at the end of the file
+*/
+static char canDeferOperands(char* operands, StringTable varDefs, StringTable defines) {
+    char isForward = 0;
+    char* cursor = operands;
+    char* varName;
+    while ((varName = nextOperandName(&cursor)) != NULL) {
+        int nameLength = strlen(varName);
+        if (varName[0] == '@' || readStringTable(defines, varName, nameLength + 1) != NULL) {
+            free(varName);
+            return 0;
+        }
+        if (readStringTable(varDefs, varName, nameLength + 1) == NULL) {isForward = 1;}
+        free(varName);
+    }
+    return isForward;
+}
+
+/*
+reports a segment that has grown past its size in one-pass mode
+
+seg: segment to check
+errorList: list of errors
+lineCount: current line
+handle: current file
+wordSize: addresses occupied by a 16-bit word
+
+returns: if the segment overflowed
+*/
+static char checkSegmentSize(SegmentDef* seg, List* errorList, unsigned int lineCount, FileHandle* handle, int wordSize) {
+    if (seg == NULL || seg->writeAddr <= seg->size * (wordSize == 1 ? 2 : 1)) {return 0;}
+    appendError(errorList, ERR_SEGMENT_SIZE, 0, seg->name, NULL, lineCount, 0, 1, handle);
+    return 1;
+}
+
+/*
+defines a global label or assignment in one-pass mode, assignments that use later globals are deferred
+
+handle: current file
+errorList: list of errors
+line: line starting with the name
+lineCount: current line
+activeSeg: current segment
+macroStack: stack of macro returns
+varDefs: defined vars
+defines: current defines
+deferred: assignments waiting on later globals
+deferredLut: names of the deferred assignments
+wordSize: addresses occupied by a 16-bit word
+*/
+static void defineGlobal(FileHandle* handle, List* errorList, char* line, unsigned int lineCount, SegmentDef* activeSeg, PersistentStack* macroStack, StringTable varDefs, StringTable defines, List* deferred, StringTable deferredLut, int wordSize) {
+    // error on the start of the line
+    if (!isValidNameChar(line[0]) || (line[0] >= '0' && line[0] <= '9')) {
+        int i;
+        for (i = 0; i < 256; i++) {
+            if (isspace(line[i]) || line[i] == '\0' || line[i] == ';') {break;}
+        }
+        char* name = (char*)malloc((i + 1) * sizeof(char));
+        strncpy(name, line, i);
+        name[i] = '\0';
+        appendError(errorList, ERR_INVALID_NAME, 0, NULL, name, lineCount, 0, i, handle);
+        return;
+    }
+
+    // read the var name
+    char* endOfVar;
+    char* name = getVarName(line, 256, &endOfVar);
+    int nameLength = (endOfVar - line);
+
+    // no definitions in a macro
+    if (macroStack->size > 0) {
+        // prevent a stack trace
+        for (StackFrame* node = macroStack->head; node != NULL; node = node->next) {
+            IncludeReturnData* retData = (IncludeReturnData*)(node->dataptr);
+            (retData->errorCount)++;
+        }
+
+        appendError(errorList, ERR_GLOBAL_IN_MACRO, 0, NULL, NULL, lineCount, 0, nameLength, handle);
+        free(name);
+        return;
+    }
+
+    // prevent repeat definitions
+    if (readStringTable(varDefs, name, nameLength + 1) != NULL || readStringTable(deferredLut, name, nameLength + 1) != NULL) {
+        appendError(errorList, ERR_REPEAT_DEFINITION, 0, NULL, name, lineCount, 0, nameLength, handle);
+        return;
+    }
+
+    // handle label
+    if (endOfVar[0] == ':') {
+        if (activeSeg == NULL) {
+            appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, lineCount, (endOfVar - line), 1, handle);
+        } else {
+            uint16_t writeVal = (activeSeg->writeAddr / (wordSize == 1 ? 2 : 1)) + activeSeg->startAddr;
+            setStringTableValue(varDefs, name, nameLength + 1, &writeVal, 2);
+        }
+        free(name);
+        return;
+    }
+
+    // error if no assignment
+    endOfVar += countWhitespaceChars(endOfVar, strlen(endOfVar));
+    if (endOfVar[0] != '=') {
+        appendError(errorList, ERR_EXPECTED_ASSIGNMENT, 0, NULL, NULL, lineCount, (endOfVar - line), nameLength, handle);
+        free(name);
+        return;
+    }
+
+    // evaluate now or once the later globals are known
+    char* expr = endOfVar + 1;
+    ExprErrorShort exprOut = evalShortExpr(expr, strlen(expr), varDefs, defines);
+    if (exprOut.errorMessage == NULL) {
+        setStringTableValue(varDefs, name, nameLength + 1, &(exprOut.val), 2);
+        free(name);
+    } else if (canDeferOperands(expr, varDefs, defines)) {
+        free(exprOut.errorMessage);
+        char isDeferred = 1;
+        setStringTableValue(deferredLut, name, nameLength + 1, &isDeferred, sizeof(char));
+        DeferredVar var = {name, (char*)memcpy(malloc(strlen(expr) + 1), expr, strlen(expr) + 1), lineCount, (expr - line), handle};
+        appendList(deferred, &var, sizeof(DeferredVar));
+    } else {
+        appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, lineCount, exprOut.errorPos + (expr - line), exprOut.errorLen, handle);
+        free(name);
+    }
+}
+
+/*
+evaluates the deferred assignments and patches every instruction that waited on later globals
+
+errorList: list of errors
+deferred: assignments waiting on later globals, freed
+fixups: instructions to patch, freed
+varDefs: defined vars
+wordSize: addresses occupied by a 16-bit word
+isLittleEndian: if the code is little endian
+*/
+static void resolveForwardRefs(List* errorList, List* deferred, List* fixups, StringTable varDefs, int wordSize, char isLittleEndian) {
+    // index the assignments by name
+    int varCount = deferred->size;
+    DeferredVar** vars = (DeferredVar**)malloc(varCount * sizeof(DeferredVar*));
+    StringTable varIndex = newStringTable();
+    int index = 0;
+    for (Node* node = deferred->head; node != NULL; node = node->next) {
+        vars[index] = (DeferredVar*)(node->dataptr);
+        setStringTableValue(varIndex, vars[index]->name, strlen(vars[index]->name) + 1, &index, sizeof(int));
+        index++;
+    }
+
+    // count the deferred names each assignment waits on and list who waits on each name
+    int* waitCounts = (int*)calloc(varCount, sizeof(int));
+    List** waiters = (List**)malloc(varCount * sizeof(List*));
+    for (int i = 0; i < varCount; i++) {waiters[i] = newList();}
+    for (int i = 0; i < varCount; i++) {
+        char* cursor = vars[i]->expr;
+        char* varName;
+        while ((varName = nextOperandName(&cursor)) != NULL) {
+            int* waitOn = (int*)readStringTable(varIndex, varName, strlen(varName) + 1);
+            if (waitOn != NULL) {
+                waitCounts[i]++;
+                appendList(waiters[*waitOn], &i, sizeof(int));
+            }
+            free(varName);
+        }
+    }
+
+    // settle the assignments in dependency order, releasing the waiters of each one that resolves
+    int* ready = (int*)malloc(varCount * sizeof(int));
+    int readyStart = 0;
+    int readyEnd = 0;
+    for (int i = 0; i < varCount; i++) {
+        if (waitCounts[i] == 0) {ready[readyEnd++] = i;}
+    }
+    while (readyStart < readyEnd) {
+        int v = ready[readyStart++];
+        DeferredVar* var = vars[v];
+        ExprErrorShort exprOut = evalShortExpr(var->expr, strlen(var->expr), varDefs, varDefs);
+        if (exprOut.errorMessage != NULL) {
+            free(exprOut.errorMessage);
+            continue;
+        }
+        setStringTableValue(varDefs, var->name, strlen(var->name) + 1, &(exprOut.val), 2);
+        free(var->expr);
+        var->expr = NULL;
+        for (Node* node = waiters[v]->head; node != NULL; node = node->next) {
+            int waiter = *(int*)(node->dataptr);
+            waitCounts[waiter]--;
+            if (waitCounts[waiter] == 0) {ready[readyEnd++] = waiter;}
+        }
+    }
+    for (int i = 0; i < varCount; i++) {deleteList(waiters[i]);}
+    free(waiters);
+    free(waitCounts);
+    free(ready);
+    free(vars);
+    deleteStringTable(varIndex);
+
+    // report the assignments that never resolved
+    for (Node* node = deferred->head; node != NULL; node = node->next) {
+        DeferredVar* var = (DeferredVar*)(node->dataptr);
+        if (var->expr != NULL) {
+            ExprErrorShort exprOut = evalShortExpr(var->expr, strlen(var->expr), varDefs, varDefs);
+            appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, var->line, exprOut.errorPos + var->col, exprOut.errorLen, var->handle);
+            free(var->expr);
+        }
+        free(var->name);
+    }
+    deleteList(deferred);
+
+    // patch the instructions
+    for (Node* node = fixups->head; node != NULL; node = node->next) {
+        Fixup* fixup = (Fixup*)(node->dataptr);
+        setMacroArgs(fixup->args, fixup->argCount, NULL);
+        List* argEvals = newList();
+        char* errorMessage1 = evalOperands(fixup->operands, varDefs, varDefs, argEvals);
+        uint16_t inst;
+        if (errorMessage1 != NULL) {
+            appendError(errorList, ERR_ARG_PARSE, 0, NULL, errorMessage1, fixup->line, fixup->col, fixup->len, fixup->handle);
+        } else if (encodeInstruction(fixup->instData, argEvals, fixup->curAddr, wordSize, &inst, errorList, fixup->line, fixup->col, fixup->len, fixup->handle)) {
+            writeInstruction(fixup->seg, fixup->writeAddr, inst, isLittleEndian);
+        }
+        deleteList(argEvals);
+        free(fixup->operands);
+        free(fixup->args);
+    }
+    setMacroArgs(NULL, 0, NULL);
+    deleteList(fixups);
+}
+
 /*
 assembles a file into the output segment
 
@@ -21,8 +507,9 @@ macroDefs: defined macros
 varDefs: defined vars
 wordSize: addresses occupied by a 16-bit word
 isLittleEndian: if the code is little endian
+isOnePass: if globals are defined while assembling instead of by readGlobalVars
 */
-char assemble(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, int wordSize, char isLittleEndian) {
+char assemble(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, int wordSize, char isLittleEndian, char isOnePass) {
     // setup
     List* localVars = newList();
     List* macroVars = newList();
@@ -30,26 +517,38 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
     unsigned int lineCount = 0;
     long filePos;
     SegmentDef* activeSeg = NULL;
-    Stack* includeStack = newStack();
-    Stack* ifStack = newStack();
-    Stack* segStack = newStack();
-    Stack* macroStack = newStack();
+    PersistentStack* includeStack = newPersistentStack();
+    PersistentStack* ifStack = newPersistentStack();
+    PersistentStack* segStack = newPersistentStack();
+    PersistentStack* macroStack = newPersistentStack();
     StringTable defines = newStringTable();
     StringTable instTable = newInstructionTable();
-
-    // reset the segment counters and allocate the outputs
+    StringTable expansions = newStringTable();
+    StringTable purity = newStringTable();
+    Stack* recordings = newStack();
+    List* deferred = newList();
+    StringTable deferredLut = newStringTable();
+    List* fixups = newList();
+
+    // index the segments once for checkpoints
+    int segCount = segments->size;
+    SegmentDef* segArr[segCount + 1];
+    uint16_t segWriteRes[segCount + 1];
+    int segIndex = 0;
+
+    // reset the segment counters and create the output images
     for (Node* node = segments->head; node != NULL; node = node->next) {
         SegmentDef* curSeg = (SegmentDef*)(node->dataptr);
+        segArr[segIndex++] = curSeg;
         curSeg->writeAddr = 0;
         if (curSeg->accessType != bss) {
-            curSeg->outputArr = (uint8_t*)malloc(curSeg->size * (wordSize == 1 ? 2 : 1));
-            for (int i = 0; i < (curSeg->size * (wordSize == 1 ? 2 : 1)); i++) {
-                curSeg->outputArr[i] = 0;
-            }
+            curSeg->image = newSegmentImage(curSeg->size * (wordSize == 1 ? 2 : 1));
         }
     }
     // get first set of local vars
+    startPassAt(PASS_LOCALS, handle, lineCount);
     readLocalVars(handle, errorList, handleList, segments, macroDefs, varDefs, defines, wordSize, localVars, activeSeg, lineCount, includeStack, ifStack, segStack, macroStack);
+    endPass();
 
     // reset the segment counters
     for (Node* node = segments->head; node != NULL; node = node->next) {
@@ -64,15 +563,35 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
             free(*(char**)(node->dataptr));
         }
         deleteList(localVars);
-        deleteStack(includeStack);
-        deleteStack(ifStack);
-        deleteStack(macroStack);
-        deleteStack(segStack);
+        deletePersistentStack(includeStack);
+        deletePersistentStack(ifStack);
+        deletePersistentStack(macroStack);
+        deletePersistentStack(segStack);
         deleteStringTable(defines);
+        deleteStringTable(instTable);
+        deleteStringTable(expansions);
+        deleteStringTable(purity);
+        deleteStack(recordings);
+        deleteList(deferred);
+        deleteStringTable(deferredLut);
+        deleteList(fixups);
         return 0;
     }
 
     while (1) {
+        // read the local labels of each .rept iteration as it starts
+        if (isReptStart(handle, macroStack)) {
+            IncludeReturnData* reptFrame = (IncludeReturnData*)peekPersistentStack(macroStack);
+            if (reptFrame->locals == NULL) {reptFrame->locals = newList();}
+            unsigned int errorCount = errorList->size;
+            checkpointSegments(segArr, segCount, segWriteRes, wordSize);
+            startPassAt(PASS_LOCALS, handle, lineCount);
+            readLocalVars(handle, errorList, handleList, segments, macroDefs, varDefs, defines, wordSize, reptFrame->locals, activeSeg, lineCount, includeStack, ifStack, segStack, macroStack);
+            endPass();
+            restoreSegments(segArr, segCount, segWriteRes);
+            if (errorList->size > errorCount) {break;}
+        }
+
         // handle new line eof
         filePos = ftell(handle->fptr);
         if (filePos == handle->length) {
@@ -90,26 +609,23 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
         if (feof(handle->fptr)) {break;}
 
         if (fgets(line, 256, handle->fptr) == NULL && !feof(handle->fptr)) {return 1;}
+        countPassLine();
 
         // empty line
 
+        // define globals as they are reached
+        if (isOnePass && !isspace(line[0]) && line[0] != '.' && line[0] != '@' && line[0] != ';' && line[0] != '\0') {
+            defineGlobal(handle, errorList, line, lineCount, activeSeg, macroStack, varDefs, defines, deferred, deferredLut, wordSize);
+        }
+
         // reset local vars
         if (!isspace(line[0]) && line[0] != '.' && line[0] != '@' && line[0] != ';') {
             unsigned int errorCount = errorList->size;
-            List* segWriteRes = newList();
-            for (Node* node = segments->head; node != NULL; node = node->next) {
-                uint16_t writeAddr = ((SegmentDef*)(node->dataptr))->writeAddr;
-                appendList(segWriteRes, &writeAddr, 2);
-                if (wordSize == 1) {((SegmentDef*)(node->dataptr))->writeAddr /= 2;}
-            }
+            checkpointSegments(segArr, segCount, segWriteRes, wordSize);
+            startPassAt(PASS_LOCALS, handle, lineCount + 1);
             readLocalVars(handle, errorList, handleList, segments, macroDefs, varDefs, defines, wordSize, localVars, activeSeg, lineCount + 1, includeStack, ifStack, segStack, macroStack);
-            Node* nodei = segWriteRes->head;
-            for (Node* nodej = segments->head; nodej != NULL; nodej = nodej->next) {
-                uint16_t writeAddr = *(uint16_t*)(nodei->dataptr);
-                ((SegmentDef*)(nodej->dataptr))->writeAddr = writeAddr;
-                nodei = nodei->next;
-            }
-            deleteList(segWriteRes);
+            endPass();
+            restoreSegments(segArr, segCount, segWriteRes);
             if (errorList->size > errorCount) {break;}
         }
 
@@ -125,11 +641,15 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
 
         if (line[i] == '.') {
             handle = executeType3Macro(handle, errorList, handleList, line, strlen(line), &lineCount, i, includeStack, ifStack, segStack, macroStack, defines, &activeSeg, segments, macroDefs, wordSize, isLittleEndian, macroVars, varDefs);
+            finishExpansions(recordings, expansions, macroStack, errorList, activeSeg);
+            if (isOnePass && checkSegmentSize(activeSeg, errorList, lineCount, handle, wordSize)) {break;}
 
         } else if (isspace(line[i])) {
             i += countWhitespaceChars(line + i, strlen(line + i));
             if (line[i] == '.') {
                 handle = executeType3Macro(handle, errorList, handleList, line + i, strlen(line + i), &lineCount, i, includeStack, ifStack, segStack, macroStack, defines, &activeSeg, segments, macroDefs, wordSize, isLittleEndian, macroVars, varDefs);
+                finishExpansions(recordings, expansions, macroStack, errorList, activeSeg);
+                if (isOnePass && checkSegmentSize(activeSeg, errorList, lineCount, handle, wordSize)) {break;}
             } else if (!isValidLineEnding(line, strlen(line))) {
                 char* afterName = line + i;
                 char* name = extractVar(&afterName, strlen(afterName));
@@ -139,28 +659,28 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
                     int argCount = countArgs(afterName, strlen(afterName));
                     if (isValidLineEnding(afterName, strlen(afterName))) {argCount = 0;}
                     if (argCount != macroData->vars->size) {
-                        char* errorStr = (char*)malloc(25 * sizeof(char));
-                        sprintf(errorStr, "Incorrect argument count");
-                        ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName) + 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_MACRO_ARG_COUNT, 0, NULL, NULL, lineCount, (afterName - line), strlen(afterName) + 1, handle);
                         free(name);
                         lineCount++;
                         continue;
                     }
 
-                    // define the vars
+                    // evaluate the args into the call's frame
                     char hasError = 0;
                     char* errorMessage1;
                     List* args = extractArgs(afterName, strlen(afterName));
-                    Node* argNode = args->head;
-                    for (Node* node = macroData->vars->head; node != NULL; node = node->next) {
-                        char* expr = *(char**)(argNode->dataptr);
-                        char* name = *(char**)(node->dataptr);
+                    uint16_t* argVals = (uint16_t*)malloc((argCount + 1) * sizeof(uint16_t));
+                    int argIndex = 0;
+                    for (Node* node = args->head; node != NULL; node = node->next) {
+                        // a call without arguments still extracts one empty argument
+                        char* expr = *(char**)(node->dataptr);
+                        if (argIndex == argCount) {
+                            free(expr);
+                            continue;
+                        }
                         ExprErrorShort exprOut = evalShortExpr(expr, strlen(expr), varDefs, defines);
                         if (exprOut.errorMessage == NULL) {
-                            uint16_t val = exprOut.val;
-                            appendList(macroVars, &name, sizeof(char*));
-                            setStringTableValue(varDefs, name, strlen(name) + 1, &val, 2);
+                            argVals[argIndex] = exprOut.val;
                         } else {
                             if (!hasError) {
                                 errorMessage1 = (char*)malloc((strlen(exprOut.errorMessage) + 1) * sizeof(char));
@@ -169,48 +689,66 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
                             free(exprOut.errorMessage);
                             hasError = 1;
                         }
-
-                        argNode = argNode->next;
+                        free(expr);
+                        argIndex++;
                     }
                     deleteList(args);
                     if (hasError) {
-                        char* errorStr = (char*)malloc(30 * sizeof(char) + strlen(errorMessage1) * sizeof(char));
-                        sprintf(errorStr, "Could not parse arguments: %s", errorMessage1);
-                        ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_ARG_PARSE, 0, NULL, errorMessage1, lineCount, (afterName - line), strlen(afterName), handle);
                         free(name);
-                        free(errorMessage1);
+                        free(argVals);
                         lineCount++;
                         continue;
                     }
 
+                    // splice a cached expansion
+                    char* expansionKey = NULL;
+                    if (activeSeg != NULL && activeSeg->image != NULL && isPureMacro(macroData, name, purity, instTable, varDefs)) {
+                        expansionKey = (char*)malloc((strlen(name) + 5 * argCount + 1) * sizeof(char));
+                        int keyLen = sprintf(expansionKey, "%s", name);
+                        for (int j = 0; j < argCount; j++) {keyLen += sprintf(expansionKey + keyLen, ":%x", argVals[j]);}
+                        uint8_t* expansion = (uint8_t*)readStringTable(expansions, expansionKey, keyLen + 1);
+                        if (expansion != NULL) {
+                            uint16_t length;
+                            memcpy(&length, expansion, sizeof(uint16_t));
+                            writeSegmentBytes(activeSeg->image, activeSeg->writeAddr, expansion + sizeof(uint16_t), length);
+                            activeSeg->writeAddr += length;
+                            countMacroExpansion(name, 1);
+                            free(expansionKey);
+                            free(argVals);
+                            free(name);
+                            lineCount++;
+                            continue;
+                        }
+                    }
+
                     // push return data
-                    IncludeReturnData retData = {handle, 0, lineCount, errorList->size};
+                    beginTraceEvent(name, "macro", handle, lineCount);
+                    IncludeReturnData retData = {handle, 0, lineCount, errorList->size, argVals, argCount};
                     retData.filePosition = ftell(handle->fptr);
-                    pushStack(macroStack, &retData, sizeof(IncludeReturnData));
+                    pushPersistentStack(macroStack, &retData, sizeof(IncludeReturnData));
+                    countMacroDepth(macroStack->size);
+                    countMacroExpansion(name, 0);
+                    setMacroArgs(argVals, argCount, NULL);
+
+                    // record the expansion for later calls
+                    if (expansionKey != NULL) {
+                        ExpansionRecord record = {expansionKey, activeSeg, activeSeg->writeAddr, macroStack->size, errorList->size};
+                        pushStack(recordings, &record, sizeof(ExpansionRecord));
+                    }
 
                     // go to the macro
-                    handle = macroData->handle;
+                    handle = enterMacroBody(macroData);
                     lineCount = macroData->line;
-                    fseek(handle->fptr, macroData->start, SEEK_SET);
 
-                    // read in the macroVars
+                    // read in the macro's local labels
                     List* tempMacroVars = newList();
                     unsigned int errorCount = errorList->size;
-                    List* segWriteRes = newList();
-                    for (Node* node = segments->head; node != NULL; node = node->next) {
-                        uint16_t writeAddr = ((SegmentDef*)(node->dataptr))->writeAddr;
-                        appendList(segWriteRes, &writeAddr, 2);
-                        if (wordSize == 1) {((SegmentDef*)(node->dataptr))->writeAddr /= 2;}
-                    }
+                    checkpointSegments(segArr, segCount, segWriteRes, wordSize);
+                    startPassAt(PASS_LOCALS, handle, lineCount + 1);
                     readLocalVars(handle, errorList, handleList, segments, macroDefs, varDefs, defines, wordSize, tempMacroVars, activeSeg, lineCount + 1, includeStack, ifStack, segStack, macroStack);
-                    Node* nodei = segWriteRes->head;
-                    for (Node* nodej = segments->head; nodej != NULL; nodej = nodej->next) {
-                        uint16_t writeAddr = *(uint16_t*)(nodei->dataptr);
-                        ((SegmentDef*)(nodej->dataptr))->writeAddr = writeAddr;
-                        nodei = nodei->next;
-                    }
-                    deleteList(segWriteRes);
+                    endPass();
+                    restoreSegments(segArr, segCount, segWriteRes);
                     
                     // stitch to macroVars
                     if (macroVars->tail) {macroVars->tail->next = tempMacroVars->head;}
@@ -224,42 +762,43 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
                     // get the instruction
                     InstData* instData = readStringTable(instTable, name, strlen(name) + 1);
                     if (instData == NULL) {
-                        char* errorStr = (char*)malloc((23 + strlen(name)) * sizeof(char));
-                        sprintf(errorStr, "Invalid instruction: %s", name);
-                        ErrorData errorData = {errorStr, lineCount, i, strlen(name), handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_INVALID_INSTRUCTION, 0, NULL, name, lineCount, i, strlen(name), handle);
+                        lineCount++;
+                        continue;
+                    }
+
+                    if (isOnePass && activeSeg == NULL) {
+                        appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, lineCount, i, strlen(name), handle);
                         free(name);
                         lineCount++;
                         continue;
                     }
 
                     // get the args
-                    char hasError = 0;
-                    char* errorMessage1;
-                    List* args = extractArgs(afterName, strlen(afterName));
                     List* argEvals = newList();
-                    for (Node* node = args->head; node != NULL; node = node->next) {
-                        char* expr = *(char**)(node->dataptr);
-                        ExprErrorShort exprOut = evalShortExpr(expr, strlen(expr), varDefs, defines);
-                        if (exprOut.errorMessage == NULL) {
-                            appendList(argEvals, &(exprOut.val), 2);
-                        } else if (args->size >= 1 && !isValidLineEnding(expr, strlen(expr) + 1)) {
-                            if (!hasError) {
-                                errorMessage1 = (char*)malloc((strlen(exprOut.errorMessage) + 1) * sizeof(char));
-                                strcpy(errorMessage1, exprOut.errorMessage);
-                            }
-                            hasError = 1;
-                            free(exprOut.errorMessage);
+                    char* errorMessage1 = evalOperands(afterName, varDefs, defines, argEvals);
+                    uint16_t curAddr = (activeSeg == NULL) ? 0 : (activeSeg->writeAddr / (wordSize == 1 ? 2 : 1)) + activeSeg->startAddr;
+                    if (errorMessage1 != NULL && isOnePass && canDeferOperands(afterName, varDefs, defines)) {
+                        // encode once the later globals are known
+                        Fixup fixup = {activeSeg, activeSeg->writeAddr, curAddr, instData, NULL, NULL, 0, lineCount, (afterName - line), strlen(afterName), handle};
+                        fixup.operands = (char*)memcpy(malloc(strlen(afterName) + 1), afterName, strlen(afterName) + 1);
+                        IncludeReturnData* frame = (macroStack->size > 0) ? (IncludeReturnData*)peekPersistentStack(macroStack) : NULL;
+                        if (frame != NULL && frame->args != NULL) {
+                            fixup.args = (uint16_t*)memcpy(malloc((frame->argCount + 1) * sizeof(uint16_t)), frame->args, frame->argCount * sizeof(uint16_t));
+                            fixup.argCount = frame->argCount;
                         }
+                        appendList(fixups, &fixup, sizeof(Fixup));
+                        free(errorMessage1);
+                        deleteList(argEvals);
+                        activeSeg->writeAddr += 2;
+                        free(name);
+                        if (checkSegmentSize(activeSeg, errorList, lineCount, handle, wordSize)) {break;}
+                        lineCount++;
+                        continue;
                     }
-                    deleteList(args);
-                    if (hasError) {
-                        char* errorStr = (char*)malloc(30 * sizeof(char) + strlen(errorMessage1) * sizeof(char));
-                        sprintf(errorStr, "Could not parse arguments: %s", errorMessage1);
-                        ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                    if (errorMessage1 != NULL) {
+                        appendError(errorList, ERR_ARG_PARSE, 0, NULL, errorMessage1, lineCount, (afterName - line), strlen(afterName), handle);
                         free(name);
-                        free(errorMessage1);
                         deleteList(argEvals);
                         lineCount++;
                         continue;
@@ -267,145 +806,21 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
 
                     // assemble the instruction
                     uint16_t inst;
-                    if (instData->type == reg || instData->type == imm || instData->type == sft) {
-                        // make sure that the arg count is correct
-                        if (argEvals->size != 2) {
-                            char* errorStr = (char*)malloc(40 * sizeof(char));
-                            sprintf(errorStr, "Invalid number of arguments: expected 2");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                            lineCount++;
-                            free(name);
-                            deleteList(argEvals);
-                            continue;
-                        }
-
-                        // get args
-                        uint16_t arg1 = *(uint16_t*)(argEvals->head->dataptr);
-                        uint16_t arg2 = *(uint16_t*)(argEvals->tail->dataptr);
-
-                        // error on size
-                        hasError = 0;
-                        if (instData->type == reg && arg1 > 15) {
-                            hasError = 1;
-                            char* errorStr = (char*)malloc(33 * sizeof(char));
-                            sprintf(errorStr, "Argument 1 exceeds range 0 to 15");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                        } else if (instData->type == imm && ((arg1 & 0xff00) != 0x0000 && (arg1 & 0xff00) != 0xff00)) {
-                            hasError = 1;
-                            char* errorStr = (char*)malloc(49 * sizeof(char));
-                            sprintf(errorStr, "Argument 1 exceeds range -128 to 127 or 0 to 255");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                        } else if (instData->type == sft && ((arg1 & 0xffe0) != 0x0000 && (arg1 & 0xffe0) != 0xffe0)) {
-                            hasError = 1;
-                            char* errorStr = (char*)malloc(35 * sizeof(char));
-                            sprintf(errorStr, "Argument 1 exceeds range -16 to 15");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                        }
-                        if (instData->type == imm && arg2 > 255) {
-                            hasError = 1;
-                            char* errorStr = (char*)malloc(49 * sizeof(char));
-                            sprintf(errorStr, "Argument 2 exceeds range -128 to 127 or 0 to 255");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                        } else if (instData->type != imm && arg2 > 15) {
-                            hasError = 1;
-                            char* errorStr = (char*)malloc(33 * sizeof(char));
-                            sprintf(errorStr, "Argument 2 exceeds range 0 to 15");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                        }
-                        if (hasError) {
-                            deleteList(argEvals);
-                            free(name);
-                            lineCount++;
-                            continue;
-                        }
-
-                        // get the instruction
-                        if (instData->type == reg) {arg1 &= 0x000f;}
-                        else if (instData->type == imm) {arg1 &= 0x00ff;}
-                        else {arg1 &= 0x001f;}
-                        arg2 &= 0x000f;
-                        inst = instData->param2(arg1, arg2);
-                    } else if (instData->type == brc || instData->type == jrg) {
-                        // make sure that the arg count is correct
-                        if (argEvals->size != 1) {
-                            char* errorStr = (char*)malloc(40 * sizeof(char));
-                            sprintf(errorStr, "Invalid number of arguments: expected 1");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                            lineCount++;
-                            free(name);
-                            deleteList(argEvals);
-                            continue;
-                        }
-
-                        // get the argument
-                        uint16_t arg = *(uint16_t*)(argEvals->head->dataptr);
-                        hasError = 0;
-                        if (instData->type == brc) {
-                            uint16_t curAddr = (activeSeg->writeAddr / (wordSize == 1 ? 2 : 1)) + activeSeg->startAddr;
-                            arg = arg - curAddr - wordSize;
-                            if ((arg & 0xff80) != 0x0000 && (arg & 0xff80) != 0xff80) {
-                                hasError = 1;
-                                char* errorStr = (char*)malloc(46 * sizeof(char));
-                                sprintf(errorStr, "Branch displacement exceeds range -128 to 127");
-                                ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                                appendList(errorList, &errorData, sizeof(ErrorData));
-                            }
-                            arg &= 0x00ff;
-                        } else {
-                            if (arg > 15) {
-                                hasError = 1;
-                                char* errorStr = (char*)malloc(31 * sizeof(char));
-                                sprintf(errorStr, "Argument exceeds range 0 to 15");
-                                ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                                appendList(errorList, &errorData, sizeof(ErrorData));
-                            }
-                            arg &= 0x000f;
-                        }
-                        if (hasError) {
-                            lineCount++;
-                            deleteList(argEvals);
-                            free(name);
-                            continue;
-                        }
-
-                        // generate the instruction
-                        inst = instData->param1(arg);
-                    } else {
-                        // make sure that the arg count is correct
-                        if (argEvals->size != 0) {
-                            char* errorStr = (char*)malloc(40 * sizeof(char));
-                            sprintf(errorStr, "Invalid number of arguments: expected 0");
-                            ErrorData errorData = {errorStr, lineCount, (afterName - line), strlen(afterName), handle};
-                            appendList(errorList, &errorData, sizeof(ErrorData));
-                            lineCount++;
-                            free(name);
-                            deleteList(argEvals);
-                            continue;
-                        }
-
-                        // generate instruction
-                        inst = instData->param0();
+                    if (!encodeInstruction(instData, argEvals, curAddr, wordSize, &inst, errorList, lineCount, (afterName - line), strlen(afterName), handle)) {
+                        deleteList(argEvals);
+                        free(name);
+                        lineCount++;
+                        continue;
                     }
 
                     // write the instruction
-                    uint8_t upperByte = (uint8_t)(inst >> 8);
-                    uint8_t lowerByte = (uint8_t)(inst & 0x00ff);
-                    if (isLittleEndian) {
-                        activeSeg->outputArr[activeSeg->writeAddr] = lowerByte;
-                        activeSeg->outputArr[activeSeg->writeAddr + 1] = upperByte;
-                    } else {
-                        activeSeg->outputArr[activeSeg->writeAddr] = upperByte;
-                        activeSeg->outputArr[activeSeg->writeAddr + 1] = lowerByte;
-                    }
+                    writeInstruction(activeSeg, activeSeg->writeAddr, inst, isLittleEndian);
                     deleteList(argEvals);
                     activeSeg->writeAddr += 2;
+                    if (isOnePass && checkSegmentSize(activeSeg, errorList, lineCount, handle, wordSize)) {
+                        free(name);
+                        break;
+                    }
                 }
 
                 free(name);
@@ -415,17 +830,31 @@ char assemble(FileHandle* handle, List* errorList, List* handleList, List* segme
         lineCount++;
     }
 
+    // patch the forward references
+    resolveForwardRefs(errorList, deferred, fixups, varDefs, wordSize, isLittleEndian);
+    deleteStringTable(deferredLut);
+
     // cleanup
+    recordTableStats("defines", defines);
+    recordTableStats("instructions", instTable);
     for (Node* node = localVars->head; node != NULL; node = node->next) {
         free(*(char**)(node->dataptr));
     }
     deleteList(macroVars);
     deleteList(localVars);
-    deleteStack(includeStack);
-    deleteStack(ifStack);
-    deleteStack(macroStack);
-    deleteStack(segStack);
+    deletePersistentStack(includeStack);
+    deletePersistentStack(ifStack);
+    deletePersistentStack(macroStack);
+    deletePersistentStack(segStack);
     deleteStringTable(defines);
     deleteStringTable(instTable);
+    deleteStringTable(expansions);
+    deleteStringTable(purity);
+    while (recordings->size > 0) {
+        ExpansionRecord* record = (ExpansionRecord*)popStack(recordings);
+        free(record->key);
+        free(record);
+    }
+    deleteStack(recordings);
     return 0;
 }
\ No newline at end of file
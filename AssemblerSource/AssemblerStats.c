@@ -0,0 +1,160 @@
+/*
+counts of how the symbol tables, include and macro stacks and .if skips behaved on a run
+nothing is counted unless the --stats option turned the counts on
+
+Written by Adam Billings
+*/
+
+#include <stdlib.h>
+#include "AssemblerStats.h"
+
+// if the counts are on
+static char isCounting = 0;
+
+// tables recorded so far
+static TableStats tableStats[STATS_TABLE_COUNT];
+static int tableCount = 0;
+
+// deepest stacks
+static int maxIncludeDepth = 0;
+static int maxMacroDepth = 0;
+
+// lines passed over by false conditions, in every pass
+static unsigned long skippedLines = 0;
+
+// expansions of each macro, NULL until the counts are on
+static StringTable macroStats = NULL;
+
+/*
+turns on the counts
+*/
+void enableStats() {
+    isCounting = 1;
+    if (macroStats == NULL) {macroStats = newStringTable();}
+}
+
+/*
+records the entries and chain lengths of a table, call before it is deleted
+
+name: name of the table in the report
+table: table to record
+*/
+void recordTableStats(const char* name, StringTable table) {
+    if (!isCounting || tableCount == STATS_TABLE_COUNT) {return;}
+    TableStats* stats = tableStats + tableCount++;
+    memset(stats, 0, sizeof(TableStats));
+    stats->name = name;
+    for (int i = 0; i < 256; i++) {
+        unsigned int length = table[i]->size;
+        stats->entries += length;
+        if (length > 0) {stats->usedBuckets++;}
+        if (length > stats->longestChain) {stats->longestChain = length;}
+        stats->chains[(length < STATS_CHAIN_LENGTHS) ? length : STATS_CHAIN_LENGTHS - 1]++;
+    }
+}
+
+/*
+records the depth of the include stack after an include is entered
+
+depth: number of files being included
+*/
+void countIncludeDepth(int depth) {
+    if (depth > maxIncludeDepth) {maxIncludeDepth = depth;}
+}
+
+/*
+records the depth of the macro stack after a macro call or .rept is entered
+
+depth: number of macro calls and repetitions being read
+*/
+void countMacroDepth(int depth) {
+    if (depth > maxMacroDepth) {maxMacroDepth = depth;}
+}
+
+/*
+counts an expansion of a macro in the assembly pass
+
+name: name of the macro
+isCached: if the expansion was copied from an earlier call
+*/
+void countMacroExpansion(char* name, char isCached) {
+    if (!isCounting) {return;}
+    MacroStats* stats = (MacroStats*)readStringTable(macroStats, name, strlen(name) + 1);
+    if (stats == NULL) {
+        MacroStats newStats = {0, 0};
+        setStringTableValue(macroStats, name, strlen(name) + 1, &newStats, sizeof(MacroStats));
+        stats = (MacroStats*)readStringTable(macroStats, name, strlen(name) + 1);
+    }
+    stats->calls++;
+    if (isCached) {stats->cached++;}
+}
+
+/*
+counts lines passed over by a false .if condition
+
+lines: number of lines skipped
+*/
+void countSkippedLines(unsigned int lines) {
+    skippedLines += lines;
+}
+
+/*
+prints the report
+
+stream: where to print
+*/
+void printStats(FILE* stream) {
+    fprintf(stream, "  -- Statistics --\n");
+
+    // tables
+    fprintf(stream, "    %-12s %8s %8s %8s", "table", "entries", "buckets", "longest");
+    for (int i = 0; i < STATS_CHAIN_LENGTHS - 1; i++) {fprintf(stream, " %6d", i);}
+    fprintf(stream, " %5d+\n", STATS_CHAIN_LENGTHS - 1);
+    for (int i = 0; i < tableCount; i++) {
+        TableStats* stats = tableStats + i;
+        fprintf(stream, "    %-12s %8lu %4u/256 %8u", stats->name, stats->entries, stats->usedBuckets, stats->longestChain);
+        for (int j = 0; j < STATS_CHAIN_LENGTHS; j++) {fprintf(stream, " %6u", stats->chains[j]);}
+        fprintf(stream, "\n");
+    }
+    fprintf(stream, "\n");
+
+    // stacks and skips
+    fprintf(stream, "    deepest include: %d\n", maxIncludeDepth);
+    fprintf(stream, "    deepest macro call: %d\n", maxMacroDepth);
+    fprintf(stream, "    lines skipped by .if in all passes: %lu\n\n", skippedLines);
+
+    // gather the macros
+    if (macroStats == NULL) {return;}
+    int macroCount = 0;
+    for (int i = 0; i < 256; i++) {macroCount += macroStats[i]->size;}
+    if (macroCount == 0) {
+        deleteStringTable(macroStats);
+        macroStats = NULL;
+        return;
+    }
+    KeyValuePair* macros = (KeyValuePair*)malloc(macroCount * sizeof(KeyValuePair));
+    macroCount = 0;
+    for (int i = 0; i < 256; i++) {
+        for (Node* node = macroStats[i]->head; node != NULL; node = node->next) {macros[macroCount++] = *(KeyValuePair*)(node->dataptr);}
+    }
+
+    // print the macros with the most expansions
+    int top = (macroCount < STATS_MACRO_TOP) ? macroCount : STATS_MACRO_TOP;
+    fprintf(stream, "    top %d of %d macros by expansions\n", top, macroCount);
+    fprintf(stream, "    %12s %12s  %s\n", "expansions", "cached", "macro");
+    for (int i = 0; i < top; i++) {
+        int best = i;
+        for (int j = i + 1; j < macroCount; j++) {
+            if (((MacroStats*)macros[j].valueptr)->calls > ((MacroStats*)macros[best].valueptr)->calls) {best = j;}
+        }
+        KeyValuePair swap = macros[i];
+        macros[i] = macros[best];
+        macros[best] = swap;
+        MacroStats* stats = (MacroStats*)macros[i].valueptr;
+        fprintf(stream, "    %12lu %12lu  %s\n", stats->calls, stats->cached, macros[i].key);
+    }
+    fprintf(stream, "\n");
+    free(macros);
+    deleteStringTable(macroStats);
+    macroStats = NULL;
+}
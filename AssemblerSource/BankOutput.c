@@ -0,0 +1,248 @@
+/*
+verilog $readmemh, xilinx coe and intel mif output for fpga block memories
+the segment images are laid out at their addresses and split into the banks and byte lanes of the configuration
+
+Written by Adam Billings
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "ConfigReader.h"
+#include "SegmentImage.h"
+#include "BankOutput.h"
+
+/*
+writes the buffered text to the file
+
+file: file to empty
+*/
+static void flushBankFile(BankFile* file) {
+    fwrite(file->text, 1, file->used, file->output);
+    file->used = 0;
+}
+
+/*
+adds the hex digits of a value
+
+file: file to add to
+val: value to add
+digits: number of digits
+*/
+static void putBankHex(BankFile* file, uint64_t val, int digits) {
+    static const char hexDigits[] = "0123456789abcdef";
+    for (int i = digits - 1; i >= 0; i--) {file->text[file->used++] = hexDigits[(val >> (4 * i)) & 0x0f];}
+}
+
+/*
+copies a range of the address space out of the segments, where segments overlap the later one wins
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+addr: byte address to start at
+len: number of bytes
+data: output bytes, unwritten addresses read as 0
+*/
+static void readBankBytes(List* segments, int wordSize, uint32_t addr, uint32_t len, uint8_t* data) {
+    memset(data, 0, len);
+    for (Node* node = segments->head; node != NULL; node = node->next) {
+        SegmentDef* seg = (SegmentDef*)(node->dataptr);
+        if (seg->accessType == bss || seg->image == NULL || seg->writeAddr == 0) {continue;}
+
+        // overlap of the range with the written part of the segment
+        uint32_t base = seg->startAddr * (wordSize == 1 ? 2 : 1);
+        uint32_t from = (addr > base) ? addr : base;
+        uint32_t to = (addr + len < base + seg->writeAddr) ? addr + len : base + seg->writeAddr;
+
+        // copy a page at a time, pages that were never written hold zeros
+        while (from < to) {
+            uint32_t offset = from - base;
+            uint32_t run = SEGMENT_PAGE_SIZE - offset % SEGMENT_PAGE_SIZE;
+            if (run > to - from) {run = to - from;}
+            if (isSegmentPageCommitted(seg->image, offset / SEGMENT_PAGE_SIZE)) {
+                memcpy(data + (from - addr), readSegmentPage(seg->image, offset / SEGMENT_PAGE_SIZE) + offset % SEGMENT_PAGE_SIZE, run);
+            } else {memset(data + (from - addr), 0, run);}
+            from += run;
+        }
+    }
+}
+
+/*
+adds a complete word to the lane files of its bank
+
+stream: bank being written
+format: memory file format
+*/
+static void putBankWord(BankStream* stream, BankFormat format) {
+    const BankDef* bank = stream->bank;
+    uint32_t row = stream->wordIndex % bank->depth;
+    BankFile** files = stream->files + (stream->wordIndex / bank->depth) * bank->lanes;
+    uint64_t mask = (stream->laneBits == 64) ? ~(uint64_t)0 : (((uint64_t)1 << stream->laneBits) - 1);
+
+    // lane 0 holds the least significant bits
+    for (int lane = 0; lane < bank->lanes; lane++) {
+        BankFile* file = files[lane];
+        if (file->used > BANK_BUFFER_SIZE - 64) {flushBankFile(file);}
+        uint64_t val = (stream->word >> (lane * stream->laneBits)) & mask;
+        if (format == BANK_MIF) {
+            memcpy(file->text + file->used, "    ", 4);
+            file->used += 4;
+            putBankHex(file, row, stream->addrDigits);
+            memcpy(file->text + file->used, " : ", 3);
+            file->used += 3;
+        }
+        putBankHex(file, val, stream->laneBits / 4);
+        if (format == BANK_COE) {file->text[file->used++] = (row == bank->depth - 1) ? ';' : ',';}
+        else if (format == BANK_MIF) {file->text[file->used++] = ';';}
+        file->text[file->used++] = '\n';
+    }
+    stream->wordIndex++;
+}
+
+/*
+opens the files of a bank definition and writes their headers
+
+stream: bank to open
+format: memory file format
+outputName: output file name
+isNamed: if the bank name is added to the file name
+
+returns: if every file could be opened
+*/
+static char openBankStream(BankStream* stream, BankFormat format, char* outputName, char isNamed) {
+    static const char* const extensions[] = {".mem", ".coe", ".mif"};
+    const BankDef* bank = stream->bank;
+    int fileCount = bank->count * bank->lanes;
+    stream->files = (BankFile**)calloc(fileCount, sizeof(BankFile*));
+    for (int i = 0; i < fileCount; i++) {
+        // <output>_<name>[_b<bank>][_l<lane>].<ext>
+        char* fileName = outputName;
+        char nameBuffer[strlen(outputName) + (isNamed ? strlen(bank->name) : 0) + 32];
+        if (isNamed) {
+            int len = sprintf(nameBuffer, "%s_%s", outputName, bank->name);
+            if (bank->count > 1) {len += sprintf(nameBuffer + len, "_b%d", i / bank->lanes);}
+            if (bank->lanes > 1) {len += sprintf(nameBuffer + len, "_l%d", i % bank->lanes);}
+            strcpy(nameBuffer + len, extensions[format]);
+            fileName = nameBuffer;
+        }
+
+        FILE* output = fopen(fileName, "w");
+        if (output == NULL) {
+            printf("\e[1;31mERROR:\e[0m Could not open %s\n\n", fileName);
+            return 0;
+        }
+        BankFile* file = (BankFile*)malloc(sizeof(BankFile));
+        file->output = output;
+        file->used = 0;
+        stream->files[i] = file;
+
+        // headers
+        if (format == BANK_COE) {
+            file->used = sprintf(file->text, "memory_initialization_radix=16;\nmemory_initialization_vector=\n");
+        } else if (format == BANK_MIF) {
+            file->used = sprintf(file->text, "WIDTH=%d;\nDEPTH=%u;\n\nADDRESS_RADIX=HEX;\nDATA_RADIX=HEX;\n\nCONTENT BEGIN\n", stream->laneBits, bank->depth);
+        }
+    }
+    return 1;
+}
+
+/*
+writes the footers of a bank definition and closes its files
+
+stream: bank to close
+format: memory file format
+*/
+static void closeBankStream(BankStream* stream, BankFormat format) {
+    if (stream->files == NULL) {return;}
+    for (int i = 0; i < stream->bank->count * stream->bank->lanes; i++) {
+        BankFile* file = stream->files[i];
+        if (file == NULL) {continue;}
+        if (format == BANK_MIF) {
+            memcpy(file->text + file->used, "END;\n", 5);
+            file->used += 5;
+        }
+        flushBankFile(file);
+        fclose(file->output);
+        free(file);
+    }
+    free(stream->files);
+    stream->files = NULL;
+}
+
+/*
+writes the segments as memory files, one for each bank and lane
+
+segments: list of segments
+banks: bank definitions of the configuration, one bank over the written addresses if empty
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+isLittleEndian: if the first byte of a word is the least significant
+format: memory file format
+outputName: output file name, banks add their name, bank and lane to it
+
+returns: if every file could be opened
+*/
+char writeBanks(List* segments, List* banks, int wordSize, char isLittleEndian, BankFormat format, char* outputName) {
+    uint32_t scale = (wordSize == 1) ? 2 : 1;
+
+    // without a BANKS block, one memory word per address up to the last written one
+    BankDef wholeBank = NEW_BANK;
+    if (banks->size == 0) {
+        uint32_t end = 0;
+        for (Node* node = segments->head; node != NULL; node = node->next) {
+            SegmentDef* seg = (SegmentDef*)(node->dataptr);
+            if (seg->accessType == bss || seg->image == NULL) {continue;}
+            if (seg->startAddr * scale + seg->writeAddr > end) {end = seg->startAddr * scale + seg->writeAddr;}
+        }
+        wholeBank.width = 8 * scale;
+        wholeBank.depth = (end + scale - 1) / scale;
+        if (wholeBank.depth == 0) {wholeBank.depth = 1;}
+    }
+
+    // lay out every bank in the address space
+    int streamCount = (banks->size == 0) ? 1 : banks->size;
+    BankStream* streams = (BankStream*)calloc(streamCount, sizeof(BankStream));
+    Node* node = banks->head;
+    uint32_t first = UINT32_MAX;
+    uint32_t last = 0;
+    char isOpen = 1;
+    for (int i = 0; i < streamCount; i++) {
+        BankStream* stream = streams + i;
+        stream->bank = (banks->size == 0) ? &wholeBank : (BankDef*)(node->dataptr);
+        if (node != NULL) {node = node->next;}
+        stream->wordBytes = stream->bank->width / 8;
+        stream->laneBits = stream->bank->width / stream->bank->lanes;
+        stream->startByte = stream->bank->startAddr * scale;
+        stream->endByte = stream->startByte + stream->bank->count * stream->bank->depth * stream->wordBytes;
+        for (uint32_t rows = stream->bank->depth - 1; rows > 0; rows >>= 4) {stream->addrDigits++;}
+        if (stream->addrDigits == 0) {stream->addrDigits = 1;}
+        if (stream->startByte < first) {first = stream->startByte;}
+        if (stream->endByte > last) {last = stream->endByte;}
+        if (isOpen) {isOpen = openBankStream(stream, format, outputName, banks->size != 0);}
+    }
+
+    // one pass over the address space feeds every bank that covers each byte
+    uint8_t* chunk = (uint8_t*)malloc(BANK_CHUNK_SIZE);
+    for (uint32_t addr = first; isOpen && addr < last; addr += BANK_CHUNK_SIZE) {
+        uint32_t len = (last - addr < BANK_CHUNK_SIZE) ? last - addr : BANK_CHUNK_SIZE;
+        readBankBytes(segments, wordSize, addr, len, chunk);
+        for (int i = 0; i < streamCount; i++) {
+            BankStream* stream = streams + i;
+            uint32_t from = (addr > stream->startByte) ? addr : stream->startByte;
+            uint32_t to = (addr + len < stream->endByte) ? addr + len : stream->endByte;
+            for (uint32_t byte = from; byte < to; byte++) {
+                if (isLittleEndian) {stream->word |= (uint64_t)chunk[byte - addr] << (8 * stream->wordUsed);}
+                else {stream->word = (stream->word << 8) | chunk[byte - addr];}
+                if (++stream->wordUsed == stream->wordBytes) {
+                    putBankWord(stream, format);
+                    stream->word = 0;
+                    stream->wordUsed = 0;
+                }
+            }
+        }
+    }
+    free(chunk);
+
+    // cleanup
+    for (int i = 0; i < streamCount; i++) {closeBankStream(streams + i, format);}
+    free(streams);
+    return isOpen;
+}
@@ -8,11 +8,15 @@ Written by Adam Billings
 #include "DataStructures/StringTable.h"
 #include "ExpressionEvaluation.h"
 #include "MiscAssembler.h"
+#include "PassTimer.h"
 #include "ConfigReader.h"
 
 // sample uninitialized segment
 const SegmentDef NEW_SEGMENT = {NULL, 0, 0, 1, bss, 0, 0, NULL};
 
+// sample uninitialized bank
+const BankDef NEW_BANK = {NULL, 0, 0, 0, 1, 1};
+
 /*
 determines if the line ending is valid
 
@@ -52,10 +56,7 @@ unsigned int readMemoryAttribute(FileHandle* handle, List* errorList, char* line
         if (!((line[j] >= 'a' && line[j] <= 'z') || line[j] >= 'A' && line[j] <= 'Z')) {break;}
     }
     if (j == i) {
-        char* errorStr = (char*)malloc(26 * sizeof(char));
-        sprintf(errorStr, "Expected memory attribute");
-        ErrorData errorData = {errorStr, curLine, curCol, 1, handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_EXPECTED_ATTRIBUTE, 0, NULL, NULL, curLine, curCol, 1, handle);
         return 0;
     }
     char attrName[j - i + 1];
@@ -65,10 +66,7 @@ unsigned int readMemoryAttribute(FileHandle* handle, List* errorList, char* line
     // read '='
     int k = countWhitespaceChars(line + j, strlen(line + j)) + j;
     if (line[k] != '=') {
-        char* errorStr = (char*)malloc(11 * sizeof(char));
-        sprintf(errorStr, "Expected =");
-        ErrorData errorData = {errorStr, curLine, curCol + j, 1, handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_EXPECTED_EQUALS, 0, NULL, NULL, curLine, curCol + j, 1, handle);
         return 0;
     }
 
@@ -86,8 +84,7 @@ unsigned int readMemoryAttribute(FileHandle* handle, List* errorList, char* line
     if (strcmp(attrName, "type")) {
         ExprErrorShort exprOut = evalShortExpr(expr, l - k, nullST, nullST);
         if (exprOut.errorMessage != NULL) {
-            ErrorData errorData = {exprOut.errorMessage, curLine, curCol + k + 1 + exprOut.errorPos, exprOut.errorLen, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, curLine, curCol + k + 1 + exprOut.errorPos, exprOut.errorLen, handle);
             return 0;
         }
         val = exprOut.val;
@@ -122,34 +119,22 @@ unsigned int readMemoryAttribute(FileHandle* handle, List* errorList, char* line
         else if (!strcmp(type, "rw")) {segment->accessType = rw;}
         else if (!strcmp(type, "bss")) {segment->accessType = bss;}
         else {
-            char* errorStr = (char*)malloc((29 + strlen(type) * sizeof(char)));
-            sprintf(errorStr, "Unrecognized access type: %s", type);
-            ErrorData errorData = {errorStr, curLine, curCol + k + m + 1, n - m, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_ACCESS_TYPE, 0, NULL, (char*)memcpy(malloc(strlen(type) + 1), type, strlen(type) + 1), curLine, curCol + k + m + 1, n - m, handle);
             return 0;
         }
 
         // check for trailing garbage
         if (!isValidConfigEnding(line + k + n + 1, strlen(line + k + n + 1), 0)) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, curLine, curCol + k + n + 1, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, curLine, curCol + k + n + 1, 1, handle);
             return 0;
         }
 
     } else {
-        char* errorStr = (char*)malloc((27 + strlen(attrName)) * sizeof(char));
-        sprintf(errorStr, "Unrecognized attribute: %s", attrName);
-        ErrorData errorData = {errorStr, curLine, curCol + i, strlen(attrName), handle};
-        appendList(errorList, &errorData, sizeof(errorData));
+        appendError(errorList, ERR_UNKNOWN_ATTRIBUTE, 0, NULL, (char*)memcpy(malloc(strlen(attrName) + 1), attrName, strlen(attrName) + 1), curLine, curCol + i, strlen(attrName), handle);
         return 0;
     }
     if (hasRepeat) {
-        char* errorStr = (char*)malloc((27 + strlen(attrName)) * sizeof(char));
-        sprintf(errorStr, "Redeclaration of value: %s", attrName);
-        ErrorData errorData = {errorStr, curLine, curCol + i, strlen(attrName), handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_REDECLARATION, 0, NULL, (char*)memcpy(malloc(strlen(attrName) + 1), attrName, strlen(attrName) + 1), curLine, curCol + i, strlen(attrName), handle);
         return 0;
     }
 
@@ -174,6 +159,7 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
     while (!feof(handle->fptr)) {
         // read a line
         if (fgets(line, 256, handle->fptr) == NULL && !feof(handle->fptr)) {return NULL;}
+        countPassLine();
         
         if (!hasReadHeader) {
             if (!isValidConfigEnding(line, strlen(line), 1)) {
@@ -187,10 +173,7 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
                 memcpy(header, line + i, j - i);
                 header[j - i] = '\0';
                 if (strcmp(header, "MEMORY")) {
-                    char* errorStr = (char*)malloc(23 * sizeof(char));
-                    sprintf(errorStr, "Expected MEMORY header");
-                    ErrorData errorData = {errorStr, *curLine, 0, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_MEMORY_HEADER, 0, NULL, NULL, *curLine, 0, 1, handle);
                     return parses;
                 }
                 hasReadHeader = 1;
@@ -204,10 +187,7 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
 
                 // trailing garbage check
                 if (!isValidConfigEnding(line + j, strlen(line + j), 1)) {
-                    char* errorStr = (char*)malloc(28 * sizeof(char));
-                    sprintf(errorStr, "Unexpected trailing garbage");
-                    ErrorData errorData = {errorStr, *curLine, j, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, j, 1, handle);
                 }
             }
         }
@@ -220,10 +200,7 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
 
                 // trailing garbage check
                 if (!isValidConfigEnding(line + i, strlen(line + i), 1)) {
-                    char* errorStr = (char*)malloc(28 * sizeof(char));
-                    sprintf(errorStr, "Unexpected trailing garbage");
-                    ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, i, 1, handle);
                 } 
             }
         } else if (!isValidConfigEnding(line, strlen(line), 1)) {
@@ -231,10 +208,7 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
             int wsc = countWhitespaceChars(line, strlen(line));
             if (line[wsc] == '}') {
                 if (!isValidConfigEnding(line + wsc + 1, strlen(line + wsc + 1), 1)) {
-                    char* errorStr = (char*)malloc(28 * sizeof(char));
-                    sprintf(errorStr, "Unexpected trailing garbage");
-                    ErrorData errorData = {errorStr, *curLine, wsc, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, wsc, 1, handle);
                 }
                 return parses;
             }
@@ -247,19 +221,13 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
             char* nameptr = line + wsc;
             char* memoryName = extractVar(&nameptr, strlen(nameptr));
             if (memoryName == NULL) {
-                char* errorStr = (char*)malloc(20 * sizeof(char));
-                sprintf(errorStr, "Expected identifier");
-                ErrorData errorData = {errorStr, *curLine, 0, 1, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *curLine, 0, 1, handle);
                 (*curLine)++;
                 continue;
             }
             wsc = countWhitespaceChars(nameptr, strlen(nameptr));
             if (nameptr[wsc] != ':') {
-                char* errorStr = (char*)malloc(11 * sizeof(char));
-                sprintf(errorStr, "Expected :");
-                ErrorData errorData = {errorStr, *curLine, (nameptr - line), 1, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                appendError(errorList, ERR_EXPECTED_COLON, 0, NULL, NULL, *curLine, (nameptr - line), 1, handle);
                 free(memoryName);
                 (*curLine)++;
                 continue;
@@ -274,11 +242,7 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
                 }
             }
             if (eqName != NULL) {
-                char* errorStr = (char*)malloc((24 + strlen(segDef.name)));
-                sprintf(errorStr, "Repeat definition of %s", segDef.name);
-                ErrorData errorData = {errorStr, *curLine, (nameptr - line - strlen(segDef.name)), strlen(segDef.name), handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
-                free(memoryName);
+                appendError(errorList, ERR_REPEAT_ENTRY, 0, NULL, segDef.name, *curLine, (nameptr - line - strlen(segDef.name)), strlen(segDef.name), handle);
                 (*curLine)++;
                 continue;
             }
@@ -293,30 +257,18 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
                 if (line[i] == ';') {
                     // garbage error 
                     if (!isValidConfigEnding(line + i + 1, strlen(line + i + 1), 1)) {
-                        char* errorStr = (char*)malloc(28 * sizeof(char));
-                        sprintf(errorStr, "Unexpected trailing garbage");
-                        ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, i, 1, handle);
                     }
 
                     // missing data errors
                     if (!segData.readStart) {
-                        char* errorStr = (char*)malloc(26 * sizeof(char));
-                        sprintf(errorStr, "Expected start definition");
-                        ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_EXPECTED_START, 0, NULL, NULL, *curLine, i, 1, handle);
                     }
                     if (!segData.readSize) {
-                        char* errorStr = (char*)malloc(25 * sizeof(char));
-                        sprintf(errorStr, "Expected size definition");
-                        ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_EXPECTED_SIZE, 0, NULL, NULL, *curLine, i, 1, handle);
                     }
                     if (!segData.readType) {
-                        char* errorStr = (char*)malloc(25 * sizeof(char));
-                        sprintf(errorStr, "Expected type definition");
-                        ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_EXPECTED_TYPE, 0, NULL, NULL, *curLine, i, 1, handle);
                     }
                     break;
                 }
@@ -336,10 +288,7 @@ List* readMemory(FileHandle* handle, List* errorList, unsigned int* curLine) {
     }
     
     // did not read the memory block
-    char* errorStr = (char*)malloc(28 * sizeof(char));
-    sprintf(errorStr, "Could not read MEMORY block");
-    ErrorData errorData = {errorStr, *curLine, 0, 1, handle};
-    appendList(errorList, &errorData, sizeof(ErrorData));
+    appendError(errorList, ERR_MEMORY_BLOCK, 0, NULL, NULL, *curLine, 0, 1, handle);
     return parses;
 }
 
@@ -365,10 +314,7 @@ unsigned int readSegmentAttribute(FileHandle* handle, List* errorList, char* lin
         if (!((line[j] >= 'a' && line[j] <= 'z') || line[j] >= 'A' && line[j] <= 'Z')) {break;}
     }
     if (j == i) {
-        char* errorStr = (char*)malloc(26 * sizeof(char));
-        sprintf(errorStr, "Expected memory attribute");
-        ErrorData errorData = {errorStr, curLine, curCol, 1, handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_EXPECTED_ATTRIBUTE, 0, NULL, NULL, curLine, curCol, 1, handle);
         return 0;
     }
     char attrName[j - i + 1];
@@ -378,10 +324,7 @@ unsigned int readSegmentAttribute(FileHandle* handle, List* errorList, char* lin
     // read '='
     int k = countWhitespaceChars(line + j, strlen(line + j)) + j;
     if (line[k] != '=') {
-        char* errorStr = (char*)malloc(11 * sizeof(char));
-        sprintf(errorStr, "Expected =");
-        ErrorData errorData = {errorStr, curLine, curCol + j, 1, handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_EXPECTED_EQUALS, 0, NULL, NULL, curLine, curCol + j, 1, handle);
         return 0;
     }
 
@@ -399,8 +342,7 @@ unsigned int readSegmentAttribute(FileHandle* handle, List* errorList, char* lin
     if (!strcmp(attrName, "align")) {
         ExprErrorShort exprOut = evalShortExpr(expr, l - k, nullST, nullST);
         if (exprOut.errorMessage != NULL) {
-            ErrorData errorData = {exprOut.errorMessage, curLine, curCol + k + 1 + exprOut.errorPos, exprOut.errorLen, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, curLine, curCol + k + 1 + exprOut.errorPos, exprOut.errorLen, handle);
             return 0;
         }
         val = exprOut.val ? exprOut.val : 1;
@@ -432,10 +374,7 @@ unsigned int readSegmentAttribute(FileHandle* handle, List* errorList, char* lin
             }
         }
         if (memptr == NULL) {
-            char* errorStr = (char*)malloc((33 + strlen(loc)) * sizeof(char));
-            sprintf(errorStr, "Unrecognized memory location: %s", loc);
-            ErrorData errorData = {errorStr, curLine, curCol + k + m + 1, n - m, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MEMORY_LOCATION, 0, NULL, (char*)memcpy(malloc(strlen(loc) + 1), loc, strlen(loc) + 1), curLine, curCol + k + m + 1, n - m, handle);
             return 0;
         }
         segment->startAddr = memptr->startAddr;
@@ -444,10 +383,7 @@ unsigned int readSegmentAttribute(FileHandle* handle, List* errorList, char* lin
 
         // check for trailing garbage
         if (!isValidConfigEnding(line + k + n + 1, strlen(line + k + n + 1), 0)) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, curLine, curCol + k + n + 1, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, curLine, curCol + k + n + 1, 1, handle);
             return 0;
         }
 
@@ -469,19 +405,13 @@ unsigned int readSegmentAttribute(FileHandle* handle, List* errorList, char* lin
         if (!strcmp(type, "yes")) {segment->fill = 1;}
         else if (!strcmp(type, "no")) {segment->fill = 0;}
         else {
-            char* errorStr = (char*)malloc((29 + strlen(type)) * sizeof(char));
-            sprintf(errorStr, "Unrecognized fill option: %s", type);
-            ErrorData errorData = {errorStr, curLine, curCol + k + m + 1, n - m, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_FILL_OPTION, 0, NULL, (char*)memcpy(malloc(strlen(type) + 1), type, strlen(type) + 1), curLine, curCol + k + m + 1, n - m, handle);
             return 0;
         }
 
         // check for trailing garbage
         if (!isValidConfigEnding(line + k + n + 1, strlen(line + k + n + 1), 0)) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, curLine, curCol + k + n + 1, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, curLine, curCol + k + n + 1, 1, handle);
             return 0;
         }
 
@@ -490,17 +420,11 @@ unsigned int readSegmentAttribute(FileHandle* handle, List* errorList, char* lin
         segmentData->readAlign = 1;
         segment->align = val;
     } else {
-        char* errorStr = (char*)malloc((27 + strlen(attrName)) * sizeof(char));
-        sprintf(errorStr, "Unrecognized attribute: %s", attrName);
-        ErrorData errorData = {errorStr, curLine, curCol + i, strlen(attrName), handle};
-        appendList(errorList, &errorData, sizeof(errorData));
+        appendError(errorList, ERR_UNKNOWN_ATTRIBUTE, 0, NULL, (char*)memcpy(malloc(strlen(attrName) + 1), attrName, strlen(attrName) + 1), curLine, curCol + i, strlen(attrName), handle);
         return 0;
     }
     if (hasRepeat) {
-        char* errorStr = (char*)malloc((27 + strlen(attrName)) * sizeof(char));
-        sprintf(errorStr, "Redeclaration of value: %s", attrName);
-        ErrorData errorData = {errorStr, curLine, curCol + i, strlen(attrName), handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_REDECLARATION, 0, NULL, (char*)memcpy(malloc(strlen(attrName) + 1), attrName, strlen(attrName) + 1), curLine, curCol + i, strlen(attrName), handle);
         return 0;
     }
 
@@ -525,6 +449,7 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
     while (!feof(handle->fptr)) {
         // read a line
         if (fgets(line, 256, handle->fptr) == NULL && !feof(handle->fptr)) {return NULL;}
+        countPassLine();
 
         if (!hasReadHeader) {
             if (!isValidConfigEnding(line, strlen(line), 1)) {
@@ -538,10 +463,7 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
                 memcpy(header, line + i, j - i);
                 header[j - i] = '\0';
                 if (strcmp(header, "SEGMENTS")) {
-                    char* errorStr = (char*)malloc(25 * sizeof(char));
-                    sprintf(errorStr, "Expected SEGMENTS header");
-                    ErrorData errorData = {errorStr, *curLine, 0, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_SEGMENTS_HEADER, 0, NULL, NULL, *curLine, 0, 1, handle);
                     return parses;
                 }
                 hasReadHeader = 1;
@@ -555,10 +477,7 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
 
                 // trailing garbage check
                 if (!isValidConfigEnding(line + j, strlen(line + j), 1)) {
-                    char* errorStr = (char*)malloc(28 * sizeof(char));
-                    sprintf(errorStr, "Unexpected trailing garbage");
-                    ErrorData errorData = {errorStr, *curLine, j, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, j, 1, handle);
                 }
             }
         } else if (!isInScope) {
@@ -570,10 +489,7 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
 
                 // trailing garbage check
                 if (!isValidConfigEnding(line + i, strlen(line + i), 1)) {
-                    char* errorStr = (char*)malloc(28 * sizeof(char));
-                    sprintf(errorStr, "Unexpected trailing garbage");
-                    ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, i, 1, handle);
                 } 
             }
         } else if (!isValidConfigEnding(line, strlen(line), 1)) {
@@ -581,10 +497,7 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
             int wsc = countWhitespaceChars(line, strlen(line));
             if (line[wsc] == '}') {
                 if (!isValidConfigEnding(line + wsc + 1, strlen(line + wsc + 1), 1)) {
-                    char* errorStr = (char*)malloc(28 * sizeof(char));
-                    sprintf(errorStr, "Unexpected trailing garbage");
-                    ErrorData errorData = {errorStr, *curLine, wsc, 1, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, wsc, 1, handle);
                 }
                 return parses;
             }
@@ -597,19 +510,13 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
             char* nameptr = line + wsc;
             char* segmentName = extractVar(&nameptr, strlen(nameptr));
             if (segmentName == NULL) {
-                char* errorStr = (char*)malloc(20 * sizeof(char));
-                sprintf(errorStr, "Expected identifier");
-                ErrorData errorData = {errorStr, *curLine, 0, 1, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *curLine, 0, 1, handle);
                 (*curLine)++;
                 continue;
             }
             wsc = countWhitespaceChars(nameptr, strlen(nameptr));
             if (nameptr[wsc] != ':') {
-                char* errorStr = (char*)malloc(11 * sizeof(char));
-                sprintf(errorStr, "Expected :");
-                ErrorData errorData = {errorStr, *curLine, (nameptr - line), 1, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                appendError(errorList, ERR_EXPECTED_COLON, 0, NULL, NULL, *curLine, (nameptr - line), 1, handle);
                 free(segmentName);
                 (*curLine)++;
                 continue;
@@ -624,11 +531,7 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
                 }
             }
             if (eqName != NULL) {
-                char* errorStr = (char*)malloc((24 + strlen(segDef.name)));
-                sprintf(errorStr, "Repeat definition of %s", segDef.name);
-                ErrorData errorData = {errorStr, *curLine, (nameptr - line - strlen(segDef.name)), strlen(segDef.name), handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
-                free(segmentName);
+                appendError(errorList, ERR_REPEAT_ENTRY, 0, NULL, segDef.name, *curLine, (nameptr - line - strlen(segDef.name)), strlen(segDef.name), handle);
                 (*curLine)++;
                 continue;
             }
@@ -643,18 +546,12 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
                 if (line[i] == ';') {
                     // garbage error 
                     if (!isValidConfigEnding(line + i + 1, strlen(line + i + 1), 1)) {
-                        char* errorStr = (char*)malloc(28 * sizeof(char));
-                        sprintf(errorStr, "Unexpected trailing garbage");
-                        ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, i, 1, handle);
                     }
 
                     // missing data errors
                     if (!segData.readLoad) {
-                        char* errorStr = (char*)malloc(25 * sizeof(char));
-                        sprintf(errorStr, "Expected load definition");
-                        ErrorData errorData = {errorStr, *curLine, i, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_EXPECTED_LOAD, 0, NULL, NULL, *curLine, i, 1, handle);
                     }
                     break;
                 }
@@ -674,22 +571,267 @@ List* readSegment(FileHandle* handle, List* errorList, List* memoryList, unsigne
     }
 
     // did not read the segments block
-    char* errorStr = (char*)malloc(30 * sizeof(char));
-    sprintf(errorStr, "Could not read SEGMENTS block");
-    ErrorData errorData = {errorStr, *curLine, 0, 1, handle};
-    appendList(errorList, &errorData, sizeof(ErrorData));
+    appendError(errorList, ERR_SEGMENTS_BLOCK, 0, NULL, NULL, *curLine, 0, 1, handle);
     return parses;
 }
 
+/*
+read one attribute for a bank definition
+
+handle: file handle
+errorList: list of errors
+line: line to read from
+curLine: current line count
+curCol: start column
+bank: bank to update
+bankData: parse data for the bank
+nullST: null string table (avoid malloc)
+
+returns: number of chars read
+*/
+unsigned int readBankAttribute(FileHandle* handle, List* errorList, char* line, int curLine, int curCol, BankDef* bank, BankParseData* bankData, StringTable nullST) {
+    // read the attribute name
+    unsigned int i = countWhitespaceChars(line, strlen(line));
+    unsigned int j;
+    for (j = i; j < strlen(line); j++) {
+        if (!((line[j] >= 'a' && line[j] <= 'z') || line[j] >= 'A' && line[j] <= 'Z')) {break;}
+    }
+    if (j == i) {
+        appendError(errorList, ERR_EXPECTED_ATTRIBUTE, 0, NULL, NULL, curLine, curCol, 1, handle);
+        return 0;
+    }
+    char attrName[j - i + 1];
+    memcpy(attrName, line + i, j - i);
+    attrName[j - i] = '\0';
+
+    // read '='
+    int k = countWhitespaceChars(line + j, strlen(line + j)) + j;
+    if (line[k] != '=') {
+        appendError(errorList, ERR_EXPECTED_EQUALS, 0, NULL, NULL, curLine, curCol + j, 1, handle);
+        return 0;
+    }
+
+    // extract expression
+    int l;
+    for (l = k + 1; l < strlen(line); l++) {
+        if (line[l] == ',' || line[l] == ';' || line[l] == '\n') {break;}
+    }
+    char expr[l - k];
+    memcpy(expr, line + k + 1, l - k - 1);
+    expr[l - k - 1] = '\0';
+
+    // every bank attribute is a number
+    ExprErrorShort exprOut = evalShortExpr(expr, l - k, nullST, nullST);
+    if (exprOut.errorMessage != NULL) {
+        appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, curLine, curCol + k + 1 + exprOut.errorPos, exprOut.errorLen, handle);
+        return 0;
+    }
+    uint16_t val = exprOut.val;
+
+    // set the attribute
+    char hasRepeat = 0;
+    if (!strcmp(attrName, "start")) {
+        if (bankData->readStart) {hasRepeat = 1;}
+        bankData->readStart = 1;
+        bank->startAddr = val;
+    } else if (!strcmp(attrName, "width")) {
+        if (bankData->readWidth) {hasRepeat = 1;}
+        bankData->readWidth = 1;
+        bank->width = val;
+    } else if (!strcmp(attrName, "depth")) {
+        if (bankData->readDepth) {hasRepeat = 1;}
+        bankData->readDepth = 1;
+        bank->depth = val;
+    } else if (!strcmp(attrName, "count")) {
+        if (bankData->readCount) {hasRepeat = 1;}
+        bankData->readCount = 1;
+        bank->count = val;
+    } else if (!strcmp(attrName, "lanes")) {
+        if (bankData->readLanes) {hasRepeat = 1;}
+        bankData->readLanes = 1;
+        bank->lanes = val;
+    } else {
+        appendError(errorList, ERR_UNKNOWN_ATTRIBUTE, 0, NULL, (char*)memcpy(malloc(strlen(attrName) + 1), attrName, strlen(attrName) + 1), curLine, curCol + i, strlen(attrName), handle);
+        return 0;
+    }
+    if (hasRepeat) {
+        appendError(errorList, ERR_REDECLARATION, 0, NULL, (char*)memcpy(malloc(strlen(attrName) + 1), attrName, strlen(attrName) + 1), curLine, curCol + i, strlen(attrName), handle);
+        return 0;
+    }
+
+    return l;
+}
+
+/*
+read the optional bank information
+
+handle: file handle
+errorList: list of errors
+bankList: list to add the banks to
+curLine: current line count
+*/
+void readBanks(FileHandle* handle, List* errorList, List* bankList, unsigned int* curLine) {
+    long curPos;
+    StringTable nullST = newStringTable();
+    char isInScope = 0;
+    char hasReadHeader = 0;
+    char line[256];
+    while (!feof(handle->fptr)) {
+        // read a line
+        if (fgets(line, 256, handle->fptr) == NULL) {break;}
+        countPassLine();
+
+        if (!hasReadHeader) {
+            if (!isValidConfigEnding(line, strlen(line), 1)) {
+                // read BANKS
+                int i = countWhitespaceChars(line, strlen(line));
+                int j;
+                for (j = i; j < strlen(line); j++) {
+                    if (!((line[j] >= 'a' && line[j] <= 'z') || (line[j] >= 'A' && line[j] <= 'Z'))) {break;}
+                }
+                char header[j - i + 1];
+                memcpy(header, line + i, j - i);
+                header[j - i] = '\0';
+                if (strcmp(header, "BANKS")) {
+                    appendError(errorList, ERR_BANKS_HEADER, 0, NULL, NULL, *curLine, 0, 1, handle);
+                    deleteStringTable(nullST);
+                    return;
+                }
+                hasReadHeader = 1;
+
+                // check for {
+                i = j + countWhitespaceChars(line + j, strlen(line + j));
+                if (line[i] == '{') {
+                    isInScope = 1;
+                    j = i + 1;
+                }
+
+                // trailing garbage check
+                if (!isValidConfigEnding(line + j, strlen(line + j), 1)) {
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, j, 1, handle);
+                }
+            }
+        } else if (!isInScope) {
+            // check for '{'
+            if (!isValidConfigEnding(line, strlen(line), 1)) {
+                // check for {
+                int i = countWhitespaceChars(line, strlen(line));
+                if (line[i] == '{') {isInScope = 1; i++;}
+
+                // trailing garbage check
+                if (!isValidConfigEnding(line + i, strlen(line + i), 1)) {
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, i, 1, handle);
+                }
+            }
+        } else if (!isValidConfigEnding(line, strlen(line), 1)) {
+            // check for }
+            int wsc = countWhitespaceChars(line, strlen(line));
+            if (line[wsc] == '}') {
+                if (!isValidConfigEnding(line + wsc + 1, strlen(line + wsc + 1), 1)) {
+                    appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, wsc, 1, handle);
+                }
+                deleteStringTable(nullST);
+                return;
+            }
+
+            // setup
+            BankParseData bankData = {0, 0, 0, 0, 0};
+            BankDef bankDef = NEW_BANK;
+
+            // read the bank name
+            char* nameptr = line + wsc;
+            char* bankName = extractVar(&nameptr, strlen(nameptr));
+            if (bankName == NULL) {
+                appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *curLine, 0, 1, handle);
+                (*curLine)++;
+                continue;
+            }
+            wsc = countWhitespaceChars(nameptr, strlen(nameptr));
+            if (nameptr[wsc] != ':') {
+                appendError(errorList, ERR_EXPECTED_COLON, 0, NULL, NULL, *curLine, (nameptr - line), 1, handle);
+                free(bankName);
+                (*curLine)++;
+                continue;
+            }
+            bankDef.name = bankName;
+
+            // check for repeats
+            BankDef* eqName = NULL;
+            for (Node* node = bankList->head; node != NULL; node = node->next) {
+                if (!strcmp(((BankDef*)(node->dataptr))->name, bankDef.name)) {
+                    eqName = (BankDef*)(node->dataptr);
+                }
+            }
+            if (eqName != NULL) {
+                appendError(errorList, ERR_REPEAT_ENTRY, 0, NULL, bankDef.name, *curLine, (nameptr - line - strlen(bankDef.name)), strlen(bankDef.name), handle);
+                (*curLine)++;
+                continue;
+            }
+
+            // read the bank attributes
+            int i = (nameptr - line) + wsc + 1;
+            while (i < 256) {
+                int j = readBankAttribute(handle, errorList, line + i, *curLine, i, &bankDef, &bankData, nullST);
+                if (j == 0) {break;}
+                i += j;
+                if (line[i] == ',') {i++; continue;}
+                if (line[i] == ';') {
+                    // garbage error
+                    if (!isValidConfigEnding(line + i + 1, strlen(line + i + 1), 1)) {
+                        appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *curLine, i, 1, handle);
+                    }
+
+                    // missing data errors
+                    if (!bankData.readWidth) {
+                        appendError(errorList, ERR_EXPECTED_WIDTH, 0, NULL, NULL, *curLine, i, 1, handle);
+                    }
+                    if (!bankData.readDepth) {
+                        appendError(errorList, ERR_EXPECTED_DEPTH, 0, NULL, NULL, *curLine, i, 1, handle);
+                    }
+                    if (!bankData.readWidth || !bankData.readDepth) {break;}
+
+                    // geometry errors, every lane holds whole bytes
+                    if (bankDef.width == 0 || bankDef.width % 8 || bankDef.width > BANK_MAX_WIDTH) {
+                        appendError(errorList, ERR_BANK_WIDTH, 0, NULL, NULL, *curLine, i, 1, handle);
+                    } else if (bankDef.lanes == 0 || (bankDef.width / 8) % bankDef.lanes) {
+                        appendError(errorList, ERR_BANK_LANES, 0, NULL, NULL, *curLine, i, 1, handle);
+                    } else if (bankDef.depth == 0 || bankDef.count == 0 || (uint32_t)bankDef.count * bankDef.depth * (bankDef.width / 8) > BANK_MAX_BYTES) {
+                        appendError(errorList, ERR_BANK_SIZE, 0, NULL, NULL, *curLine, i, 1, handle);
+                    }
+                    break;
+                }
+            }
+
+            // save the bank
+            appendList(bankList, &bankDef, sizeof(BankDef));
+        }
+
+        // handle "troll" line
+        curPos = ftell(handle->fptr);
+        if (!feof(handle->fptr) && curPos == handle->length) {
+            if (fgets(line, 256, handle->fptr) == NULL && !feof(handle->fptr)) {break;}
+        }
+
+        (*curLine)++;
+    }
+    deleteStringTable(nullST);
+
+    // the block is optional, but once started it has to be closed
+    if (hasReadHeader) {
+        appendError(errorList, ERR_BANKS_BLOCK, 0, NULL, NULL, *curLine, 0, 1, handle);
+    }
+}
+
 /*
 reads a configuration file
 
 handle: file handle
 errorList: list of errors
+bankList: list to add the banks to, empty if there is no BANKS block
 
 returns: configuration segment information
 */
-List* readConfigFile(FileHandle* handle, List* errorList) {
+List* readConfigFile(FileHandle* handle, List* errorList, List* bankList) {
     // read the memory attributes
     unsigned int curLine = 0;
     List* memData = readMemory(handle, errorList, &curLine);
@@ -699,17 +841,24 @@ List* readConfigFile(FileHandle* handle, List* errorList) {
     curLine++;
     List* segData = readSegment(handle, errorList, memData, &curLine);
 
+    // read the bank geometry
+    if (errorList->size == 0) {
+        curLine++;
+        readBanks(handle, errorList, bankList, &curLine);
+    }
+
     // make sure the rest of the file is clear
     curLine++;
     while (!feof(handle->fptr)) {
         char buffer[256];
 
-        if (fgets(buffer, 256, handle->fptr) == NULL && !feof(handle->fptr)) {return NULL;}
+        // the last read can hit the end of the file without reading a line
+        if (fgets(buffer, 256, handle->fptr) == NULL) {
+            if (!feof(handle->fptr)) {return NULL;}
+            break;
+        }
         if (!isValidConfigEnding(buffer, strlen(buffer), 1)) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, curLine, 0, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, curLine, 0, 1, handle);
         }
 
         curLine++;
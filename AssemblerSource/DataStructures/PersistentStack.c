@@ -0,0 +1,119 @@
+/*
+stack of immutable, reference counted frames
+copies share every frame, so a snapshot costs a pointer copy
+
+Written by Adam Billings
+*/
+
+#include "DataStructures/PersistentStack.h"
+
+/*
+drops one reference to a frame, freeing the chain while nothing else uses it
+
+frame: frame to release
+*/
+static void releaseFrame(StackFrame* frame) {
+    while (frame != NULL && --(frame->refCount) == 0) {
+        StackFrame* next = frame->next;
+        free(frame->dataptr);
+        free(frame);
+        frame = next;
+    }
+}
+
+/*
+create an empty persistent stack
+
+returns: empty stack
+*/
+PersistentStack* newPersistentStack() {
+    PersistentStack* stack = (PersistentStack*)malloc(sizeof(PersistentStack));
+    stack->head = NULL;
+    stack->size = 0;
+    return stack;
+}
+
+/*
+releases a stack, freeing the frames no other stack uses
+
+stack: stack to free
+
+returns: NULL
+*/
+PersistentStack* deletePersistentStack(PersistentStack* stack) {
+    releaseFrame(stack->head);
+    free(stack);
+    return NULL;
+}
+
+/*
+creates a stack sharing all frames of another stack
+
+stack: stack to copy
+
+returns: new stack with the same contents
+*/
+PersistentStack* copyPersistentStack(PersistentStack* stack) {
+    PersistentStack* copy = (PersistentStack*)malloc(sizeof(PersistentStack));
+    copy->head = stack->head;
+    copy->size = stack->size;
+    if (copy->head != NULL) {(copy->head->refCount)++;}
+    return copy;
+}
+
+/*
+pushes an element to a stack
+
+stack: stack to modify
+dataptr: pointer to data
+dataSize: size of data (in bytes)
+*/
+void pushPersistentStack(PersistentStack* stack, const void* dataptr, size_t dataSize) {
+    // the new frame takes over the stack's reference to the old head
+    StackFrame* frame = (StackFrame*)malloc(sizeof(StackFrame));
+    frame->next = stack->head;
+    frame->refCount = 1;
+    frame->dataSize = dataSize;
+    frame->dataptr = malloc(dataSize);
+    memcpy(frame->dataptr, dataptr, dataSize);
+    stack->head = frame;
+    (stack->size)++;
+}
+
+/*
+pops an element from a stack (should be freed after use)
+
+stack: stack to pop from
+
+returns: pointer to element data, copied if the frame is shared
+*/
+void* popPersistentStack(PersistentStack* stack) {
+    StackFrame* head = stack->head;
+    if (head == NULL) {return NULL;}
+    stack->head = head->next;
+    (stack->size)--;
+
+    // sole owner, hand over the frame data and its reference to the next frame
+    if (head->refCount == 1) {
+        void* dataptr = head->dataptr;
+        free(head);
+        return dataptr;
+    }
+
+    // shared, leave the frame for the other stacks
+    (head->refCount)--;
+    if (head->next != NULL) {(head->next->refCount)++;}
+    return memcpy(malloc(head->dataSize), head->dataptr, head->dataSize);
+}
+
+/*
+peek at the top element of the stack
+
+stack: stack to peek at
+
+returns: data pointer at the top of the stack
+*/
+void* peekPersistentStack(PersistentStack* stack) {
+    if (stack->head == NULL) {return NULL;}
+    return stack->head->dataptr;
+}
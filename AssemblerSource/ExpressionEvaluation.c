@@ -16,6 +16,11 @@ Written by Adam Billings
 #include "MiscAssembler.h"
 #include "ExpressionEvaluation.h"
 
+// argument frame of the macro being assembled
+static const uint16_t* macroArgs = NULL;
+static int macroArgCount = 0;
+static const char* macroArgsKnown = NULL;
+
 /*
 outputs the precedence of the operator
 
@@ -285,6 +290,19 @@ char* extractVar(char** exprptr, int exprLen) {
     return outputStr;
 }
 
+/*
+sets the argument values that macro parameter markers resolve to
+
+args: values of the active macro's arguments, NULL outside of a macro
+argCount: number of arguments
+known: per argument, if its value is known, NULL when they all are
+*/
+void setMacroArgs(const uint16_t* args, int argCount, const char* known) {
+    macroArgs = args;
+    macroArgCount = (args == NULL) ? 0 : argCount;
+    macroArgsKnown = known;
+}
+
 /*
 Evaluates the expressed short integer expression
 
@@ -320,6 +338,7 @@ ExprErrorShort evalShortExpr(char* expr, int exprLen, StringTable varTable, Stri
             parseType = chr;
             i++;
         } else if (charIsName(expr[i])) {parseType = var;}
+        else if ((unsigned char)expr[i] >= MACRO_SLOT_MARKER && (unsigned char)expr[i] < MACRO_SLOT_MARKER + MACRO_SLOT_COUNT) {parseType = slot;}
         else if ((expr[i] & 0x80) || expr[i] < 0 || getPrec(expr[i]) < 0) {
             // return an error
             char* errorStr = (char*)malloc(23 * sizeof(char));
@@ -347,6 +366,7 @@ ExprErrorShort evalShortExpr(char* expr, int exprLen, StringTable varTable, Stri
         char chrParseLen = 1;
         char chrParseError = 0;
         uint16_t chrParse;
+        int slotIndex;
         switch (parseType) {
             case dec:
                 i = parseUShort(expr, i, 10, valStack);
@@ -421,6 +441,28 @@ ExprErrorShort evalShortExpr(char* expr, int exprLen, StringTable varTable, Stri
                 i += charsExtracted;
                 lastIsOp = 0;
                 break;
+            case slot:
+                slotIndex = (unsigned char)expr[i] - MACRO_SLOT_MARKER;
+                if (slotIndex >= macroArgCount) {
+                    deleteStack(condStack);
+                    deleteStack(opStack);
+                    deleteStack(valStack);
+                    char* errorStr = (char*)malloc(37 * sizeof(char));
+                    sprintf(errorStr, "Macro parameter used outside a call");
+                    return (ExprErrorShort){0, i, 1, errorStr};
+                }
+                if (macroArgsKnown != NULL && !macroArgsKnown[slotIndex]) {
+                    deleteStack(condStack);
+                    deleteStack(opStack);
+                    deleteStack(valStack);
+                    char* errorStr = (char*)malloc(32 * sizeof(char));
+                    sprintf(errorStr, "Macro argument is not known yet");
+                    return (ExprErrorShort){0, i, 1, errorStr};
+                }
+                pushStack(valStack, macroArgs + slotIndex, 2);
+                i++;
+                lastIsOp = 0;
+                break;
             case op:
                 // get the operation
                 opParse = expr[i];
@@ -11,6 +11,11 @@ Written by Adam Billings
 #include "ExpressionEvaluation.h"
 #include "DataStructures/StringTable.h"
 #include "DataStructures/Stack.h"
+#include "DataStructures/PersistentStack.h"
+#include "SourceIndex.h"
+#include "PassTimer.h"
+#include "TraceEvents.h"
+#include "AssemblerStats.h"
 #include "GeneralMacros.h"
 
 /*
@@ -168,8 +173,169 @@ FileHandle* getHandle(List* handleList, char* name, char isBin) {
     return NULL;
 }
 
+/*
+determines if a character can be in an operand name
+
+c: character to evaluate
+
+returns: if the character can be in an operand name
+*/
+static char isOperandChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '@';
+}
+
+/*
+replaces macro parameter names in an operand list with slot markers
+
+operands: text to rewrite in place
+length: length of the text
+params: names of the macro parameters
+*/
+static void bindParamOperands(char* operands, int length, List* params) {
+    int i = 0;
+    while (i < length && operands[i] != ';') {
+        char c = operands[i];
+        if (c == '\"' || c == '\'') {
+            // skip string and character literals
+            for (i++; i < length && operands[i] != c; i++) {
+                if (operands[i] == '\\') {i++;}
+            }
+            i++;
+        } else if (isOperandChar(c)) {
+            int start = i;
+            while (i < length && isOperandChar(operands[i])) {i++;}
+
+            // numbers and local labels are never parameters
+            if ((c >= '0' && c <= '9') || c == '@') {continue;}
+            if (start > 0 && (operands[start - 1] == '$' || operands[start - 1] == '%')) {continue;}
+
+            // swap the name for its slot, padding to keep the columns
+            int slot = 0;
+            for (Node* node = params->head; node != NULL && slot < MACRO_SLOT_COUNT; node = node->next) {
+                char* name = *(char**)(node->dataptr);
+                if (strlen(name) == i - start && !strncmp(name, operands + start, i - start)) {
+                    operands[start] = (char)(MACRO_SLOT_MARKER + slot);
+                    memset(operands + start + 1, ' ', i - start - 1);
+                    break;
+                }
+                slot++;
+            }
+        } else {i++;}
+    }
+}
+
+/*
+replaces macro parameter names on one line of a macro body with slot markers
+only instruction operands, .word/.byte data, .rept counts and assignments are bound
+
+line: line to rewrite in place
+length: length of the line
+params: names of the macro parameters
+*/
+static void bindParamLine(char* line, int length, List* params) {
+    int i = 0;
+
+    // handle labels and assignments
+    if (length > 0 && !isspace(line[0]) && line[0] != '.' && line[0] != ';') {
+        while (i < length && isOperandChar(line[i])) {i++;}
+        if (i < length && line[i] == ':') {i++;}
+        else {
+            while (i < length && isspace(line[i])) {i++;}
+            if (i < length && line[i] == '=') {bindParamOperands(line + i + 1, length - i - 1, params);}
+            return;
+        }
+    }
+    while (i < length && isspace(line[i])) {i++;}
+    if (i == length || line[i] == ';') {return;}
+
+    // only data macros take parameters
+    if (line[i] == '.') {
+        char* afterName;
+        char* name = extractMacro(line + i, length - i, &afterName);
+        if (!strcmp(name, ".word") || !strcmp(name, ".byte")) {
+            bindParamOperands(afterName, length - (afterName - line), params);
+        } else if (!strcmp(name, ".rept")) {
+            // the counter after the count is a new name
+            int countLength = 0;
+            while (countLength < length - (afterName - line) && afterName[countLength] != ',') {countLength++;}
+            bindParamOperands(afterName, countLength, params);
+        }
+        free(name);
+        return;
+    }
+
+    // skip the instruction or macro name
+    while (i < length && isOperandChar(line[i])) {i++;}
+    bindParamOperands(line + i, length - i, params);
+}
+
+/*
+captures a macro body into an in-memory stream so invocations do not reread the source file
+
+handle: file the macro is defined in
+handleList: list of open handles, the body handle is added to it
+params: names of the macro parameters to bind to slots, NULL for none
+start: file position of the first line of the body
+end: file position after the .endmacro line
+
+returns: handle to the captured body, NULL if it could not be captured
+*/
+FileHandle* captureMacroBody(FileHandle* handle, List* handleList, List* params, long start, long end) {
+    // read the body
+    long restorePoint = ftell(handle->fptr);
+    long length = end - start;
+    char* text = (char*)malloc((length + 1) * sizeof(char));
+    fseek(handle->fptr, start, SEEK_SET);
+    length = fread(text, 1, length, handle->fptr);
+    fseek(handle->fptr, restorePoint, SEEK_SET);
+
+    // bind the parameters line by line
+    if (params != NULL) {
+        long lineStart = 0;
+        for (long j = 0; j <= length; j++) {
+            if (j == length || text[j] == '\n') {
+                bindParamLine(text + lineStart, j - lineStart, params);
+                lineStart = j + 1;
+            }
+        }
+    }
+
+    // copy it to a stream owning its buffer
+    FILE* stream = fmemopen(NULL, length + 1, "w+");
+    if (stream == NULL) {free(text); return NULL;}
+    fwrite(text, 1, length, stream);
+    rewind(stream);
+    free(text);
+
+    // register the handle so it is closed with the others
+    char* name = (char*)malloc((strlen(handle->name) + 1) * sizeof(char));
+    strcpy(name, handle->name);
+    FileHandle bodyHandle = {stream, name, length, 2, handle->source != NULL ? handle->source : handle};
+    appendList(handleList, &bodyHandle, sizeof(FileHandle));
+    return (FileHandle*)indexList(handleList, -1);
+}
+
+/*
+moves reading to the first line of a macro body
+
+macroData: macro to enter
+
+returns: handle to read the body from
+*/
+FileHandle* enterMacroBody(MacroDefData* macroData) {
+    if (macroData->body == NULL) {
+        countPassRewind(macroData->handle->fptr, macroData->start);
+        fseek(macroData->handle->fptr, macroData->start, SEEK_SET);
+        return macroData->handle;
+    }
+    countPassRewind(macroData->body->fptr, 0);
+    rewind(macroData->body->fptr);
+    return macroData->body;
+}
+
 /*
 reads to the end of an if statement
+the destination is recorded on the handle so later skips of the same block jump straight to it
 
 handle: handle to the file
 errorList: list of errors
@@ -179,62 +345,78 @@ allowElse: if .else and .elseif macros are allowed
 returns: end line to the if statement
 */
 char* skipIf(FileHandle* handle, List* errorList, PosData* ifData, char allowElse) {
+    // jump if the block was skipped before
+    char key[24];
+    sprintf(key, "%ld%c", ftell(handle->fptr), allowElse ? 'e' : 'n');
+    if (handle->ifJumps != NULL) {
+        IfJumpData* jump = (IfJumpData*)readStringTable(handle->ifJumps, key, strlen(key) + 1);
+        if (jump != NULL) {
+            fseek(handle->fptr, jump->filePosition, SEEK_SET);
+            if (jump->atEnd) {fgetc(handle->fptr);}
+            ifData->line += jump->lineDelta;
+            countSkippedLines(jump->lineDelta);
+            ifData->col = jump->col;
+            char* out = (char*)malloc((1 + strlen(jump->line)) * sizeof(char));
+            strcpy(out, jump->line);
+            return out;
+        }
+    }
+
     // setup
     char buffer[256];
     int ifCount = 0;
     int startLine = ifData->line;
-    int curLine = ifData->line;
-
-    // read to .endif
-    while (!feof(handle->fptr)) {
-        // get the next line
-        if (fgets(buffer, 256, handle->fptr)== NULL && !feof(handle->fptr)) {return NULL;}
-        
-        // skip spaces
-        int i;
-        for (i = 0; i < 256; i++) {
-            if (!isspace(buffer[i])) {break;}
-        }
-
-        // check for macro
-        if (buffer[i] == '.') {
-            char* nameEnd;
-            char* macroName = extractMacro(buffer + i, (256 - i), &nameEnd);
-            
-            // check for if/endif
-            if (!strcmp(macroName, ".if")) {ifCount++;}
-            else if (!strcmp(macroName, ".ifdef")) {ifCount++;}
-            else if (!strcmp(macroName, ".ifndef")) {ifCount++;}
-            else if (!strcmp(macroName, ".endif") && ifCount == 0) {
-                (ifData->line)++;
-                ifData->col = i;
-                char* out = (char*)malloc((1 + strlen(buffer)) * sizeof(char));
-                sprintf(out, "%s", buffer);
-                return out;
-            } else if (!strcmp(macroName, ".endif")) {ifCount--;}
-            else if ((!strcmp(macroName, ".else") || !strcmp(macroName, ".elseif") || !strcmp(macroName, ".elseifdef") || !strcmp(macroName, ".elseifndef")) && ifCount == 0 && allowElse) {
-                (ifData->line)++;
-                ifData->col = i;
-                char* out = (char*)malloc((1 + strlen(buffer)) * sizeof(char));
-                sprintf(out, "%s", buffer);
-                return out;
-            } else if (!strcmp(macroName, ".elseif") && ifCount == 0 && allowElse) {
-                (ifData->line)++;
-                ifData->col = i;
-                char* out = (char*)malloc((1 + strlen(buffer)) * sizeof(char));
-                sprintf(out, "%s", buffer);
-                return out;
-            }
+    SourceIndex* index = getSourceIndex(handle);
+
+    // walk the line records to .endif
+    for (unsigned int lineIndex = findSourceLine(index, ftell(handle->fptr)); lineIndex < index->count; lineIndex++) {
+        SourceLine* sourceLine = index->lines + lineIndex;
+
+        // check for if/endif
+        char isEnd = 0;
+        switch (sourceLine->directive) {
+            case DIR_IF:
+            case DIR_IFDEF:
+            case DIR_IFNDEF:
+                ifCount++;
+                break;
+            case DIR_ENDIF:
+                if (ifCount == 0) {isEnd = 1;}
+                else {ifCount--;}
+                break;
+            case DIR_ELSE:
+            case DIR_ELSEIF:
+            case DIR_ELSEIFDEF:
+            case DIR_ELSEIFNDEF:
+                if (ifCount == 0 && allowElse) {isEnd = 1;}
+                break;
+            default:
+                break;
         }
 
         (ifData->line)++;
+
+        // read the matching line and record the destination
+        if (isEnd) {
+            fseek(handle->fptr, sourceLine->offset, SEEK_SET);
+            if (fgets(buffer, 256, handle->fptr) == NULL) {return NULL;}
+            ifData->col = sourceLine->indent;
+            IfJumpData jump = {ftell(handle->fptr), ifData->line - startLine, sourceLine->indent, feof(handle->fptr) != 0};
+            strcpy(jump.line, buffer);
+            if (handle->ifJumps == NULL) {handle->ifJumps = newStringTable();}
+            setStringTableValue(handle->ifJumps, key, strlen(key) + 1, &jump, sizeof(IfJumpData));
+            countSkippedLines(jump.lineDelta);
+
+            char* out = (char*)malloc((1 + strlen(buffer)) * sizeof(char));
+            sprintf(out, "%s", buffer);
+            return out;
+        }
     }
+    fseek(handle->fptr, 0, SEEK_END);
+    fgetc(handle->fptr);
 
     // no .endif, push an error
-    char* errorStr = (char*)malloc(16  * sizeof(char));
-    sprintf(errorStr, "Expected .endif");
-    ErrorData errorData = {errorStr, startLine, ifData->col, 1, handle};
-    appendList(errorList, &errorData, sizeof(ErrorData));
+    appendError(errorList, ERR_EXPECTED_ENDIF, 0, NULL, NULL, startLine, ifData->col, 1, handle);
     return NULL;
 }
 
@@ -246,9 +428,10 @@ lineptr: pointer to line to update
 
 returns: pointer to handle to update
 */
-FileHandle* includeReturn(Stack* includeStack, unsigned int* lineptr) {
+FileHandle* includeReturn(PersistentStack* includeStack, unsigned int* lineptr) {
     // pop from the stack
-    IncludeReturnData* retData = (IncludeReturnData*)popStack(includeStack);
+    IncludeReturnData* retData = (IncludeReturnData*)popPersistentStack(includeStack);
+    endTraceEvent();
 
     // set the new line number
     *lineptr = retData->returnLine;
@@ -288,8 +471,7 @@ char macroIf(FileHandle* handle, List* errorList, char* name, char* expr, unsign
         // evaluate the expression
         ExprErrorShort evalOut = evalShortExpr(expr, strlen(expr), defines, defines);
         if (evalOut.errorMessage != NULL) {
-            ErrorData errorData = {evalOut.errorMessage, line, col + evalOut.errorPos, evalOut.errorLen, handle};
-            appendList(errorList, &errorData, sizeof(errorData));
+            appendError(errorList, ERR_MESSAGE, 0, NULL, evalOut.errorMessage, line, col + evalOut.errorPos, evalOut.errorLen, handle);
             return 1;
         }
         return evalOut.val != 0;
@@ -299,19 +481,13 @@ char macroIf(FileHandle* handle, List* errorList, char* name, char* expr, unsign
         unsigned int i = countWhitespaceChars(expr, exprLen);
         char* varName = getVarName(expr + i, exprLen - i, &afterVar);
         if (varName == NULL) {
-            char* errorStr = (char*)malloc(20 * sizeof(char));
-            sprintf(errorStr, "Expected identifier");
-            ErrorData errorData = {errorStr, line, strlen(name) + 1, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, line, strlen(name) + 1, 1, handle);
             return 1;
         }
 
         // ensure no garbage
         if (!isValidLineEnding(afterVar, exprLen - (afterVar - expr))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, line, (afterVar - expr) + col, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, line, (afterVar - expr) + col, 1, handle);
             return 1;
         }
 
@@ -322,6 +498,217 @@ char macroIf(FileHandle* handle, List* errorList, char* name, char* expr, unsign
     } else {return 1;}
 }
 
+/*
+locates the body of a .rept block, capturing it the first time the block is reached
+
+handle: file positioned after the .rept line
+errorList: list of errors
+handleList: list of open handles
+line: line of the .rept
+col: column of the .rept
+argBase: number of argument slots of the enclosing macro call
+counter: name of the iteration counter, NULL for none
+
+returns: block information, NULL if there is no matching .endr
+*/
+static MacroDefData* findRept(FileHandle* handle, List* errorList, List* handleList, unsigned int line, unsigned int col, int argBase, char* counter) {
+    // use the recorded block
+    long start = ftell(handle->fptr);
+    char key[24];
+    sprintf(key, "%ld", start);
+    if (handle->repts != NULL) {
+        MacroDefData* reptData = (MacroDefData*)readStringTable(handle->repts, key, strlen(key) + 1);
+        if (reptData != NULL) {return reptData;}
+    }
+
+    // find the matching .endr
+    SourceIndex* index = getSourceIndex(handle);
+    int depth = 0;
+    unsigned int lines = 0;
+    long end = -1;
+    for (unsigned int lineIndex = findSourceLine(index, start); end < 0 && lineIndex < index->count; lineIndex++) {
+        SourceLine* sourceLine = index->lines + lineIndex;
+        lines++;
+        if (sourceLine->directive == DIR_REPT) {depth++;}
+        else if (sourceLine->directive == DIR_ENDR && depth-- == 0) {end = sourceLine->offset + sourceLine->length;}
+    }
+    if (end < 0) {
+        appendError(errorList, ERR_EXPECTED_ENDR, 0, NULL, NULL, line, col, 5, handle);
+        return NULL;
+    }
+
+    // capture the body with the counter after the enclosing arguments
+    char* noName = "";
+    List* params = newList();
+    for (int i = 0; i < argBase; i++) {appendList(params, &noName, sizeof(char*));}
+    if (counter != NULL) {appendList(params, &counter, sizeof(char*));}
+    FileHandle* body = captureMacroBody(handle, handleList, params, start, end);
+    deleteList(params);
+
+    MacroDefData defData = {handle, start, end, line, lines, NULL, body};
+    if (handle->repts == NULL) {handle->repts = newStringTable();}
+    setStringTableValue(handle->repts, key, strlen(key) + 1, &defData, sizeof(MacroDefData));
+    return (MacroDefData*)readStringTable(handle->repts, key, strlen(key) + 1);
+}
+
+/*
+starts a .rept block, entering its body unless the count is 0
+
+handle: file positioned after the .rept line
+errorList: list of errors
+handleList: list of open handles
+args: text after the directive name
+lineCount: pointer to the current line, moved to the .rept line of the body
+col: column of the .rept
+macroStack: stack of macro returns, the repetition is pushed onto it
+varDefs: defined vars
+defines: current defined vars
+
+returns: handle to continue reading from
+*/
+FileHandle* startRept(FileHandle* handle, List* errorList, List* handleList, char* args, unsigned int* lineCount, unsigned int col, PersistentStack* macroStack, StringTable varDefs, StringTable defines) {
+    // get the count
+    List* argList = extractArgs(args, strlen(args));
+    char* countExpr = *(char**)(argList->head->dataptr);
+    ExprErrorShort exprOut = evalShortExpr(countExpr, strlen(countExpr), varDefs, defines);
+    char* counter = NULL;
+    char hasError = 0;
+    if (exprOut.errorMessage != NULL) {
+        appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, *lineCount, exprOut.errorPos + col + 5, exprOut.errorLen, handle);
+        hasError = 1;
+    }
+
+    // get the counter name
+    if (!hasError && argList->size == 2) {
+        char* counterArg = *(char**)(argList->tail->dataptr);
+        char* afterCounter = counterArg + countWhitespaceChars(counterArg, strlen(counterArg));
+        counter = extractVar(&afterCounter, strlen(afterCounter));
+        if (counter[0] == '\0' || counter[0] == '@' || (counter[0] >= '0' && counter[0] <= '9') || !isValidLineEnding(afterCounter, strlen(afterCounter) + 1)) {
+            appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *lineCount, col + 5 + strlen(countExpr) + 1, strlen(counterArg), handle);
+            hasError = 1;
+        }
+    } else if (!hasError && argList->size > 2) {
+        appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, col, strlen(args) + 5, handle);
+        hasError = 1;
+    }
+    for (Node* node = argList->head; node != NULL; node = node->next) {free(*(char**)(node->dataptr));}
+    deleteList(argList);
+
+    // find the body
+    IncludeReturnData* enclosing = (IncludeReturnData*)peekPersistentStack(macroStack);
+    int argBase = (enclosing != NULL) ? enclosing->argCount : 0;
+    MacroDefData* reptData = findRept(handle, errorList, handleList, *lineCount, col, argBase, counter);
+    free(counter);
+    if (reptData == NULL) {return handle;}
+
+    // skip the block when there is nothing to repeat
+    if (hasError || exprOut.val == 0) {
+        fseek(handle->fptr, reptData->end, SEEK_SET);
+        *lineCount = reptData->line + reptData->lines;
+        return handle;
+    }
+
+    // push the repetition, its counter slot follows the enclosing arguments
+    IncludeReturnData retData = {handle, reptData->end, reptData->line + reptData->lines, errorList->size, NULL, argBase + 1, NULL, reptData, exprOut.val};
+    retData.args = (uint16_t*)calloc(argBase + 1, sizeof(uint16_t));
+    if (enclosing != NULL && enclosing->args != NULL) {memcpy(retData.args, enclosing->args, argBase * sizeof(uint16_t));}
+    if (enclosing != NULL && enclosing->known != NULL) {
+        retData.known = (char*)malloc((argBase + 1) * sizeof(char));
+        memcpy(retData.known, enclosing->known, argBase * sizeof(char));
+        retData.known[argBase] = 1;
+    }
+    pushPersistentStack(macroStack, &retData, sizeof(IncludeReturnData));
+    restoreMacroArgs(macroStack);
+    countMacroDepth(macroStack->size);
+    beginTraceEvent(".rept", "macro", handle, *lineCount);
+
+    // go to the body
+    *lineCount = reptData->line;
+    return enterMacroBody(reptData);
+}
+
+/*
+ends one iteration of a .rept block, rereading the body until the count runs out
+
+handle: file being read
+errorList: list of errors
+lineCount: pointer to the current line
+col: column of the .endr
+macroStack: stack of macro returns
+varDefs: defined vars, the local labels of the block are removed from it once it ends
+
+returns: handle to continue reading from
+*/
+FileHandle* endRept(FileHandle* handle, List* errorList, unsigned int* lineCount, unsigned int col, PersistentStack* macroStack, StringTable varDefs) {
+    IncludeReturnData* retData = (IncludeReturnData*)peekPersistentStack(macroStack);
+    if (retData == NULL || retData->rept == NULL) {
+        appendError(errorList, ERR_EXPECTED_REPT, 0, NULL, NULL, *lineCount, col, 5, handle);
+        return handle;
+    }
+
+    // run the next iteration
+    retData = (IncludeReturnData*)popPersistentStack(macroStack);
+    if (retData->repeatsLeft > 1) {
+        retData->repeatsLeft--;
+        retData->args[retData->argCount - 1]++;
+        pushPersistentStack(macroStack, retData, sizeof(IncludeReturnData));
+        *lineCount = retData->rept->line;
+        FileHandle* body = enterMacroBody(retData->rept);
+        free(retData);
+        return body;
+    }
+
+    // return after the block
+    endTraceEvent();
+    FileHandle* newHandle = retData->returnFile;
+    *lineCount = retData->returnLine;
+    fseek(newHandle->fptr, retData->filePosition, SEEK_SET);
+    free(retData->args);
+    free(retData->known);
+    restoreMacroArgs(macroStack);
+    if (retData->locals != NULL) {
+        for (Node* node = retData->locals->head; node != NULL; node = node->next) {
+            char* name = *(char**)(node->dataptr);
+            removeStringTableValue(varDefs, name, strlen(name) + 1);
+            free(name);
+        }
+        deleteList(retData->locals);
+    }
+
+    if (errorList->size > retData->errorCount) {
+        appendError(errorList, ERR_REPT_TRACE, 0, NULL, NULL, *lineCount, col, 5, newHandle);
+    }
+    free(retData);
+    return newHandle;
+}
+
+/*
+determines if reading is at the first line of an iteration of the innermost .rept block
+
+handle: file being read
+macroStack: stack of macro returns
+
+returns: if an iteration is starting
+*/
+char isReptStart(FileHandle* handle, PersistentStack* macroStack) {
+    IncludeReturnData* retData = (IncludeReturnData*)peekPersistentStack(macroStack);
+    if (retData == NULL || retData->rept == NULL) {return 0;}
+    MacroDefData* reptData = retData->rept;
+    if (reptData->body != NULL) {return handle == reptData->body && ftell(handle->fptr) == 0;}
+    return handle == reptData->handle && ftell(handle->fptr) == reptData->start;
+}
+
+/*
+binds the arguments of the innermost macro call or repetition for expressions
+
+macroStack: stack of macro returns
+*/
+void restoreMacroArgs(PersistentStack* macroStack) {
+    IncludeReturnData* callerData = (IncludeReturnData*)peekPersistentStack(macroStack);
+    if (callerData != NULL) {setMacroArgs(callerData->args, callerData->argCount, callerData->known);}
+    else {setMacroArgs(NULL, 0, NULL);}
+}
+
 /*
 counts the args in a macro
 
@@ -346,7 +733,7 @@ returns: if the name is valid
 */
 char isValidMacroName(char* name) {
     char type1 = !strcmp(name, ".define") || !strcmp(name, ".macro") || !strcmp(name, ".endmacro") || !strcmp(name, ".undef") || !strcmp(name, ".if") || !strcmp(name, ".else") || !strcmp(name, ".elseif") || !strcmp(name, ".endif") || !strcmp(name, ".ifndef") || !strcmp(name, ".elseifndef") || !strcmp(name, ".ifdef") || !strcmp(name, ".elseifdef") || !strcmp(name, ".redef") || !strcmp(name, ".include") || !strcmp(name, ".incbin");
-    char type2 = !strcmp(name, ".segment") || !strcmp(name, ".pushseg") || !strcmp(name, ".popseg") || !strcmp(name, ".res") || !strcmp(name, ".word") || !strcmp(name, ".byte") || !strcmp(name, ".align") || !strcmp(name, ".ascii") || !strcmp(name, ".asciiz");
+    char type2 = !strcmp(name, ".segment") || !strcmp(name, ".pushseg") || !strcmp(name, ".popseg") || !strcmp(name, ".res") || !strcmp(name, ".word") || !strcmp(name, ".byte") || !strcmp(name, ".align") || !strcmp(name, ".ascii") || !strcmp(name, ".asciiz") || !strcmp(name, ".rept") || !strcmp(name, ".endr");
     char type3 = !strcmp(name, ".error") || !strcmp(name, ".warning");
     return type1 || type2 || type3;
 }
\ No newline at end of file
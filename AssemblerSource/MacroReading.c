@@ -7,6 +7,7 @@ Written by Adam Billings
 #include "GeneralMacros.h"
 #include "ExpressionEvaluation.h"
 #include "ProcessMacros.h"
+#include "PassTimer.h"
 #include "MacroReading.h"
 
 /*
@@ -28,13 +29,14 @@ StringTable readMacros(FileHandle* handle, List* errorList, List* handleList, Li
     PosData macroLocation;
     StringTable macroTable = newStringTable();
     StringTable defines = newStringTable();
-    Stack* ifStack = newStack();
-    Stack* incStack = newStack();
+    PersistentStack* ifStack = newPersistentStack();
+    PersistentStack* incStack = newPersistentStack();
 
     // read file
     while (!feof(handle->fptr)) {
         // read a line
         if (fgets(line, 256, handle->fptr) == NULL && !feof(handle->fptr)) {return NULL;}
+        countPassLine();
 
         // ignore leading space
         int i = countWhitespaceChars(line, 256);
@@ -54,11 +56,8 @@ StringTable readMacros(FileHandle* handle, List* errorList, List* handleList, Li
         // handle unmatched if blocks
         if (feof(handle->fptr) && incStack->size == 0) {
             while (ifStack->size > 0) {
-                PosData* ifData = popStack(ifStack);
-                char* errorStr = (char*)malloc(16 * sizeof(char));
-                sprintf(errorStr, "Expected .endif");
-                ErrorData errorData = {errorStr, ifData->line, ifData->col, 1, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                PosData* ifData = popPersistentStack(ifStack);
+                appendError(errorList, ERR_EXPECTED_ENDIF, 0, NULL, NULL, ifData->line, ifData->col, 1, handle);
                 free(ifData);
             }
         }
@@ -70,10 +69,22 @@ StringTable readMacros(FileHandle* handle, List* errorList, List* handleList, Li
         }
 
         lineCount++;
+
+        // only directive lines matter, jump to the next one
+        if (!feof(handle->fptr)) {
+            SourceIndex* index = getSourceIndex(handle);
+            unsigned int lineIndex = findSourceLine(index, ftell(handle->fptr));
+            unsigned int nextIndex = lineIndex;
+            while (nextIndex + 1 < index->count && index->lines[nextIndex].kind != LINE_DIRECTIVE) {nextIndex++;}
+            if (nextIndex > lineIndex) {
+                fseek(handle->fptr, index->lines[nextIndex].offset, SEEK_SET);
+                lineCount += nextIndex - lineIndex;
+            }
+        }
     }
 
     deleteStringTable(defines);
-    deleteStack(ifStack);
-    deleteStack(incStack);
+    deletePersistentStack(ifStack);
+    deletePersistentStack(incStack);
     return macroTable;
 }
\ No newline at end of file
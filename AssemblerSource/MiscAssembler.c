@@ -9,6 +9,70 @@ Written by Adam Billings
 #include "DataStructures/List.h"
 #include "MiscAssembler.h"
 
+// message formats by error code
+static const char* const errorFormats[] = {
+    "%s",
+    "Unexpected trailing garbage",
+    "Line size cannot exceed 255 chars",
+    "No active segment",
+    "Expected identifier",
+    "Expected valid string",
+    "Expected assignment",
+    "Cannot declare global variables in a macro definition",
+    "Cannot update definitions inside a macro definition",
+    "An error occured inside the macro call",
+    "An error occured inside the .rept block",
+    "Incorrect argument count",
+    "Could not canonicalize file path",
+    "Could not open %s",
+    "Circular file dependency: %s",
+    "Could not parse parameters",
+    "No segments on the stack",
+    "Expected .endif",
+    "Expected .endr",
+    "Expected .if",
+    "Expected .macro",
+    "Expected .rept",
+    "\"%s\" is not defined",
+    "Invalid segment \"%s\"",
+    "Invalid macro: %s",
+    "Could not read MEMORY block",
+    "Could not read SEGMENTS block",
+    "Expected MEMORY header",
+    "Expected SEGMENTS header",
+    "Expected :",
+    "Expected =",
+    "Expected memory attribute",
+    "Expected load definition",
+    "Expected size definition",
+    "Expected start definition",
+    "Expected type definition",
+    "Could not read BANKS block",
+    "Expected BANKS header",
+    "Expected width definition",
+    "Expected depth definition",
+    "Bank width must be a multiple of 8 up to 64",
+    "Bank lanes must split the width into whole bytes",
+    "Bank size must be between 1 word and 128 KiB",
+    "Unrecognized access type: %s",
+    "Unrecognized memory location: %s",
+    "Unrecognized fill option: %s",
+    "Unrecognized attribute: %s",
+    "Redeclaration of value: %s",
+    "Repeat definition of %s",
+    "Segment %s size exceeded",
+    "Cannot reserve in read-only segment %s",
+    "Could not parse arguments: %s",
+    "Invalid constant or lable name \"%s\"",
+    "Repeat definition for constant or lable \"%s\"",
+    "Circular dependency: %s",
+    "Invalid instruction: %s",
+    "Argument exceeds range %s",
+    "Branch displacement exceeds range %s",
+    "Invalid number of arguments: expected %d",
+    "Argument %d exceeds range %s"
+};
+
 /*
 gets the directory a file is stored in from the canonical path
 
@@ -26,12 +90,57 @@ char* getDir(char* path) {
     return dir;
 }
 
+/*
+records an error without formatting its message
+
+errorList: list of errors
+code: kind of error
+arg: integer argument of the message
+textArg: string argument that outlives the error list, NULL if unused
+detail: owned string argument, NULL if unused
+line: line of the error
+col: column of the error
+len: length of the error
+handle: file of the error
+*/
+void appendError(List* errorList, ErrorCode code, int arg, const char* textArg, char* detail, int line, int col, int len, FileHandle* handle) {
+    ErrorData errorData = {detail, line, col, len, handle, code, arg, textArg};
+    appendList(errorList, &errorData, sizeof(ErrorData));
+}
+
+/*
+formats the message of an error
+
+errorData: error to format
+
+returns: message in a new string
+*/
+char* formatError(const ErrorData* errorData) {
+    const char* text = (errorData->errorMsg != NULL) ? errorData->errorMsg : errorData->textArg;
+    const char* format = errorFormats[errorData->code];
+    int length;
+    char* message;
+    if (errorData->code == ERR_ARG_COUNT || errorData->code == ERR_ARG_RANGE) {
+        length = snprintf(NULL, 0, format, errorData->arg, text);
+        message = (char*)malloc((length + 1) * sizeof(char));
+        sprintf(message, format, errorData->arg, text);
+    } else {
+        length = snprintf(NULL, 0, format, text);
+        message = (char*)malloc((length + 1) * sizeof(char));
+        sprintf(message, format, text);
+    }
+    return message;
+}
+
 /*
 prints an error message
 
 errorData: error to print
 */
 char printError(ErrorData errorData) {
+    // captured macro bodies report against their source file
+    if (errorData.handle->source != NULL) {errorData.handle = errorData.handle->source;}
+
     // calculate the formatting to the error lime
     char errorLine[errorData.col + errorData.len + 1];
     for (int i = 0; i < errorData.col; i++) {errorLine[i] = ' ';}
@@ -73,10 +182,85 @@ char printError(ErrorData errorData) {
     printf("\e[1m\e[31mERROR:\e[0;1m %s\e[0m\n", errorData.handle->name);
     printf("  %d |\t%s\n", errorData.line + 1, lineBuffer);
     printf("  %s |\t\e[31m%s\e[0m\n", digitCounter, errorLine);
-    printf("  %s |\t\e[31m%s\e[0m\n\n", digitCounter, errorData.errorMsg);
+    char* message = formatError(&errorData);
+    printf("  %s |\t\e[31m%s\e[0m\n\n", digitCounter, message);
+    free(message);
     return 0;
 }
 
+/*
+compares everything that shows in a printed error except its place in the error list
+
+a: first error
+b: second error
+
+returns: negative, zero or positive like strcmp
+*/
+static int compareErrorData(const ErrorData* a, const ErrorData* b) {
+    // captured macro bodies report against their source file
+    FileHandle* fileA = (a->handle->source != NULL) ? a->handle->source : a->handle;
+    FileHandle* fileB = (b->handle->source != NULL) ? b->handle->source : b->handle;
+    if (fileA != fileB) {return (fileA < fileB) ? -1 : 1;}
+    if (a->line != b->line) {return (a->line < b->line) ? -1 : 1;}
+    if (a->col != b->col) {return (a->col < b->col) ? -1 : 1;}
+    if (a->code != b->code) {return (a->code < b->code) ? -1 : 1;}
+    if (a->arg != b->arg) {return (a->arg < b->arg) ? -1 : 1;}
+    const char* textA = (a->errorMsg != NULL) ? a->errorMsg : a->textArg;
+    const char* textB = (b->errorMsg != NULL) ? b->errorMsg : b->textArg;
+    if (textA == textB) {return 0;}
+    return strcmp((textA != NULL) ? textA : "", (textB != NULL) ? textB : "");
+}
+
+/*
+orders errors by file, position, kind and arguments, ties by their place in the error list
+
+a: first ErrorOrder
+b: second ErrorOrder
+
+returns: negative, zero or positive like strcmp
+*/
+static int compareErrorOrder(const void* a, const void* b) {
+    const ErrorOrder* orderA = (const ErrorOrder*)a;
+    const ErrorOrder* orderB = (const ErrorOrder*)b;
+    int result = compareErrorData(orderA->errorData, orderB->errorData);
+    if (result != 0) {return result;}
+    return orderA->index - orderB->index;
+}
+
+/*
+prints all errors in the order they were reported, skipping repeats reported by rescans of the same line, and frees their messages
+
+errorList: list of errors
+*/
+void printErrors(List* errorList) {
+    if (errorList->size == 0) {return;}
+
+    // sort so repeats sit behind the first report of the same error
+    ErrorOrder* order = (ErrorOrder*)malloc(errorList->size * sizeof(ErrorOrder));
+    char* repeated = (char*)calloc(errorList->size, sizeof(char));
+    int index = 0;
+    for (Node* node = errorList->head; node != NULL; node = node->next) {
+        order[index].errorData = (ErrorData*)(node->dataptr);
+        order[index].index = index;
+        index++;
+    }
+    qsort(order, errorList->size, sizeof(ErrorOrder), compareErrorOrder);
+    for (int i = 1; i < errorList->size; i++) {
+        if (compareErrorData(order[i - 1].errorData, order[i].errorData) == 0) {repeated[order[i].index] = 1;}
+    }
+    free(order);
+
+    // print in report order
+    index = 0;
+    for (Node* node = errorList->head; node != NULL; node = node->next) {
+        ErrorData* errorData = (ErrorData*)(node->dataptr);
+        if (!repeated[index]) {printError(*errorData);}
+        free(errorData->errorMsg);
+        index++;
+    }
+    free(repeated);
+}
+
 /*
 determines if a character can be in a valid name
 
@@ -151,10 +335,7 @@ char validateFile(FileHandle* handle, List* errorList) {
         int len = strlen(buffer);
         if (len > 255) {
             hasError = 1;
-            char* errorStr = (char*)malloc(34 * sizeof(char));
-            sprintf(errorStr, "Line size cannot exceed 255 chars");
-            ErrorData errorData = {errorStr, lineCounter, 0, 1, handle};
-            appendList(errorList, &errorData, sizeof(errorData));
+            appendError(errorList, ERR_LINE_SIZE, 0, NULL, NULL, lineCounter, 0, 1, handle);
         }
         while (!feof(handle->fptr) && strlen(buffer) > 255) {
             if (fgets(buffer, 257, handle->fptr) == NULL && !feof(handle->fptr)) {return 2;}
@@ -0,0 +1,239 @@
+/*
+wall and cpu time of each assembler pass with counts of the lines each pass reads
+a pass started inside another pass is timed on its own and paused time is not counted twice
+
+Written by Adam Billings
+*/
+
+#include <time.h>
+#include <string.h>
+#include "TraceEvents.h"
+#include "PerfCounters.h"
+#include "PassTimer.h"
+
+// deepest nesting of passes that is timed
+#define PASS_STACK_SIZE 16
+
+// names of the passes in order
+static const char* const passNames[PASS_COUNT] = {
+    "readConfigFile", "validateFile", "readMacros", "readGlobalVars", "readLocalVars", "assemble", "output"
+};
+
+// totals of every pass
+static PassStats passStats[PASS_COUNT];
+
+// passes that are running, the last one is being timed
+static Pass passStack[PASS_STACK_SIZE];
+static int passDepth = 0;
+
+// clocks when the running pass was last started or resumed
+static double lastWall;
+static double lastCpu;
+static double lastCounters[PERF_COUNTER_COUNT];
+
+// if the hardware counters are read around each pass
+static char isCounting = 0;
+
+/*
+reads both clocks
+
+wall: wall time (in seconds)
+cpu: process cpu time (in seconds)
+*/
+static void readClocks(double* wall, double* cpu) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    *wall = now.tv_sec + now.tv_nsec * 1e-9;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    *cpu = now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/*
+adds the time since the running pass was started or resumed to it
+
+wall: wall time (in seconds)
+cpu: process cpu time (in seconds)
+counters: hardware counters
+*/
+static void addRunningTime(double wall, double cpu, double* counters) {
+    if (passDepth == 0 || passDepth > PASS_STACK_SIZE) {return;}
+    PassStats* running = passStats + passStack[passDepth - 1];
+    running->wall += wall - lastWall;
+    running->cpu += cpu - lastCpu;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {running->counters[i] += counters[i] - lastCounters[i];}
+}
+
+/*
+opens the hardware counters and reads them around every pass from now on
+
+returns: number of counters opened
+*/
+int startPassCounters() {
+    int opened = openPerfCounters();
+    isCounting = opened > 0;
+    if (isCounting) {readPerfCounters(lastCounters);}
+    return opened;
+}
+
+/*
+starts timing a pass, pausing the running pass
+
+pass: pass to start
+*/
+void startPass(Pass pass) {
+    startPassAt(pass, NULL, 0);
+}
+
+/*
+starts timing a pass that begins at a line of a file, pausing the running pass
+
+pass: pass to start
+handle: file the pass starts in
+line: line the pass starts on
+*/
+void startPassAt(Pass pass, FileHandle* handle, unsigned int line) {
+    double wall, cpu;
+    double counters[PERF_COUNTER_COUNT] = {0};
+    readClocks(&wall, &cpu);
+    if (isCounting) {readPerfCounters(counters);}
+    addRunningTime(wall, cpu, counters);
+    if (passDepth < PASS_STACK_SIZE) {passStack[passDepth] = pass;}
+    passDepth++;
+    passStats[pass].calls++;
+    beginTracePass(passNames[pass], handle, line);
+    lastWall = wall;
+    lastCpu = cpu;
+    memcpy(lastCounters, counters, sizeof(lastCounters));
+}
+
+/*
+stops timing the running pass, resuming the pass it paused
+*/
+void endPass() {
+    if (passDepth == 0) {return;}
+    double wall, cpu;
+    double counters[PERF_COUNTER_COUNT] = {0};
+    readClocks(&wall, &cpu);
+    if (isCounting) {readPerfCounters(counters);}
+    addRunningTime(wall, cpu, counters);
+    passDepth--;
+    endTracePass();
+    lastWall = wall;
+    lastCpu = cpu;
+    memcpy(lastCounters, counters, sizeof(lastCounters));
+}
+
+/*
+counts a line read by the running pass
+*/
+void countPassLine() {
+    if (passDepth > 0 && passDepth <= PASS_STACK_SIZE) {passStats[passStack[passDepth - 1]].lines++;}
+}
+
+/*
+counts the bytes that will be read again when a file moves back
+
+fptr: file about to move
+target: file position it will move to
+*/
+void countPassRewind(FILE* fptr, long target) {
+    if (passDepth == 0 || passDepth > PASS_STACK_SIZE) {return;}
+    long distance = ftell(fptr) - target;
+    if (distance > 0) {passStats[passStack[passDepth - 1]].rereadBytes += distance;}
+}
+
+/*
+gets the pass being timed
+
+returns: running pass, PASS_COUNT if no pass is running
+*/
+Pass getRunningPass() {
+    if (passDepth == 0 || passDepth > PASS_STACK_SIZE) {return PASS_COUNT;}
+    return passStack[passDepth - 1];
+}
+
+/*
+gets the name of a pass
+
+pass: pass to name
+
+returns: name of the pass
+*/
+const char* getPassName(Pass pass) {
+    return passNames[pass];
+}
+
+/*
+prints a table of the pass totals
+
+stream: where to print
+*/
+void printPassTimes(FILE* stream) {
+    PassStats total = {0};
+    fprintf(stream, "  -- Pass Times --\n");
+    fprintf(stream, "    %-16s %10s %10s %8s %10s %12s\n", "pass", "wall (ms)", "cpu (ms)", "calls", "lines", "reread (B)");
+    for (int i = 0; i < PASS_COUNT; i++) {
+        PassStats* stats = passStats + i;
+        fprintf(stream, "    %-16s %10.3f %10.3f %8lu %10lu %12lu\n", passNames[i], stats->wall * 1e3, stats->cpu * 1e3, stats->calls, stats->lines, stats->rereadBytes);
+        total.wall += stats->wall;
+        total.cpu += stats->cpu;
+        total.lines += stats->lines;
+        total.rereadBytes += stats->rereadBytes;
+    }
+    fprintf(stream, "    %-16s %10.3f %10.3f %8s %10lu %12lu\n\n", "total", total.wall * 1e3, total.cpu * 1e3, "", total.lines, total.rereadBytes);
+}
+
+/*
+writes the pass totals as a json object
+
+stream: where to write
+*/
+void writePassTimesJson(FILE* stream) {
+    fprintf(stream, "{\n  \"passes\": [\n");
+    for (int i = 0; i < PASS_COUNT; i++) {
+        PassStats* stats = passStats + i;
+        fprintf(stream, "    {\"name\": \"%s\", \"wall_ms\": %.6f, \"cpu_ms\": %.6f, \"calls\": %lu, \"lines\": %lu, \"reread_bytes\": %lu",
+            passNames[i], stats->wall * 1e3, stats->cpu * 1e3, stats->calls, stats->lines, stats->rereadBytes);
+
+        // hardware counters that were read, named without spaces
+        for (int j = 0; j < PERF_COUNTER_COUNT && isCounting; j++) {
+            if (!isPerfCounterOpen((PerfCounter)j)) {continue;}
+            fprintf(stream, ", \"");
+            for (const char* c = getPerfCounterName((PerfCounter)j); *c != '\0'; c++) {fputc((*c == ' ') ? '_' : *c, stream);}
+            fprintf(stream, "\": %.0f", stats->counters[j]);
+        }
+        fprintf(stream, "}%s\n", (i == PASS_COUNT - 1) ? "" : ",");
+    }
+    fprintf(stream, "  ]\n}\n");
+}
+
+/*
+prints a table of the hardware counters of each pass
+
+stream: where to print
+*/
+void printPassCounters(FILE* stream) {
+    fprintf(stream, "  -- Pass Counters --\n");
+    if (!isCounting) {
+        const char* reason = getPerfCounterError();
+        fprintf(stream, "    hardware counters are not available (%s)\n\n", (reason != NULL) ? reason : "not opened");
+        return;
+    }
+    fprintf(stream, "    %-16s", "pass");
+    for (int j = 0; j < PERF_COUNTER_COUNT; j++) {fprintf(stream, " %14s", getPerfCounterName((PerfCounter)j));}
+    fprintf(stream, " %6s\n", "ipc");
+    for (int i = 0; i < PASS_COUNT; i++) {
+        PassStats* stats = passStats + i;
+        fprintf(stream, "    %-16s", passNames[i]);
+        for (int j = 0; j < PERF_COUNTER_COUNT; j++) {
+            if (isPerfCounterOpen((PerfCounter)j)) {fprintf(stream, " %14.0f", stats->counters[j]);}
+            else {fprintf(stream, " %14s", "-");}
+        }
+
+        // instructions per cycle
+        double cycles = stats->counters[PERF_CYCLES];
+        if (isPerfCounterOpen(PERF_CYCLES) && isPerfCounterOpen(PERF_INSTRUCTIONS) && cycles > 0) {fprintf(stream, " %6.2f\n", stats->counters[PERF_INSTRUCTIONS] / cycles);}
+        else {fprintf(stream, " %6s\n", "-");}
+    }
+    fprintf(stream, "\n");
+}
@@ -0,0 +1,124 @@
+/*
+hardware performance counters of the assembler process, read around each pass by the pass timer
+only available on linux through perf_event_open, counters that cannot be opened read as 0
+
+Written by Adam Billings
+*/
+
+#include <string.h>
+#include <stdint.h>
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// names of the counters in order
+static const char* const counterNames[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "cache misses", "branch misses"
+};
+
+// file of each counter, -1 when it is not open
+static int counterFiles[PERF_COUNTER_COUNT] = {-1, -1, -1, -1};
+
+// why the first counter failed to open
+static const char* counterError = NULL;
+
+/*
+opens every counter the system allows
+
+returns: number of counters opened
+*/
+int openPerfCounters() {
+    #ifdef __linux__
+    static const uint64_t configs[PERF_COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    int opened = 0;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counterFiles[i] >= 0) {opened++; continue;}
+
+        // user space of this process and the threads it starts, kernel counts usually need privileges
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        counterFiles[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counterFiles[i] >= 0) {opened++;}
+        else if (counterError == NULL) {counterError = strerror(errno);}
+    }
+    return opened;
+    #else
+    counterError = "perf_event_open is only available on linux";
+    return 0;
+    #endif
+}
+
+/*
+closes the open counters
+*/
+void closePerfCounters() {
+    #ifdef __linux__
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counterFiles[i] >= 0) {close(counterFiles[i]);}
+        counterFiles[i] = -1;
+    }
+    #endif
+}
+
+/*
+reads every counter, scaled up when the kernel shared the hardware between counters
+
+counts: output of PERF_COUNTER_COUNT counts
+*/
+void readPerfCounters(double* counts) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        counts[i] = 0;
+        #ifdef __linux__
+        // value, time enabled, time running
+        uint64_t values[3];
+        if (counterFiles[i] < 0 || read(counterFiles[i], values, sizeof(values)) != sizeof(values)) {continue;}
+        if (values[2] == 0) {continue;}
+        counts[i] = (values[2] < values[1]) ? (double)values[0] * values[1] / values[2] : (double)values[0];
+        #endif
+    }
+}
+
+/*
+determines if a counter is open
+
+counter: counter to check
+
+returns: if the counter is open
+*/
+char isPerfCounterOpen(PerfCounter counter) {
+    return counterFiles[counter] >= 0;
+}
+
+/*
+gets the name of a counter
+
+counter: counter to name
+
+returns: name of the counter
+*/
+const char* getPerfCounterName(PerfCounter counter) {
+    return counterNames[counter];
+}
+
+/*
+gets why the first counter that failed could not be opened
+
+returns: reason, NULL if nothing failed
+*/
+const char* getPerfCounterError() {
+    return counterError;
+}
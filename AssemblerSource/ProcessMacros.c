@@ -7,11 +7,17 @@ Written by Adam Billings
 #include <stdio.h>
 #include <unistd.h>
 #include <limits.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "GeneralMacros.h"
 #include "ExpressionEvaluation.h"
 #include "DataStructures/Stack.h"
+#include "DataStructures/PersistentStack.h"
 #include "DataStructures/StringTable.h"
 #include "ConfigReader.h"
+#include "TraceEvents.h"
+#include "AssemblerStats.h"
 #include "ProcessMacros.h"
 
 /*
@@ -34,7 +40,7 @@ macroDeleteTracker: list of the argument lists for the macros
 
 returns: handle to new "main" file
 */
-FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, Stack* includeStack, Stack* ifStack, StringTable defines, StringTable macroDefs, char* isInMacro, PosData* macroData, List* macroDeleteTracker) {
+FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, PersistentStack* includeStack, PersistentStack* ifStack, StringTable defines, StringTable macroDefs, char* isInMacro, PosData* macroData, List* macroDeleteTracker) {
     // track macro endings
     static char* curMacro = NULL;
 
@@ -45,10 +51,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
 
     // handle the case of definitions being in a macro
     if (*isInMacro && (!strcmp(macroName, ".define") || !strcmp(macroName, ".redef") || !strcmp(macroName, ".undef") || !strcmp(macroName, ".macro"))) {
-        char* errorStr = (char*)malloc(52 * sizeof(char));
-        sprintf(errorStr, "Cannot update definitions inside a macro definition");
-        ErrorData errorData = {errorStr, *lineCount, curCol, 1, handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_DEFINE_IN_MACRO, 0, NULL, NULL, *lineCount, curCol, 1, handle);
         free(macroName);
         return handle;
     }
@@ -65,10 +68,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int i = countWhitespaceChars(afterName, updatedLength);
         char* fileName_ = readString(afterName + i, updatedLength - i, &afterString, &len);
         if (fileName_ == NULL) {
-            char* errorStr = (char*)malloc(22 * sizeof(char));
-            sprintf(errorStr, "Expected valid string");
-            ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_STRING, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
             free(macroName);
             return handle;
         }
@@ -76,10 +76,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         // canonicalize the file name
         char fullPath[PATH_MAX + 1];
         if (realpath(fileName_, fullPath) == NULL) {
-            char* errorStr = (char*)malloc(33 * sizeof(char));
-            sprintf(errorStr, "Could not canonicalize file path");
-            ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_CANONICALIZE, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
             free(macroName);
             free(fileName_);
             return handle;
@@ -90,10 +87,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
 
         // make sure the rest of the line is clear
         if (!isValidLineEnding(afterString, 256 - (afterString - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterString - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterString - line) + curCol, 1, handle);
             free(macroName);
             free(fileName);
             return handle;
@@ -109,13 +103,9 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
             strcpy(fileName__, fileName);
             FileHandle openHandle = {fopen(fileName__, incMode ? "rb" : "r"), fileName__, 0,  incMode};
             if (openHandle.fptr == NULL) {
-                char* errorStr = (char*)malloc(18 * sizeof(char) + strlen(fileName__));
-                sprintf(errorStr, "Could not open %s", fileName__);
-                ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, strlen(fileName__) + 2, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                appendError(errorList, ERR_OPEN_FILE, 0, NULL, fileName__, *lineCount, 256 - updatedLength + curCol + i, strlen(fileName__) + 2, handle);
                 free(macroName);
                 free(fileName);
-                free(fileName__);
                 return handle;
             }
             fseek(openHandle.fptr, 0, SEEK_END);
@@ -131,10 +121,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         // set the working directory
         char* dir = getDir(fileName);
         if (chdir(dir)) {
-            char* errorStr = (char*)malloc(33 * sizeof(char));
-            sprintf(errorStr, "Could not canonicalize file path");
-            ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_CANONICALIZE, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
             free(macroName);
             free(fileName_);
             free(fileName);
@@ -150,36 +137,36 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         long positionPreserve;
         positionPreserve = ftell(handle->fptr);
         IncludeReturnData retData = {handle, positionPreserve, *lineCount, errorList->size};
-        pushStack(includeStack, &retData, sizeof(IncludeReturnData));
+        pushPersistentStack(includeStack, &retData, sizeof(IncludeReturnData));
+        countIncludeDepth(includeStack->size);
+        beginTraceEvent(fileName, "include", handle, *lineCount);
 
         // check for circular dependency
         char hasDepError = 0;
-        for (Node* node = includeStack->head; node != NULL; node = node->next) {
+        for (StackFrame* node = includeStack->head; node != NULL; node = node->next) {
             if (!strcmp(fileName, ((IncludeReturnData*)(node->dataptr))->returnFile->name)) {hasDepError = 1; break;}
         }
         if (hasDepError) {
             // generate circular dependency report
             unsigned int nameLen = strlen(fileName) + 10;
-            for (Node* node = includeStack->head; node != NULL; node = node->next) {
+            for (StackFrame* node = includeStack->head; node != NULL; node = node->next) {
                 nameLen += strlen(((IncludeReturnData*)(node->dataptr))->returnFile->name) + 4;
                 if (!strcmp(fileName, ((IncludeReturnData*)(node->dataptr))->returnFile->name)) {break;}
             }
             char* depStr = (char*)malloc(nameLen * sizeof(char));
             sprintf(depStr, "%s", fileName);
-            for (Node* node = includeStack->head; node != NULL; node = node->next) {
+            for (StackFrame* node = includeStack->head; node != NULL; node = node->next) {
                 sprintf(depStr, "%s <- %s", depStr, ((IncludeReturnData*)(node->dataptr))->returnFile->name);
                 if (!strcmp(fileName, ((IncludeReturnData*)(node->dataptr))->returnFile->name)) {break;}
             }
             
             // push the error
-            char* errorStr = (char*)malloc((29 + strlen(depStr)) * sizeof(char));
-            sprintf(errorStr, "Circular file dependency: %s", depStr);
-            ErrorData errorData = {errorStr, *lineCount, curCol, (afterString - line), handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_CIRCULAR_INCLUDE, 0, NULL, depStr, *lineCount, curCol, (afterString - line), handle);
 
             // pop the return value and return
-            free(popStack(includeStack));
-            IncludeReturnData* retData = (IncludeReturnData*)peekStack(includeStack);
+            free(popPersistentStack(includeStack));
+            endTraceEvent();
+            IncludeReturnData* retData = (IncludeReturnData*)peekPersistentStack(includeStack);
             char* retDir = getDir(retData->returnFile->name);
             if (chdir(retDir)) {
                 printf("An internal error has occurred\n");
@@ -194,8 +181,9 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         fseek(newHandle->fptr, 0, SEEK_END);
         long endPos = ftell(newHandle->fptr);
         if (endPos == 0) {
-            free(popStack(includeStack));
-            IncludeReturnData* retData = (IncludeReturnData*)peekStack(includeStack);
+            free(popPersistentStack(includeStack));
+            endTraceEvent();
+            IncludeReturnData* retData = (IncludeReturnData*)peekPersistentStack(includeStack);
             char* retDir = getDir(retData->returnFile->name);
             if (chdir(retDir)) {
                 printf("An internal error has occurred\n");
@@ -219,10 +207,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         char* varName = getVarName(afterName + i, 249 - curCol - i, &afterVar);
         uint16_t assignValue = 0;
         if (varName == NULL) {
-            char* errorStr = (char*)malloc(20 * sizeof(char));
-            sprintf(errorStr, "Expected identifier");
-            ErrorData errorData = {errorStr, *lineCount, 7 + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *lineCount, 7 + curCol, 1, handle);
             free(varName);
             free(macroName);
             return handle;
@@ -232,8 +217,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         if (!isValidLineEnding(afterVar, 256 - (afterVar - line))) {
             ExprErrorShort exprOut = evalShortExpr(afterVar, strlen(afterVar), defines, defines);
             if (exprOut.errorMessage != NULL) {
-                ErrorData errorData = {exprOut.errorMessage, *lineCount, (afterVar - line) + curCol + exprOut.errorPos, exprOut.errorLen, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, *lineCount, (afterVar - line) + curCol + exprOut.errorPos, exprOut.errorLen, handle);
                 free(varName);
                 free(macroName);
                 return handle;
@@ -245,11 +229,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         if (!strcmp(macroName, ".define") && readStringTable(defines, varName, strlen(varName) + 1) != NULL) {
             printf("\e[1;33mWARNING:\e[0;1m %s, line %d:\e[0m redefinition of \"%s\" (consider using .redef)\n\n", handle->name, *lineCount, varName);
         } else if (!strcmp(macroName, ".redef") && readStringTable(defines, varName, strlen(varName) + 1) == NULL) {
-            char* errorStr = (char*)malloc((20 + strlen(varName)) * sizeof(char));
-            sprintf(errorStr, "\"%s\" is not defined", varName);
-            ErrorData errorData = {errorStr, *lineCount, 6 + i + curCol, strlen(varName), handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
-            free(varName);
+            appendError(errorList, ERR_UNDEFINED, 0, NULL, varName, *lineCount, 6 + i + curCol, strlen(varName), handle);
             free(macroName);
             return handle;
         }
@@ -263,10 +243,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int i = countWhitespaceChars(afterName, 249 - curCol);
         char* varName = getVarName(afterName + i, 249 - curCol - i, &afterVar);
         if (varName == NULL) {
-            char* errorStr = (char*)malloc(20 * sizeof(char));
-            sprintf(errorStr, "Expected identifier");
-            ErrorData errorData = {errorStr, *lineCount, 7 + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *lineCount, 7 + curCol, 1, handle);
             free(varName);
             free(macroName);
             return handle;
@@ -274,10 +251,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
 
         // ensure no garbage
         if (!isValidLineEnding(afterVar, 256 - (afterVar - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterVar - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterVar - line) + curCol, 1, handle);
             free(varName);
             free(macroName);
             return handle;
@@ -307,18 +281,15 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         }
 
         // push the success to the if stack
-        pushStack(ifStack, &ifData, sizeof(PosData));
+        pushPersistentStack(ifStack, &ifData, sizeof(PosData));
     } else if (!strcmp(macroName, ".else") || !strcmp(macroName, ".elseif") || !strcmp(macroName, ".elseifdef") || !strcmp(macroName, ".elseifndef") || !strcmp(macroName, ".endif")) {
         // make sure that there is an "if" to pull from
         if (ifStack->size == 0) {
-            char* errorStr = (char*)malloc(13 * sizeof(char));
-            sprintf(errorStr, "Expected .if");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_IF, 0, NULL, NULL, *lineCount, curCol, 1, handle);
         }
 
         // pop the scope
-        PosData* ifData = (PosData*)popStack(ifStack);
+        PosData* ifData = (PosData*)popPersistentStack(ifStack);
 
         // endif is done
         if (!strcmp(macroName, ".endif")) {free(ifData); free(macroName); return handle;}
@@ -333,10 +304,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         char* defName = extractVar(&afterName, 249 - i - curCol);
         int errPos = (afterName - line);
         if (defName == NULL) {
-            char* errorStr = (char*)malloc(20 * sizeof(char));
-            sprintf(errorStr, "Expected identifier");
-            ErrorData errorData = {errorStr, *lineCount, 7 + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *lineCount, 7 + curCol, 1, handle);
             free(macroName);
             return handle;
         }
@@ -344,10 +312,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         // make sure there is no comma
         i = countWhitespaceChars(afterName, strlen(afterName) + 1);
         if (afterName[i] == ',') {
-            char* errorStr = (char*)malloc(20 * sizeof(char));
-            sprintf(errorStr, "Expected identifier");
-            ErrorData errorData = {errorStr, *lineCount, 7 + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_IDENTIFIER, 0, NULL, NULL, *lineCount, 7 + curCol, 1, handle);
             free(macroName);
             free(defName);
             return handle;
@@ -356,10 +321,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         // get the args
         List* macroVars = extractMacroArgs(afterName, strlen(afterName) + 1, &afterName);
         if (macroVars == NULL) {
-            char* errorStr = (char*)malloc(27 * sizeof(char));
-            sprintf(errorStr, "Could not parse parameters");
-            ErrorData errorData = {errorStr, *lineCount, errPos + curCol, strlen(afterName), handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_PARSE_PARAMETERS, 0, NULL, NULL, *lineCount, errPos + curCol, strlen(afterName), handle);
             free(macroName);
             free(defName);
             return handle;
@@ -371,17 +333,14 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         *isInMacro = 1;
         long pos;
         pos = ftell(handle->fptr);
-        MacroDefData defData = {handle, pos, pos, *lineCount, *lineCount, macroVars};
+        MacroDefData defData = {handle, pos, pos, *lineCount, *lineCount, macroVars, NULL};
         setStringTableValue(macroDefs, defName, strlen(defName) + 1, &defData, sizeof(MacroDefData));
         appendList(macroDeleteTracker, &(defData.vars), sizeof(List));
         curMacro = defName;
     } else if (!strcmp(macroName, ".endmacro")) {
         // ensure a macro is being ended
         if (!(*isInMacro)) {
-            char* errorStr = (char*)malloc(16 * sizeof(char));
-            sprintf(errorStr, "Expected .macro");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 9, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_MACRO, 0, NULL, NULL, *lineCount, curCol, 9, handle);
             free(macroName);
             return handle;
         }
@@ -391,10 +350,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
 
         // handle trailing garbage problem
         if (!isValidLineEnding(afterName, 247 - curCol)) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, 9 + curCol, strlen(afterName), handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, 9 + curCol, strlen(afterName), handle);
             free(curMacro);
         }
 
@@ -402,6 +358,7 @@ FileHandle* executeType1Macro(FileHandle* handle, List* errorList, List* handleL
         MacroDefData* macroData = (MacroDefData*)readStringTable(macroDefs, curMacro, strlen(curMacro) + 1);
         macroData->lines = *lineCount - macroData->line;
         macroData->end = ftell(handle->fptr);
+        macroData->body = captureMacroBody(handle, handleList, macroData->vars, macroData->start, macroData->end);
         free(curMacro);
     }
 
@@ -429,10 +386,11 @@ activeSeg: active segment
 segments: list of segments
 macroDefs: macro definitions
 wordSize: size of the word in addresses accessed
+vars: variable table
 
 returns: handle to new "main" file
 */
-FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, Stack* includeStack, Stack* ifStack, Stack* segStack, Stack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize) {
+FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, PersistentStack* includeStack, PersistentStack* ifStack, PersistentStack* segStack, PersistentStack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize, StringTable vars) {
     // track .byte warning
     static char byteWarningPrinted = 0;
 
@@ -450,10 +408,7 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int i = countWhitespaceChars(afterName, updatedLength);
         char* segName = readString(afterName + i, updatedLength - i, &afterString, &len);
         if (segName == NULL) {
-            char* errorStr = (char*)malloc(22 * sizeof(char));
-            sprintf(errorStr, "Expected valid string");
-            ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_STRING, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
             free(macroName);
             return handle;
         }
@@ -469,52 +424,37 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
             }
         }
         if (!foundSeg) {
-            char* errorStr = (char*)malloc((20 + strlen(segName)) * sizeof(char));
-            sprintf(errorStr, "Invalid segment \"%s\"", segName);
-            ErrorData errorData = {errorStr, *lineCount, curCol + i + 8, strlen(segName) + 2, handle};
-            appendList(errorList, &errorData, sizeof(errorData));
+            appendError(errorList, ERR_INVALID_SEGMENT, 0, NULL, (char*)memcpy(malloc(strlen(segName) + 1), segName, strlen(segName) + 1), *lineCount, curCol + i + 8, strlen(segName) + 2, handle);
         }
 
         // make sure the rest of the line is clear
         if (!isValidLineEnding(afterString, 256 - (afterString - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterString - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterString - line) + curCol, 1, handle);
         }
         free(segName);
     } else if (!strcmp(macroName, ".pushseg")) {
         // make sure the rest of the line is clear
         if (!isValidLineEnding(afterName, 256 - (afterName - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterName - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterName - line) + curCol, 1, handle);
         }
 
         // push the segment
-        pushStack(segStack, activeSeg, sizeof(SegmentDef*));
+        pushPersistentStack(segStack, activeSeg, sizeof(SegmentDef*));
     } else if (!strcmp(macroName, ".popseg")) {
         // make sure the rest of the line is clear
         if (!isValidLineEnding(afterName, 256 - (afterName - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterName - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterName - line) + curCol, 1, handle);
         }
 
         // make sure there is a segment on the stack
         if (segStack->size == 0) {
-            char* errorStr = (char*)malloc(25 * sizeof(char));
-            sprintf(errorStr, "No segments on the stack");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EMPTY_SEGMENT_STACK, 0, NULL, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return handle;
         }
 
         // push the segment
-        SegmentDef** newSeg = (SegmentDef**)popStack(segStack);
+        SegmentDef** newSeg = (SegmentDef**)popPersistentStack(segStack);
         *activeSeg = *newSeg;
         free(newSeg);
     } else if (!strcmp(macroName, ".macro")) {
@@ -530,7 +470,8 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         fseek(handle->fptr, macroData->end, SEEK_SET);
     } else if (!strcmp(macroName, ".endmacro")) {
         // stack is known to not be empty
-        IncludeReturnData* retData = (IncludeReturnData*)popStack(macroStack);
+        IncludeReturnData* retData = (IncludeReturnData*)popPersistentStack(macroStack);
+        endTraceEvent();
         FileHandle* newHandle = retData->returnFile;
         char* dir = getDir(newHandle->name);
         if (chdir(dir)) {
@@ -539,48 +480,47 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         }
         *lineCount = retData->returnLine;
         fseek(newHandle->fptr, retData->filePosition, SEEK_SET);
+
+        // rebind the caller's arguments
+        free(retData->args);
+        free(retData->known);
+        restoreMacroArgs(macroStack);
+
         if (errorList->size > retData->errorCount) {
-            char* errorStr = (char*)malloc(39 * sizeof(char));
-            sprintf(errorStr, "An error occured inside the macro call");
-            ErrorData errorData = {errorStr, *lineCount, 0, 1, newHandle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MACRO_TRACE, 0, NULL, NULL, *lineCount, 0, 1, newHandle);
         }
         free(retData);
         return newHandle;
+    } else if (!strcmp(macroName, ".rept")) {
+        free(macroName);
+        return startRept(handle, errorList, handleList, afterName, lineCount, curCol, macroStack, vars, defines);
+    } else if (!strcmp(macroName, ".endr")) {
+        free(macroName);
+        return endRept(handle, errorList, lineCount, curCol, macroStack, vars);
     } else if (!strcmp(macroName, ".res")) {
         // handle no segment
         if (*activeSeg == NULL) {
-            char* errorStr = (char*)malloc(18 * sizeof(char));
-            sprintf(errorStr, "No active segment");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return handle;
         }
 
         ExprErrorShort exprOut = evalShortExpr(afterName, strlen(afterName), defines, defines);
         if (exprOut.errorMessage != NULL) {
-            ErrorData errorData = {exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle);
             free(macroName);
             return handle;
         }
         (*activeSeg)->writeAddr += exprOut.val;
         if ((*activeSeg)->writeAddr > (*activeSeg)->size) {
-            char* errorStr = (char*)malloc((25 + strlen((*activeSeg)->name)) * sizeof(char));
-            sprintf(errorStr, "Segment %s size exceeded", (*activeSeg)->name);
-            ErrorData errorData = {errorStr, *lineCount, curCol, 4, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_SEGMENT_SIZE, 0, (*activeSeg)->name, NULL, *lineCount, curCol, 4, handle);
             free(macroName);
             return NULL;
         }
     } else if (!strcmp(macroName, ".word")) {
         // handle no segment
         if (*activeSeg == NULL) {
-            char* errorStr = (char*)malloc(18 * sizeof(char));
-            sprintf(errorStr, "No active segment");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return handle;
         }
@@ -588,20 +528,14 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         int argCount = countArgs(afterName, strlen(afterName));
         (*activeSeg)->writeAddr += argCount * wordSize;
         if ((*activeSeg)->writeAddr > (*activeSeg)->size) {
-            char* errorStr = (char*)malloc((25 + strlen((*activeSeg)->name)) * sizeof(char));
-            sprintf(errorStr, "Segment %s size exceeded", (*activeSeg)->name);
-            ErrorData errorData = {errorStr, *lineCount, curCol, 5, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_SEGMENT_SIZE, 0, (*activeSeg)->name, NULL, *lineCount, curCol, 5, handle);
             free(macroName);
             return NULL;
         }
     } else if (!strcmp(macroName, ".byte")) {
         // handle no segment
         if (*activeSeg == NULL) {
-            char* errorStr = (char*)malloc(18 * sizeof(char));
-            sprintf(errorStr, "No active segment");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return handle;
         }
@@ -613,28 +547,21 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         int argCount = countArgs(afterName, strlen(afterName));
         (*activeSeg)->writeAddr += argCount;
         if ((*activeSeg)->writeAddr > (*activeSeg)->size) {
-            char* errorStr = (char*)malloc((25 + strlen((*activeSeg)->name)) * sizeof(char));
-            sprintf(errorStr, "Segment %s size exceeded", (*activeSeg)->name);
-            ErrorData errorData = {errorStr, *lineCount, curCol, 5, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_SEGMENT_SIZE, 0, (*activeSeg)->name, NULL, *lineCount, curCol, 5, handle);
             free(macroName);
             return NULL;
         }
     } else if (!strcmp(macroName, ".align")) {
         // handle no segment
         if (*activeSeg == NULL) {
-            char* errorStr = (char*)malloc(18 * sizeof(char));
-            sprintf(errorStr, "No active segment");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return handle;
         }
 
         ExprErrorShort exprOut = evalShortExpr(afterName, strlen(afterName), defines, defines);
         if (exprOut.errorMessage != NULL) {
-            ErrorData errorData = {exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle);
             free(macroName);
             return handle;
         }
@@ -644,10 +571,7 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         if (val == exprOut.val) {val = 0;}
         (*activeSeg)->writeAddr += val * (wordSize == 1 ? 2 : 1);
         if ((*activeSeg)->writeAddr > (*activeSeg)->size) {
-            char* errorStr = (char*)malloc((25 + strlen((*activeSeg)->name)) * sizeof(char));
-            sprintf(errorStr, "Segment %s size exceeded", (*activeSeg)->name);
-            ErrorData errorData = {errorStr, *lineCount, curCol, 6, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_SEGMENT_SIZE, 0, (*activeSeg)->name, NULL, *lineCount, curCol, 6, handle);
             free(macroName);
             return NULL;
         }
@@ -658,14 +582,19 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int len;
         unsigned int i = countWhitespaceChars(afterName, updatedLength);
         char* fileName = readString(afterName + i, updatedLength - i, &afterString, &len);
-        FileHandle* incHandle = getHandle(handleList, fileName, 1);
+        char fullPath[PATH_MAX + 1];
+        FileHandle* incHandle = NULL;
+        if (fileName != NULL && realpath(fileName, fullPath) != NULL) {incHandle = getHandle(handleList, fullPath, 1);}
+        if (incHandle == NULL) {
+            appendError(errorList, ERR_CANONICALIZE, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
+            free(fileName);
+            free(macroName);
+            return handle;
+        }
 
         // handle no segment
         if (*activeSeg == NULL) {
-            char* errorStr = (char*)malloc(18 * sizeof(char));
-            sprintf(errorStr, "No active segment");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, *lineCount, curCol, 7, handle);
             free(fileName);
             free(macroName);
             return handle;
@@ -675,10 +604,7 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         if (wordSize == 1) {(*activeSeg)->writeAddr += (incHandle->length + 1) / 2;}
         else {(*activeSeg)->writeAddr += incHandle->length;}
         if ((*activeSeg)->writeAddr > (*activeSeg)->size) {
-            char* errorStr = (char*)malloc((25 + strlen((*activeSeg)->name)) * sizeof(char));
-            sprintf(errorStr, "Segment %s size exceeded", (*activeSeg)->name);
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_SEGMENT_SIZE, 0, (*activeSeg)->name, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return NULL;
         }
@@ -686,10 +612,7 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
     } else if (!strcmp(macroName, ".ascii") || !strcmp(macroName, ".asciiz")) {
         // handle no segment
         if (*activeSeg == NULL) {
-            char* errorStr = (char*)malloc(18 * sizeof(char));
-            sprintf(errorStr, "No active segment");
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return handle;
         }
@@ -701,20 +624,14 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int len;
         char* string = readString(afterName + i, updatedLength - i, &afterString, &len);
         if (string == NULL) {
-            char* errorStr = (char*)malloc(22 * sizeof(char));
-            sprintf(errorStr, "Expected valid string");
-            ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_STRING, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
             free(macroName);
             return handle;
         }
 
         // make sure the rest of the line is clear
         if (!isValidLineEnding(afterString, 256 - (afterString - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterString - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterString - line) + curCol, 1, handle);
             free(macroName);
             free(string);
             return handle;
@@ -725,10 +642,7 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
         else {(*activeSeg)->writeAddr += len;}
         free(string);
         if ((*activeSeg)->writeAddr > (*activeSeg)->size) {
-            char* errorStr = (char*)malloc((25 + strlen((*activeSeg)->name)) * sizeof(char));
-            sprintf(errorStr, "Segment %s size exceeded", (*activeSeg)->name);
-            ErrorData errorData = {errorStr, *lineCount, curCol, 7, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_SEGMENT_SIZE, 0, (*activeSeg)->name, NULL, *lineCount, curCol, 7, handle);
             free(macroName);
             return NULL;
         }
@@ -742,6 +656,118 @@ FileHandle* executeType2Macro(FileHandle* handle, List* errorList, List* handleL
     return handle;
 }
 
+/*
+finds the first value that does not fit in a byte, signed or unsigned
+
+vals: values to check
+count: number of values
+
+returns: index of the first value out of range, -1 if every value fits
+*/
+static int findByteRangeError(const uint16_t* vals, int count) {
+    int i = 0;
+#ifdef __SSE2__
+    // check 8 values at a time, the scalar loop finds the value in a failing block
+    const __m128i highMask = _mm_set1_epi16((short)0xff00);
+    const __m128i signedMask = _mm_set1_epi16((short)0xff80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(vals + i));
+        __m128i isUnsigned = _mm_cmpeq_epi16(_mm_and_si128(block, highMask), zero);
+        __m128i isSigned = _mm_cmpeq_epi16(_mm_and_si128(block, signedMask), signedMask);
+        if (_mm_movemask_epi8(_mm_or_si128(isUnsigned, isSigned)) != 0xffff) {break;}
+    }
+#endif
+    // 0 to 255, or -128 to -1 with the sign bit of the byte set
+    for (; i < count; i++) {
+        if ((vals[i] & 0xff00) != 0x0000 && (vals[i] & 0xff80) != 0xff80) {return i;}
+    }
+    return -1;
+}
+
+/*
+evaluates the operands of a .word or .byte directive and stores them in one pass
+
+handle: current file handle
+errorList: list of errors
+line: current line, expects the directive at the start
+afterName: operands of the directive
+lineCount: current line number
+curCol: start index for the error messages
+activeSeg: active segment
+vars: variable table
+defines: defined constant information
+wordSize: size of the word in addresses accessed
+isLittleEndian: if the code is little endian
+isByte: if the operands are bytes
+*/
+static void emitData(FileHandle* handle, List* errorList, char* line, char* afterName, unsigned int lineCount, unsigned int curCol, SegmentDef* activeSeg, StringTable vars, StringTable defines, int wordSize, char isLittleEndian, char isByte) {
+    // evaluate every operand
+    List* args = extractArgs(afterName, strlen(afterName));
+    int count = args->size;
+    uint16_t* vals = (uint16_t*)malloc((count + 1) * sizeof(uint16_t));
+    unsigned int* argCols = (unsigned int*)malloc((count + 1) * sizeof(unsigned int));
+    unsigned int* argLens = (unsigned int*)malloc((count + 1) * sizeof(unsigned int));
+    char hasError = 0;
+    int i = 0;
+    unsigned int argStart = afterName - line;
+    for (Node* node = args->head; node != NULL; node = node->next) {
+        // locate the operand without its surrounding whitespace for the error markers
+        char* arg = *(char**)(node->dataptr);
+        unsigned int argLength = strlen(arg);
+        unsigned int leading = countWhitespaceChars(arg, argLength);
+        unsigned int end = argLength;
+        while (end > leading && isspace(arg[end - 1])) {end--;}
+        argCols[i] = curCol + argStart + leading;
+        argLens[i] = (end > leading) ? end - leading : 1;
+        argStart += argLength + 1;
+
+        if (!hasError) {
+            ExprErrorShort exprOut = evalShortExpr(arg, argLength, vars, defines);
+            if (exprOut.errorMessage != NULL) {
+                appendError(errorList, ERR_ARG_PARSE, 0, NULL, exprOut.errorMessage, lineCount, argCols[i], argLens[i], handle);
+                hasError = 1;
+            }
+            vals[i] = exprOut.val;
+        }
+        i++;
+        free(arg);
+    }
+    deleteList(args);
+
+    // bytes may be signed or unsigned
+    if (!hasError && isByte) {
+        int errorIndex = findByteRangeError(vals, count);
+        if (errorIndex >= 0) {
+            appendError(errorList, ERR_ARG_RANGE, errorIndex + 1, "-128 to 127 or 0 to 255", NULL, lineCount, argCols[errorIndex], argLens[errorIndex], handle);
+            hasError = 1;
+        }
+    }
+    free(argCols);
+    free(argLens);
+
+    // store the values, bytes fill a whole address when addresses hold words
+    int unitSize = (isByte && wordSize != 1) ? 1 : 2;
+    if (!hasError) {
+        uint8_t* bytes = (uint8_t*)malloc((count * unitSize + 1) * sizeof(uint8_t));
+        if (unitSize == 1) {
+            for (int j = 0; j < count; j++) {bytes[j] = (uint8_t)vals[j];}
+        } else {
+            uint16_t valMask = isByte ? 0x00ff : 0xffff;
+            int lowIndex = isLittleEndian ? 0 : 1;
+            for (int j = 0; j < count; j++) {
+                uint16_t val = vals[j] & valMask;
+                bytes[2 * j + lowIndex] = (uint8_t)val;
+                bytes[2 * j + 1 - lowIndex] = (uint8_t)(val >> 8);
+            }
+        }
+        writeSegmentBytes(activeSeg->image, activeSeg->writeAddr, bytes, count * unitSize);
+        free(bytes);
+    }
+    activeSeg->writeAddr += count * unitSize;
+    free(vals);
+}
+
 /*
 process type 3 macro
 
@@ -767,106 +793,46 @@ vars: variable table
 
 returns: handle to new "main" file
 */
-FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, Stack* includeStack, Stack* ifStack, Stack* segStack, Stack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize, char isLittleEndian, List* macroVars, StringTable vars) {
+FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleList, char* line, int lineLength, unsigned int* lineCount, unsigned int curCol, PersistentStack* includeStack, PersistentStack* ifStack, PersistentStack* segStack, PersistentStack* macroStack, StringTable defines, SegmentDef** activeSeg, List* segments, StringTable macroDefs, int wordSize, char isLittleEndian, List* macroVars, StringTable vars) {
     // get the macro to execute
     char* afterName;
     char* macroName = extractMacro(line, lineLength, &afterName);
     unsigned int updatedLength = 256 - (afterName - line);
 
-    if (!strcmp(macroName, ".res")) {
+    if (!strcmp(macroName, ".rept")) {
+        free(macroName);
+        return startRept(handle, errorList, handleList, afterName, lineCount, curCol, macroStack, vars, defines);
+    } else if (!strcmp(macroName, ".endr")) {
+        free(macroName);
+        return endRept(handle, errorList, lineCount, curCol, macroStack, vars);
+    } else if (!strcmp(macroName, ".res")) {
         // handle ro segment
         if ((*activeSeg)->accessType == ro) {
-            char* errorStr = (char*)malloc((36 + strlen((*activeSeg)->name)) * sizeof(char));
-            sprintf(errorStr, "Cannot reserve in read-only segment %s", (*activeSeg)->name);
-            ErrorData errorData = {errorStr, *lineCount, curCol, 4, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_RESERVE_READ_ONLY, 0, (*activeSeg)->name, NULL, *lineCount, curCol, 4, handle);
             free(macroName);
             return handle;
         }
 
         ExprErrorShort exprOut = evalShortExpr(afterName, strlen(afterName), vars, defines);
         if (exprOut.errorMessage != NULL) {
-            ErrorData errorData = {exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle);
             free(macroName);
             return handle;
         }
 
         // fill 0s
         if ((*activeSeg)->accessType != bss) {
-            for (int i = 0; i < exprOut.val * (wordSize == 1 ? 2 : 1); i++) {
-                (*activeSeg)->outputArr[i + (*activeSeg)->writeAddr] = 0;
-            }
+            clearSegmentBytes((*activeSeg)->image, (*activeSeg)->writeAddr, exprOut.val * (wordSize == 1 ? 2 : 1));
         }
         (*activeSeg)->writeAddr += exprOut.val * (wordSize == 1 ? 2 : 1);
     } else if (!strcmp(macroName, ".word")) {
-        List* args = extractArgs(afterName, strlen(afterName));
-        char hasError = 0;
-        for (Node* node = args->head; node != NULL; node = node->next){
-            char* arg = *(char**)(node->dataptr);
-            if (!hasError) {
-                ExprErrorShort exprOut = evalShortExpr(arg, strlen(arg), vars, defines);
-                if (exprOut.errorMessage != NULL) {
-                    char* errorStr = (char*)malloc((30 + strlen(exprOut.errorMessage)) * sizeof(char));
-                    sprintf(errorStr, "Could not parse arguments: %s", exprOut.errorMessage);
-                    free(exprOut.errorMessage);
-                    ErrorData errorData = {errorStr, *lineCount, curCol + 5, strlen(line) - 5, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
-                    hasError = 1;
-                }
-                if (isLittleEndian) {
-                    uint16_t val = exprOut.val;
-                    (*activeSeg)->outputArr[(*activeSeg)->writeAddr] = (val & 0x00ff);
-                    (*activeSeg)->outputArr[(*activeSeg)->writeAddr + 1] = ((val >> 8) & 0x00ff);
-                } else {
-                    uint16_t val = exprOut.val;
-                    (*activeSeg)->outputArr[(*activeSeg)->writeAddr + 1] = (val & 0x00ff);
-                    (*activeSeg)->outputArr[(*activeSeg)->writeAddr] = ((val >> 8) & 0x00ff);
-                }
-            }
-            (*activeSeg)->writeAddr += 2;
-            free(arg);
-        }
-        deleteList(args);
+        emitData(handle, errorList, line, afterName, *lineCount, curCol, *activeSeg, vars, defines, wordSize, isLittleEndian, 0);
     } else if (!strcmp(macroName, ".byte")) {
-        List* args = extractArgs(afterName, strlen(afterName));
-        char hasError = 0;
-        for (Node* node = args->head; node != NULL; node = node->next){
-            char* arg = *(char**)(node->dataptr);
-            if (!hasError) {
-                ExprErrorShort exprOut = evalShortExpr(arg, strlen(arg), vars, defines);
-                if (exprOut.errorMessage != NULL) {
-                    char* errorStr = (char*)malloc((30 + strlen(exprOut.errorMessage))* sizeof(char));
-                    sprintf(errorStr, "Could not parse arguments: %s", exprOut.errorMessage);
-                    free(exprOut.errorMessage);
-                    ErrorData errorData = {errorStr, *lineCount, curCol + 5, strlen(line) - 5, handle};
-                    appendList(errorList, &errorData, sizeof(ErrorData));
-                    hasError = 1;
-                }
-                if (wordSize == 1) {
-                    if (isLittleEndian) {
-                        uint16_t val = exprOut.val;
-                        (*activeSeg)->outputArr[(*activeSeg)->writeAddr] = (val & 0x00ff);
-                        (*activeSeg)->outputArr[(*activeSeg)->writeAddr + 1] = 0;
-                    } else {
-                        uint16_t val = exprOut.val;
-                        (*activeSeg)->outputArr[(*activeSeg)->writeAddr + 1] = (val & 0x00ff);
-                        (*activeSeg)->outputArr[(*activeSeg)->writeAddr] = 0;
-                    }
-                } else {
-                    uint16_t val = exprOut.val;
-                    (*activeSeg)->outputArr[(*activeSeg)->writeAddr] = (val & 0x00ff);
-                }
-            }
-            (*activeSeg)->writeAddr += wordSize == 1 ? 2 : 1;
-            free(arg);
-        }
-        deleteList(args);
+        emitData(handle, errorList, line, afterName, *lineCount, curCol, *activeSeg, vars, defines, wordSize, isLittleEndian, 1);
     } else if (!strcmp(macroName, ".align")) {
         ExprErrorShort exprOut = evalShortExpr(afterName, strlen(afterName), vars, defines);
         if (exprOut.errorMessage != NULL) {
-            ErrorData errorData = {exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MESSAGE, 0, NULL, exprOut.errorMessage, *lineCount, exprOut.errorPos + (afterName - line) + curCol, exprOut.errorLen, handle);
             free(macroName);
             return handle;
         }
@@ -877,9 +843,7 @@ FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleL
 
         // fill 0s
         if ((*activeSeg)->accessType != bss) {
-            for (int i = 0; i < val * (wordSize == 1 ? 2 : 1); i++) {
-                (*activeSeg)->outputArr[i + (*activeSeg)->writeAddr] = 0;
-            }
+            clearSegmentBytes((*activeSeg)->image, (*activeSeg)->writeAddr, val * (wordSize == 1 ? 2 : 1));
         }
         (*activeSeg)->writeAddr += val * (wordSize == 1 ? 2 : 1);
     } else if (!strcmp(macroName, ".incbin")) {
@@ -889,17 +853,28 @@ FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int len;
         unsigned int i = countWhitespaceChars(afterName, updatedLength);
         char* fileName = readString(afterName + i, updatedLength - i, &afterString, &len);
-        FileHandle* incHandle = getHandle(handleList, fileName, 1);
+        char fullPath[PATH_MAX + 1];
+        FileHandle* incHandle = NULL;
+        if (fileName != NULL && realpath(fileName, fullPath) != NULL) {incHandle = getHandle(handleList, fullPath, 1);}
+        if (incHandle == NULL) {
+            appendError(errorList, ERR_CANONICALIZE, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
+            free(fileName);
+            free(macroName);
+            return handle;
+        }
 
         // read the file
         rewind(incHandle->fptr);
-        if (fread((*activeSeg)->outputArr + (*activeSeg)->writeAddr, 1, incHandle->length, incHandle->fptr)) {return NULL;}
+        uint8_t* incData = (uint8_t*)malloc(incHandle->length + 1);
+        if (fread(incData, 1, incHandle->length, incHandle->fptr) != incHandle->length) {free(incData); return NULL;}
+        writeSegmentBytes((*activeSeg)->image, (*activeSeg)->writeAddr, incData, incHandle->length);
+        free(incData);
         (*activeSeg)->writeAddr += incHandle->length;
         if (wordSize == 1) {
             if (!isLittleEndian && (incHandle->length % 2) == 1) {
-                uint8_t val = (*activeSeg)->outputArr[(*activeSeg)->writeAddr - 1];
-                (*activeSeg)->outputArr[(*activeSeg)->writeAddr - 1] = 0;
-                (*activeSeg)->outputArr[(*activeSeg)->writeAddr] = val;
+                uint8_t val = readSegmentByte((*activeSeg)->image, (*activeSeg)->writeAddr - 1);
+                writeSegmentByte((*activeSeg)->image, (*activeSeg)->writeAddr - 1, 0);
+                writeSegmentByte((*activeSeg)->image, (*activeSeg)->writeAddr, val);
             }
             if ((incHandle->length % 2) == 1) {(*activeSeg)->writeAddr += 1;}
         }
@@ -912,28 +887,21 @@ FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int len;
         char* string = readString(afterName + i, updatedLength - i, &afterString, &len);
         if (string == NULL) {
-            char* errorStr = (char*)malloc(22 * sizeof(char));
-            sprintf(errorStr, "Expected valid string");
-            ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_STRING, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
             free(macroName);
             return handle;
         }
 
         // make sure the rest of the line is clear
         if (!isValidLineEnding(afterString, 256 - (afterString - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterString - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterString - line) + curCol, 1, handle);
             free(macroName);
             free(string);
             return handle;
         }
 
         // append the error
-        ErrorData errorData = {string, *lineCount, curCol, 6, handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_MESSAGE, 0, NULL, string, *lineCount, curCol, 6, handle);
     } else if (!strcmp(macroName, ".warning")) {
         // get the string
         char hasNameError = 0;
@@ -942,20 +910,14 @@ FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleL
         unsigned int len;
         char* string = readString(afterName + i, updatedLength - i, &afterString, &len);
         if (string == NULL) {
-            char* errorStr = (char*)malloc(22 * sizeof(char));
-            sprintf(errorStr, "Expected valid string");
-            ErrorData errorData = {errorStr, *lineCount, 256 - updatedLength + curCol + i, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_STRING, 0, NULL, NULL, *lineCount, 256 - updatedLength + curCol + i, 1, handle);
             free(macroName);
             return handle;
         }
 
         // make sure the rest of the line is clear
         if (!isValidLineEnding(afterString, 256 - (afterString - line))) {
-            char* errorStr = (char*)malloc(28 * sizeof(char));
-            sprintf(errorStr, "Unexpected trailing garbage");
-            ErrorData errorData = {errorStr, *lineCount, (afterString - line) + curCol, 1, handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_TRAILING_GARBAGE, 0, NULL, NULL, *lineCount, (afterString - line) + curCol, 1, handle);
             free(macroName);
             free(string);
             return handle;
@@ -979,15 +941,15 @@ FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleL
         // write the string
         for (int j = 0; j < stringSize; j++) {
             if (wordSize == 1) {
-                (*activeSeg)->outputArr[(*activeSeg)->writeAddr + 2 * j + (isLittleEndian ? 0 : 1)] = string[j];
+                writeSegmentByte((*activeSeg)->image, (*activeSeg)->writeAddr + 2 * j + (isLittleEndian ? 0 : 1), string[j]);
             } else {
-                (*activeSeg)->outputArr[(*activeSeg)->writeAddr + j] = string[j];
+                writeSegmentByte((*activeSeg)->image, (*activeSeg)->writeAddr + j, string[j]);
             }
         }
         (*activeSeg)->writeAddr += stringSize * (wordSize == 1 ? 2 : 1);
         free(string);
     } else if (!strcmp(macroName, ".endmacro")) {
-        // undefine the macro vars
+        // undefine the macro's local labels
         for (Node* node = macroVars->head; node != NULL; node = node->next) {
             char* varName = *(char**)(node->dataptr);
             removeStringTableValue(vars, varName, strlen(varName) + 1);
@@ -998,7 +960,8 @@ FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleL
         macroVars->size = 0;
 
         // stack is known to not be empty
-        IncludeReturnData* retData = (IncludeReturnData*)popStack(macroStack);
+        IncludeReturnData* retData = (IncludeReturnData*)popPersistentStack(macroStack);
+        endTraceEvent();
         FileHandle* newHandle = retData->returnFile;
         char* dir = getDir(newHandle->name);
         if (chdir(dir)) {
@@ -1007,22 +970,22 @@ FileHandle* executeType3Macro(FileHandle* handle, List* errorList, List* handleL
         }
         *lineCount = retData->returnLine;
         fseek(newHandle->fptr, retData->filePosition, SEEK_SET);
+
+        // rebind the caller's arguments
+        free(retData->args);
+        free(retData->known);
+        restoreMacroArgs(macroStack);
+
         if (errorList->size > retData->errorCount) {
-            char* errorStr = (char*)malloc(39 * sizeof(char));
-            sprintf(errorStr, "An error occured inside the macro call");
-            ErrorData errorData = {errorStr, *lineCount, 0, 1, newHandle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_MACRO_TRACE, 0, NULL, NULL, *lineCount, 0, 1, newHandle);
         }
         free(retData);
         return newHandle;
     } else if (isValidMacroName(macroName)){
         free(macroName);
-        return executeType2Macro(handle, errorList, handleList, line, lineLength, lineCount, curCol, includeStack, ifStack, segStack, macroStack, defines, activeSeg, segments, macroDefs, wordSize);
+        return executeType2Macro(handle, errorList, handleList, line, lineLength, lineCount, curCol, includeStack, ifStack, segStack, macroStack, defines, activeSeg, segments, macroDefs, wordSize, vars);
     } else {
-        char* errorStr = malloc((18 + strlen(macroName)) * sizeof(char));
-        sprintf(errorStr, "Invalid macro: %s", macroName);
-        ErrorData errorData = {errorStr, *lineCount, curCol, strlen(macroName), handle};
-        appendList(errorList, &errorData, sizeof(ErrorData));
+        appendError(errorList, ERR_INVALID_MACRO, 0, NULL, (char*)memcpy(malloc(strlen(macroName) + 1), macroName, strlen(macroName) + 1), *lineCount, curCol, strlen(macroName), handle);
     }
 
     free(macroName);
@@ -0,0 +1,148 @@
+/*
+raw binary output of the segments, laid out one after another with their alignment padding
+long runs of zeros are left as holes in regular files instead of being written
+
+Written by Adam Billings
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "ConfigReader.h"
+#include "SegmentImage.h"
+#include "RawOutput.h"
+
+// zeros for runs too short to leave as holes
+static const uint8_t rawZeros[RAW_HOLE_SIZE];
+
+/*
+writes the waiting ranges at the offset of the writer
+
+writer: writer to empty
+*/
+static void flushRawWriter(RawWriter* writer) {
+    struct iovec* iov = writer->iov;
+    int count = writer->iovCount;
+    writer->iovCount = 0;
+    while (count > 0 && !writer->hasFailed) {
+        ssize_t written = writer->isSeekable ? pwritev(writer->fd, iov, count, writer->offset) : writev(writer->fd, iov, count);
+        if (written < 0) {
+            if (errno != EINTR) {writer->hasFailed = 1;}
+            continue;
+        }
+        writer->offset += written;
+
+        // a short write continues from the first range it did not finish
+        while (count > 0 && (size_t)written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (uint8_t*)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+/*
+adds a range to the next write
+
+writer: writer to add to
+data: bytes to write, kept until the writer is flushed
+len: number of bytes
+*/
+static void putRawRange(RawWriter* writer, const uint8_t* data, size_t len) {
+    if (writer->iovCount == RAW_IOV_COUNT) {flushRawWriter(writer);}
+    writer->iov[writer->iovCount].iov_base = (void*)data;
+    writer->iov[writer->iovCount].iov_len = len;
+    writer->iovCount++;
+}
+
+/*
+places the zeros waiting in the writer, long runs are skipped over to leave a hole
+
+writer: writer to update
+*/
+static void placeRawZeros(RawWriter* writer) {
+    if (writer->zeroLen >= RAW_HOLE_SIZE && writer->isSeekable) {
+        flushRawWriter(writer);
+        writer->offset += writer->zeroLen;
+    } else {
+        while (writer->zeroLen > 0) {
+            size_t len = (writer->zeroLen < RAW_HOLE_SIZE) ? writer->zeroLen : RAW_HOLE_SIZE;
+            putRawRange(writer, rawZeros, len);
+            writer->zeroLen -= len;
+        }
+    }
+    writer->zeroLen = 0;
+}
+
+/*
+adds the start of an image, pages of zeros are only counted
+
+writer: writer to add to
+image: image to output
+len: number of bytes to output
+*/
+static void putRawImage(RawWriter* writer, SegmentImage* image, uint32_t len) {
+    for (uint32_t page = 0; len > 0; page++) {
+        uint32_t chunk = len < SEGMENT_PAGE_SIZE ? len : SEGMENT_PAGE_SIZE;
+        const uint8_t* data = readSegmentPage(image, page);
+        len -= chunk;
+
+        // untouched pages and pages that only hold zeros join the run of zeros
+        if (data[0] == 0 && !memcmp(data, data + 1, chunk - 1)) {
+            writer->zeroLen += chunk;
+            continue;
+        }
+        placeRawZeros(writer);
+        putRawRange(writer, data, chunk);
+    }
+}
+
+/*
+writes the segments as a raw binary
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+output: file to write to, nothing can have been written through it yet
+
+returns: if every byte was written
+*/
+char writeRawImage(List* segments, int wordSize, FILE* output) {
+    RawWriter writer;
+    writer.fd = fileno(output);
+    writer.hasFailed = 0;
+    writer.offset = 0;
+    writer.zeroLen = 0;
+    writer.iovCount = 0;
+
+    // pipes and terminals cannot be written at an offset, so they get every zero
+    struct stat fileStat;
+    writer.isSeekable = (fstat(writer.fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode));
+
+    long pos = 0;
+    for (Node* node = segments->head; node != NULL; node = node->next) {
+        SegmentDef* seg = (SegmentDef*)(node->dataptr);
+        if (seg->align > 1) {
+            if (wordSize == 1) {pos /= 2;}
+            uint16_t buffer = seg->align - (pos % seg->align);
+            if (buffer == seg->align) {buffer = 0;}
+            writer.zeroLen += buffer * (wordSize == 1 ? 2 : 1);
+            pos += buffer * (wordSize == 1 ? 2 : 1);
+        }
+        if (seg->accessType != bss) {
+            uint32_t len = seg->fill ? seg->size * (wordSize == 1 ? 2 : 1) : seg->writeAddr;
+            putRawImage(&writer, seg->image, len);
+            pos += len;
+        }
+    }
+
+    // zeros at the end still count towards the size of the file
+    placeRawZeros(&writer);
+    flushRawWriter(&writer);
+    if (writer.isSeekable && !writer.hasFailed && ftruncate(writer.fd, writer.offset) != 0) {writer.hasFailed = 1;}
+    return !writer.hasFailed;
+}
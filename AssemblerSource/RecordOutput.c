@@ -0,0 +1,193 @@
+/*
+intel hex and motorola s-record output
+only the bytes each segment wrote are output, at the address of the segment
+
+Written by Adam Billings
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "ConfigReader.h"
+#include "SegmentImage.h"
+#include "RecordOutput.h"
+
+/*
+writes the buffered text to the file
+
+buffer: buffer to empty
+*/
+static void flushRecords(RecordBuffer* buffer) {
+    fwrite(buffer->text, 1, buffer->used, buffer->output);
+    buffer->used = 0;
+}
+
+/*
+adds a byte as two hex digits, counting it in the checksum
+
+buffer: buffer to add to
+val: byte to add
+*/
+static void putRecordByte(RecordBuffer* buffer, uint8_t val) {
+    static const char digits[] = "0123456789ABCDEF";
+    buffer->text[buffer->used++] = digits[val >> 4];
+    buffer->text[buffer->used++] = digits[val & 0x0f];
+    buffer->checksum += val;
+}
+
+/*
+adds text that is not part of the checksum
+
+buffer: buffer to add to
+text: text to add
+*/
+static void putRecordText(RecordBuffer* buffer, const char* text) {
+    size_t len = strlen(text);
+    memcpy(buffer->text + buffer->used, text, len);
+    buffer->used += len;
+}
+
+/*
+adds one intel hex record
+
+buffer: buffer to add to
+type: record type
+addr: lower 16 bits of the address
+data: data bytes
+len: number of data bytes
+*/
+static void putIntelRecord(RecordBuffer* buffer, uint8_t type, uint16_t addr, const uint8_t* data, int len) {
+    // a full record is at most 12 + 2 * 255 characters
+    if (buffer->used > RECORD_BUFFER_SIZE - 600) {flushRecords(buffer);}
+    putRecordText(buffer, ":");
+    buffer->checksum = 0;
+    putRecordByte(buffer, len);
+    putRecordByte(buffer, addr >> 8);
+    putRecordByte(buffer, addr & 0xff);
+    putRecordByte(buffer, type);
+    for (int i = 0; i < len; i++) {putRecordByte(buffer, data[i]);}
+    putRecordByte(buffer, -buffer->checksum);
+    putRecordText(buffer, "\n");
+}
+
+/*
+adds one s-record
+
+buffer: buffer to add to
+type: record type digit
+addrBytes: number of address bytes
+addr: address
+data: data bytes
+len: number of data bytes
+*/
+static void putSRecord(RecordBuffer* buffer, char type, int addrBytes, uint32_t addr, const uint8_t* data, int len) {
+    if (buffer->used > RECORD_BUFFER_SIZE - 600) {flushRecords(buffer);}
+    char start[3] = {'S', type, '\0'};
+    putRecordText(buffer, start);
+    buffer->checksum = 0;
+
+    // the count includes the address and checksum
+    putRecordByte(buffer, addrBytes + len + 1);
+    for (int i = addrBytes - 1; i >= 0; i--) {putRecordByte(buffer, (addr >> (8 * i)) & 0xff);}
+    for (int i = 0; i < len; i++) {putRecordByte(buffer, data[i]);}
+    putRecordByte(buffer, ~buffer->checksum);
+    putRecordText(buffer, "\n");
+}
+
+/*
+adds the data records of every written range of the segments
+
+buffer: buffer to add to
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+isSRecord: if s-records are written instead of intel hex
+addrBytes: number of address bytes of s-records
+
+returns: number of data records
+*/
+static unsigned long putDataRecords(RecordBuffer* buffer, List* segments, int wordSize, char isSRecord, int addrBytes) {
+    unsigned long records = 0;
+    uint32_t upperAddr = 0;
+    for (Node* node = segments->head; node != NULL; node = node->next) {
+        SegmentDef* seg = (SegmentDef*)(node->dataptr);
+        if (seg->accessType == bss || seg->image == NULL || seg->writeAddr == 0) {continue;}
+
+        // records hold byte addresses, a word address holds two bytes
+        uint32_t base = seg->startAddr * (wordSize == 1 ? 2 : 1);
+
+        // pages that were never written hold nothing to load
+        for (uint32_t page = 0; page * SEGMENT_PAGE_SIZE < seg->writeAddr; page++) {
+            if (!isSegmentPageCommitted(seg->image, page)) {continue;}
+            const uint8_t* data = readSegmentPage(seg->image, page);
+            uint32_t offset = page * SEGMENT_PAGE_SIZE;
+            uint32_t end = offset + SEGMENT_PAGE_SIZE;
+            if (end > seg->writeAddr) {end = seg->writeAddr;}
+            while (offset < end) {
+                uint32_t addr = base + offset;
+                uint32_t len = end - offset;
+                if (len > RECORD_DATA_SIZE) {len = RECORD_DATA_SIZE;}
+
+                // intel hex records cannot cross a 64 KiB boundary
+                if (len > 0x10000 - (addr & 0xffff)) {len = 0x10000 - (addr & 0xffff);}
+                if (isSRecord) {putSRecord(buffer, (addrBytes == 2) ? '1' : '2', addrBytes, addr, data + offset % SEGMENT_PAGE_SIZE, len);}
+                else {
+                    if ((addr >> 16) != upperAddr) {
+                        upperAddr = addr >> 16;
+                        uint8_t upper[2] = {upperAddr >> 8, upperAddr & 0xff};
+                        putIntelRecord(buffer, 4, 0, upper, 2);
+                    }
+                    putIntelRecord(buffer, 0, addr & 0xffff, data + offset % SEGMENT_PAGE_SIZE, len);
+                }
+                records++;
+                offset += len;
+            }
+        }
+    }
+    return records;
+}
+
+/*
+writes the segments as intel hex
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+output: file to write to
+*/
+void writeIntelHex(List* segments, int wordSize, FILE* output) {
+    RecordBuffer* buffer = (RecordBuffer*)malloc(sizeof(RecordBuffer));
+    buffer->output = output;
+    buffer->used = 0;
+    putDataRecords(buffer, segments, wordSize, 0, 0);
+    putIntelRecord(buffer, 1, 0, NULL, 0);
+    flushRecords(buffer);
+    free(buffer);
+}
+
+/*
+writes the segments as motorola s-records
+
+segments: list of segments
+wordSize: 1 if addresses store words, 2 if addresses store bytes
+output: file to write to
+*/
+void writeSRecords(List* segments, int wordSize, FILE* output) {
+    RecordBuffer* buffer = (RecordBuffer*)malloc(sizeof(RecordBuffer));
+    buffer->output = output;
+    buffer->used = 0;
+
+    // 24 bit addresses are only used when a segment ends past 64 KiB
+    int addrBytes = 2;
+    for (Node* node = segments->head; node != NULL; node = node->next) {
+        SegmentDef* seg = (SegmentDef*)(node->dataptr);
+        if (seg->startAddr * (wordSize == 1 ? 2 : 1) + seg->writeAddr > 0x10000) {addrBytes = 3;}
+    }
+
+    // header, data, count and termination
+    const char* header = "ace3710";
+    putSRecord(buffer, '0', 2, 0, (const uint8_t*)header, strlen(header));
+    unsigned long records = putDataRecords(buffer, segments, wordSize, 1, addrBytes);
+    if (records <= 0xffff) {putSRecord(buffer, '5', 2, records, NULL, 0);}
+    else {putSRecord(buffer, '6', 3, records, NULL, 0);}
+    putSRecord(buffer, (addrBytes == 2) ? '9' : '8', addrBytes, 0, NULL, 0);
+    flushRecords(buffer);
+    free(buffer);
+}
@@ -0,0 +1,173 @@
+/*
+sparse output image of a segment
+pages are only allocated once something is written to them
+
+Written by Adam Billings
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "SegmentImage.h"
+
+// backing for every untouched page
+static const uint8_t ZERO_PAGE[SEGMENT_PAGE_SIZE] = {0};
+
+/*
+creates an empty image, no pages are committed
+
+size: size of the image (in bytes)
+
+returns: new image
+*/
+SegmentImage* newSegmentImage(uint32_t size) {
+    SegmentImage* image = (SegmentImage*)malloc(sizeof(SegmentImage));
+    image->size = size;
+    image->pageCount = (size + SEGMENT_PAGE_SIZE - 1) / SEGMENT_PAGE_SIZE;
+    image->pages = (uint8_t**)calloc(image->pageCount + 1, sizeof(uint8_t*));
+    image->pageBitmap = (uint64_t*)calloc(image->pageCount / 64 + 1, sizeof(uint64_t));
+    return image;
+}
+
+/*
+frees an image and all of its pages
+
+image: image to free
+
+returns: NULL
+*/
+SegmentImage* deleteSegmentImage(SegmentImage* image) {
+    for (uint32_t i = 0; i < image->pageCount; i++) {
+        if (image->pages[i] != NULL) {free(image->pages[i]);}
+    }
+    free(image->pages);
+    free(image->pageBitmap);
+    free(image);
+    return NULL;
+}
+
+/*
+checks if a page has been written to
+
+image: image to inspect
+page: page index
+
+returns: if the page is committed
+*/
+char isSegmentPageCommitted(SegmentImage* image, uint32_t page) {
+    return (image->pageBitmap[page / 64] >> (page % 64)) & 1;
+}
+
+/*
+gets a page for writing, committing it on first use
+
+image: image to write
+page: page index
+
+returns: page bytes
+*/
+static uint8_t* commitSegmentPage(SegmentImage* image, uint32_t page) {
+    if (image->pages[page] == NULL) {
+        image->pages[page] = (uint8_t*)calloc(SEGMENT_PAGE_SIZE, sizeof(uint8_t));
+        image->pageBitmap[page / 64] |= (uint64_t)1 << (page % 64);
+    }
+    return image->pages[page];
+}
+
+/*
+gets the bytes of a page, untouched pages share a page of 0s
+
+image: image to read
+page: page index
+
+returns: pointer to SEGMENT_PAGE_SIZE readable bytes
+*/
+const uint8_t* readSegmentPage(SegmentImage* image, uint32_t page) {
+    if (page >= image->pageCount || image->pages[page] == NULL) {return ZERO_PAGE;}
+    return image->pages[page];
+}
+
+/*
+reads a byte from an image
+
+image: image to read
+addr: byte address
+
+returns: the byte, 0 if never written
+*/
+uint8_t readSegmentByte(SegmentImage* image, uint32_t addr) {
+    return readSegmentPage(image, addr / SEGMENT_PAGE_SIZE)[addr % SEGMENT_PAGE_SIZE];
+}
+
+/*
+writes a byte to an image, committing its page if needed
+
+image: image to write
+addr: byte address, ignored past the end of the image
+val: byte to write
+*/
+void writeSegmentByte(SegmentImage* image, uint32_t addr, uint8_t val) {
+    if (addr >= image->size) {return;}
+    commitSegmentPage(image, addr / SEGMENT_PAGE_SIZE)[addr % SEGMENT_PAGE_SIZE] = val;
+}
+
+/*
+writes a run of bytes to an image, one copy per page
+
+image: image to write
+addr: byte address of the first byte
+data: bytes to write
+len: number of bytes
+*/
+void writeSegmentBytes(SegmentImage* image, uint32_t addr, const uint8_t* data, uint32_t len) {
+    if (addr >= image->size) {return;}
+    if (len > image->size - addr) {len = image->size - addr;}
+    while (len > 0) {
+        uint32_t offset = addr % SEGMENT_PAGE_SIZE;
+        uint32_t chunk = SEGMENT_PAGE_SIZE - offset;
+        if (chunk > len) {chunk = len;}
+        memcpy(commitSegmentPage(image, addr / SEGMENT_PAGE_SIZE) + offset, data, chunk);
+        addr += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/*
+sets a run of bytes to 0, only touching pages that are already committed
+
+image: image to write
+addr: byte address of the first byte
+len: number of bytes
+*/
+void clearSegmentBytes(SegmentImage* image, uint32_t addr, uint32_t len) {
+    if (addr >= image->size) {return;}
+    if (len > image->size - addr) {len = image->size - addr;}
+    while (len > 0) {
+        uint32_t offset = addr % SEGMENT_PAGE_SIZE;
+        uint32_t chunk = SEGMENT_PAGE_SIZE - offset;
+        if (chunk > len) {chunk = len;}
+        uint8_t* page = image->pages[addr / SEGMENT_PAGE_SIZE];
+        if (page != NULL) {memset(page + offset, 0, chunk);}
+        addr += chunk;
+        len -= chunk;
+    }
+}
+
+/*
+writes the start of an image to a binary file, untouched pages are written from a shared page of 0s
+
+image: image to output
+len: number of bytes to write
+output: file to write to
+
+returns: number of bytes written
+*/
+size_t writeSegmentImage(SegmentImage* image, uint32_t len, FILE* output) {
+    size_t written = 0;
+    for (uint32_t page = 0; len > 0; page++) {
+        uint32_t chunk = len < SEGMENT_PAGE_SIZE ? len : SEGMENT_PAGE_SIZE;
+        written += fwrite(readSegmentPage(image, page), 1, chunk, output);
+        len -= chunk;
+    }
+    return written;
+}
@@ -0,0 +1,146 @@
+/*
+line records of a source file, read once and shared by every pass
+lines are split the same way fgets splits them into a 256 byte buffer
+
+Written by Adam Billings
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "SourceIndex.h"
+
+/*
+maps a directive name to its id
+
+name: directive name including the '.'
+length: length of the name
+
+returns: id of the directive
+*/
+static enum DirectiveId internDirective(char* name, int length) {
+    static const char* names[] = {".if", ".ifdef", ".ifndef", ".else", ".elseif", ".elseifdef", ".elseifndef", ".endif", ".macro", ".endmacro", ".rept", ".endr", ".define", ".redef", ".undef"};
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        if ((int)strlen(names[i]) == length && !strncmp(names[i], name, length)) {return (enum DirectiveId)(DIR_IF + i);}
+    }
+    return DIR_OTHER;
+}
+
+/*
+classifies a line read by fgets
+
+sourceLine: record to fill
+line: text of the line
+offset: file position of the line
+length: bytes read for the line
+*/
+static void indexLine(SourceLine* sourceLine, char* line, long offset, long length) {
+    int i = 0;
+    while (i < SOURCE_LINE_BUFFER && isspace(line[i])) {i++;}
+
+    sourceLine->offset = offset;
+    sourceLine->length = (uint8_t)length;
+    sourceLine->indent = (uint8_t)i;
+    sourceLine->directive = DIR_NONE;
+    if (line[i] == '\0' || line[i] == ';') {sourceLine->kind = LINE_EMPTY;}
+    else if (line[i] == '.') {
+        int end = i + 1;
+        while (end < SOURCE_LINE_BUFFER && !isspace(line[end]) && line[end] != ';' && line[end] != '\0') {end++;}
+        sourceLine->kind = LINE_DIRECTIVE;
+        sourceLine->directive = internDirective(line + i, end - i);
+    } else if (i == 0) {sourceLine->kind = LINE_LABEL;}
+    else {sourceLine->kind = LINE_STATEMENT;}
+}
+
+/*
+gets the line records of a file, reading the file the first time
+
+handle: file to index
+
+returns: line records of the file
+*/
+SourceIndex* getSourceIndex(FileHandle* handle) {
+    if (handle->index != NULL) {return handle->index;}
+
+    SourceIndex* index = (SourceIndex*)malloc(sizeof(SourceIndex));
+    unsigned int capacity = 64;
+    index->count = 0;
+    index->lines = (SourceLine*)malloc(capacity * sizeof(SourceLine));
+    index->cursor = 0;
+
+    // read every line once
+    char buffer[SOURCE_LINE_BUFFER];
+    long restorePoint = ftell(handle->fptr);
+    rewind(handle->fptr);
+    long offset = 0;
+    while (fgets(buffer, SOURCE_LINE_BUFFER, handle->fptr) != NULL) {
+        long next = ftell(handle->fptr);
+        if (index->count == capacity) {
+            capacity *= 2;
+            index->lines = (SourceLine*)realloc(index->lines, capacity * sizeof(SourceLine));
+        }
+        indexLine(index->lines + index->count, buffer, offset, next - offset);
+        index->count++;
+        offset = next;
+    }
+    clearerr(handle->fptr);
+    fseek(handle->fptr, restorePoint, SEEK_SET);
+
+    handle->index = index;
+    return index;
+}
+
+/*
+frees the line records of a file
+
+index: records to free
+
+returns: NULL
+*/
+SourceIndex* deleteSourceIndex(SourceIndex* index) {
+    free(index->lines);
+    free(index);
+    return NULL;
+}
+
+/*
+finds the first line starting at or after a file position
+
+index: line records
+offset: file position
+
+returns: index of the line, count of lines if the position is at the end
+*/
+unsigned int findSourceLine(SourceIndex* index, long offset) {
+    unsigned int low = 0;
+    unsigned int high = index->count;
+    while (low < high) {
+        unsigned int mid = low + (high - low) / 2;
+        if (index->lines[mid].offset < offset) {low = mid + 1;}
+        else {high = mid;}
+    }
+    return low;
+}
+
+/*
+gets the record of a line a pass has just read, lines read in order are found without a search
+
+handle: file the line was read from
+offset: file position the line was read at
+line: text of the line, only classified when no record starts at the position
+
+returns: record of the line
+*/
+SourceLine* getSourceLine(FileHandle* handle, long offset, char* line) {
+    SourceIndex* index = getSourceIndex(handle);
+    unsigned int lineIndex = index->cursor;
+    if (lineIndex >= index->count || index->lines[lineIndex].offset != offset) {lineIndex = findSourceLine(index, offset);}
+    if (lineIndex < index->count && index->lines[lineIndex].offset == offset) {
+        index->cursor = lineIndex + 1;
+        return index->lines + lineIndex;
+    }
+
+    // the passes only move to line starts, but a line read from anywhere else is still classified
+    indexLine(&(index->scratch), line, offset, strlen(line));
+    return &(index->scratch);
+}
@@ -0,0 +1,152 @@
+/*
+timeline of the passes, included files, macro expansions and local label reads in the chrome trace event format
+the file can be opened in chrome://tracing or ui.perfetto.dev
+
+Written by Adam Billings
+*/
+
+#include <time.h>
+#include "TraceEvents.h"
+
+// file being written, NULL when not tracing
+static FILE* traceFile = NULL;
+
+// clock when the trace was opened (in seconds)
+static double traceStart;
+
+// events that are open
+static int traceDepth = 0;
+
+// events at or below the floor belong to an enclosing pass and are only closed by it
+static int traceFloor = 0;
+static int passFloors[TRACE_PASS_STACK_SIZE];
+static int passDepth = 0;
+
+/*
+writes a string with json escapes
+
+stream: where to write
+str: string to write
+*/
+static void writeJsonString(FILE* stream, const char* str) {
+    fputc('\"', stream);
+    for (; *str != '\0'; str++) {
+        if (*str == '\"' || *str == '\\') {fprintf(stream, "\\%c", *str);}
+        else if ((unsigned char)*str < 0x20) {fprintf(stream, "\\u%04x", *str);}
+        else {fputc(*str, stream);}
+    }
+    fputc('\"', stream);
+}
+
+/*
+gets the time since the trace was opened
+
+returns: time (in microseconds)
+*/
+static double getTraceTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec + now.tv_nsec * 1e-9 - traceStart) * 1e6;
+}
+
+/*
+starts writing trace events to a file
+
+fileName: file to write
+
+returns: if the file was opened
+*/
+char openTraceEvents(char* fileName) {
+    if (traceFile != NULL) {closeTraceEvents();}
+    traceFile = fopen(fileName, "w");
+    if (traceFile == NULL) {return 0;}
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    traceStart = now.tv_sec + now.tv_nsec * 1e-9;
+    traceDepth = 0;
+    traceFloor = 0;
+    passDepth = 0;
+
+    // the array format is still read if the file is cut short
+    fprintf(traceFile, "[\n");
+    fprintf(traceFile, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"ace3710\"}}");
+    return 1;
+}
+
+/*
+finishes the trace file, closing any event still open
+*/
+void closeTraceEvents() {
+    if (traceFile == NULL) {return;}
+    while (traceDepth > 0) {writeEventEnd();}
+    fprintf(traceFile, "\n]\n");
+    fclose(traceFile);
+    traceFile = NULL;
+}
+
+/*
+starts an event, does nothing when no trace file is open
+
+name: name of the event
+category: kind of event
+handle: file the event starts in, NULL for none
+line: line the event starts on
+*/
+void beginTraceEvent(const char* name, const char* category, FileHandle* handle, unsigned int line) {
+    if (traceFile == NULL) {return;}
+    fprintf(traceFile, ",\n{\"name\": ");
+    writeJsonString(traceFile, name);
+    fprintf(traceFile, ", \"cat\": \"%s\", \"ph\": \"B\", \"ts\": %.3f, \"pid\": 1, \"tid\": 1", category, getTraceTime());
+
+    // macro bodies are read from memory, report the file they were written in
+    if (handle != NULL) {
+        FileHandle* source = (handle->source != NULL) ? handle->source : handle;
+        fprintf(traceFile, ", \"args\": {\"file\": ");
+        writeJsonString(traceFile, source->name);
+        fprintf(traceFile, ", \"line\": %u}", line + 1);
+    }
+    fprintf(traceFile, "}");
+    traceDepth++;
+}
+
+/*
+writes the end of the innermost event
+*/
+static void writeEventEnd() {
+    fprintf(traceFile, ",\n{\"ph\": \"E\", \"ts\": %.3f, \"pid\": 1, \"tid\": 1}", getTraceTime());
+    traceDepth--;
+}
+
+/*
+ends the innermost event, events started before the running pass are left open
+*/
+void endTraceEvent() {
+    if (traceFile == NULL || traceDepth <= traceFloor) {return;}
+    writeEventEnd();
+}
+
+/*
+starts the event of a pass, the pass closes every event started inside of it when it ends
+
+name: name of the pass
+handle: file the pass starts in, NULL for none
+line: line the pass starts on
+*/
+void beginTracePass(const char* name, FileHandle* handle, unsigned int line) {
+    if (traceFile == NULL) {return;}
+    beginTraceEvent(name, "pass", handle, line);
+    if (passDepth < TRACE_PASS_STACK_SIZE) {passFloors[passDepth] = traceFloor;}
+    passDepth++;
+    traceFloor = traceDepth;
+}
+
+/*
+ends the event of the running pass and the events still open inside of it
+*/
+void endTracePass() {
+    if (traceFile == NULL || passDepth == 0) {return;}
+    while (traceDepth > traceFloor) {writeEventEnd();}
+    if (traceDepth > 0) {writeEventEnd();}
+    passDepth--;
+    traceFloor = (passDepth < TRACE_PASS_STACK_SIZE) ? passFloors[passDepth] : traceDepth;
+}
@@ -6,12 +6,16 @@ Written by Adam Billings
 
 #include <stdio.h>
 #include <unistd.h>
+#include <pthread.h>
 #include "ExpressionEvaluation.h"
 #include "DataStructures/List.h"
 #include "DataStructures/StringTable.h"
 #include "MiscAssembler.h"
 #include "ConfigReader.h"
 #include "ProcessMacros.h"
+#include "PassTimer.h"
+#include "TraceEvents.h"
+#include "AssemblerStats.h"
 #include "VarEvaluation.h"
 
 /*
@@ -38,151 +42,588 @@ static List* getVars(char* expr, int exprLen) {
 }
 
 /*
-evaluates a variable assignment
+moves the dependencies captured by a define out of a dependency list
 
-toEvaluate: name to resolve
-toEvaluateLut: LUT to get other vars to evaluate
-parse: output parse information
+dependencies: list of names in the expression
+defines: defines active at the assignment
 
-returns: if an error occured
+returns: list of captured define values
 */
-static char evaluateVar(List* errorList, char* toEvaluate, StringTable toEvaluateLut, StringTable varDefs, StringTable macroDefs, List* visited) {
-    int evalLength = strlen(toEvaluate) + 1;
+static List* captureDefines(List* dependencies, StringTable defines) {
+    List* defs = newList();
+    Node* node = dependencies->head;
+    while (node != NULL) {
+        Node* nextNode = node->next;
+        char* name = *(char**)(node->dataptr);
+        uint16_t* value = (uint16_t*)readStringTable(defines, name, strlen(name) + 1);
+        if (value != NULL) {
+            // append the value to the list
+            DefData defData = {name, *value, 1, 1};
+            appendList(defs, &defData, sizeof(DefData));
+
+            // remove dependency
+            if (node->prev) {node->prev->next = node->next;}
+            else {dependencies->head = node->next;}
+            if (node->next) {node->next->prev = node->prev;}
+            else {dependencies->tail = node->prev;}
+            dependencies->size -= 1;
+            free(node->dataptr);
+            free(node);
+        }
+        node = nextNode;
+    }
+    return defs;
+}
 
-    // nothing needed if already evaluated
-    if (readStringTable(varDefs, toEvaluate, evalLength) != NULL) {
-        return 0;
+/*
+evaluates a single variable assignment whose dependencies are on earlier levels
+
+safe to call from several threads at once, only the entry for the variable is written
+
+graph: assignment graph being evaluated
+v: index of the variable
+scratch: empty table to hold the captured defines, owned by the caller
+*/
+static void evaluateVar(EvalGraph* graph, int v, StringTable scratch) {
+    // cycles are settled before evaluation
+    if (graph->status[v] != VAR_PENDING) {return;}
+
+    // a failed dependency already carries the error
+    for (int e = graph->edgeStart[v]; e < graph->edgeStart[v + 1]; e++) {
+        if (graph->status[graph->edges[e]] != VAR_DONE) {
+            graph->status[v] = VAR_SKIPPED;
+            return;
+        }
     }
 
-    // don't evaluate a bad var
-    if (readStringTable(toEvaluateLut, toEvaluate, evalLength) == NULL) {
-        return 0;
+    // expose the defines captured at the assignment
+    VarEvalData* evalData = graph->nodes[v];
+    for (Node* node = evalData->defines->head; node != NULL; node = node->next) {
+        DefData* defData = (DefData*)(node->dataptr);
+        setStringTableValue(scratch, defData->name, strlen(defData->name) + 1, &(defData->val), 2);
     }
 
-    // get information on the variable
-    VarEvalData evalData = *(VarEvalData*)readStringTable(toEvaluateLut, toEvaluate, evalLength);
+    graph->results[v] = evalShortExpr(evalData->expr, evalData->exprLen, graph->varDefs, scratch);
+    graph->status[v] = graph->results[v].errorMessage == NULL ? VAR_DONE : VAR_FAILED;
 
-    // check for circular dependency
-    for (Node* nodei = visited->head; nodei != NULL; nodei = nodei->next) {
-        if (!strcmp(*(char**)(nodei->dataptr), toEvaluate)) {
-            // get the needed chain length
-            int len;
-            for (Node* nodej = nodei; nodej != NULL; nodej = nodej->next) {
-                len += 4 + strlen(*(char**)(nodej->dataptr));
-            }
-            
-            // get the dependency loop
-            char nameStr[len + 1];
-            sprintf(nameStr, "%s", *(char**)(nodei->dataptr));
-            for (Node* nodej = nodei->next; nodej != NULL; nodej = nodej->next) {
-                sprintf(nameStr, "%s <- %s", nameStr, *(char**)(nodej->dataptr));
+    for (Node* node = evalData->defines->head; node != NULL; node = node->next) {
+        DefData* defData = (DefData*)(node->dataptr);
+        removeStringTableValue(scratch, defData->name, strlen(defData->name) + 1);
+    }
+}
+
+/*
+evaluation thread, takes variables from the current level until the pool stops
+
+arg: pool to work for
+
+returns: NULL
+*/
+static void* evalWorker(void* arg) {
+    EvalPool* pool = (EvalPool*)arg;
+    StringTable scratch = newStringTable();
+    int seenGeneration = 0;
+
+    while (1) {
+        // wait for a level
+        pthread_mutex_lock(&(pool->lock));
+        while (pool->generation == seenGeneration && !pool->stop) {
+            pthread_cond_wait(&(pool->start), &(pool->lock));
+        }
+        if (pool->stop) {pthread_mutex_unlock(&(pool->lock)); break;}
+        seenGeneration = pool->generation;
+        pthread_mutex_unlock(&(pool->lock));
+
+        // take variables until the level is drained
+        int k;
+        while ((k = __atomic_fetch_add(&(pool->next), 1, __ATOMIC_RELAXED)) < pool->end) {
+            evaluateVar(pool->graph, pool->graph->levelNodes[k], scratch);
+        }
+
+        // report back
+        pthread_mutex_lock(&(pool->lock));
+        if (--(pool->active) == 0) {pthread_cond_signal(&(pool->done));}
+        pthread_mutex_unlock(&(pool->lock));
+    }
+
+    deleteStringTable(scratch);
+    return NULL;
+}
+
+/*
+evaluates one level of the graph, spreading it over the pool when it is large enough
+
+graph: assignment graph being evaluated
+pool: worker pool, started on first use
+start: first index of the level in levelNodes
+end: index after the level in levelNodes
+scratch: scratch define table for the calling thread
+*/
+static void evaluateLevel(EvalGraph* graph, EvalPool* pool, int start, int end, StringTable scratch) {
+    // small levels are not worth waking anything up for
+    if (end - start < EVAL_PARALLEL_MIN || pool->threadCount == 0) {
+        for (int k = start; k < end; k++) {
+            evaluateVar(graph, graph->levelNodes[k], scratch);
+        }
+        return;
+    }
+
+    // start the workers
+    if (pool->threads == NULL) {
+        pool->threads = (pthread_t*)malloc(pool->threadCount * sizeof(pthread_t));
+        for (int i = 0; i < pool->threadCount; i++) {
+            if (pthread_create(pool->threads + i, NULL, evalWorker, pool)) {pool->threadCount = i; break;}
+        }
+        if (pool->threadCount == 0) {evaluateLevel(graph, pool, start, end, scratch); return;}
+    }
+
+    // hand out the level and help drain it
+    pthread_mutex_lock(&(pool->lock));
+    pool->next = start;
+    pool->end = end;
+    pool->active = pool->threadCount;
+    pool->generation++;
+    pthread_cond_broadcast(&(pool->start));
+    pthread_mutex_unlock(&(pool->lock));
+    int k;
+    while ((k = __atomic_fetch_add(&(pool->next), 1, __ATOMIC_RELAXED)) < end) {
+        evaluateVar(graph, graph->levelNodes[k], scratch);
+    }
+
+    // wait for stragglers
+    pthread_mutex_lock(&(pool->lock));
+    while (pool->active > 0) {
+        pthread_cond_wait(&(pool->done), &(pool->lock));
+    }
+    pthread_mutex_unlock(&(pool->lock));
+}
+
+/*
+reports a dependency cycle through a variable
+
+errorList: list of errors
+graph: assignment graph being evaluated
+root: index of the variable to start the cycle at
+*/
+static void reportCycle(List* errorList, EvalGraph* graph, int root) {
+    int n = graph->count;
+    int* parent = (int*)malloc(n * sizeof(int));
+    int* queue = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {parent[i] = -2;}
+
+    // find the shortest path back to the root inside its component
+    int head = 0;
+    int tail = 0;
+    int last = root;
+    parent[root] = -1;
+    queue[tail++] = root;
+    while (head < tail) {
+        int u = queue[head++];
+        for (int e = graph->edgeStart[u]; e < graph->edgeStart[u + 1]; e++) {
+            int w = graph->edges[e];
+            if (w == root) {last = u; head = tail; break;}
+            if (graph->component[w] != graph->component[root] || parent[w] != -2) {continue;}
+            parent[w] = u;
+            queue[tail++] = w;
+        }
+    }
+
+    // get the dependency loop, built back to front
+    int count = 0;
+    int len = strlen(graph->names[root]) + 1;
+    for (int v = last; v != -1; v = parent[v]) {
+        queue[count++] = v;
+        len += 4 + strlen(graph->names[v]);
+    }
+    char* chain = (char*)malloc(len * sizeof(char));
+    char* pos = chain;
+    for (int i = count - 1; i >= 0; i--) {
+        pos += sprintf(pos, "%s <- ", graph->names[queue[i]]);
+    }
+    sprintf(pos, "%s", graph->names[root]);
+
+    // push the error
+    appendError(errorList, ERR_CIRCULAR_DEPENDENCY, 0, NULL, chain, graph->nodes[root]->line, 0, strlen(graph->names[root]) + 1, graph->nodes[root]->handle);
+    free(parent);
+    free(queue);
+}
+
+/*
+finds the strongly connected components of the graph with an iterative Tarjan search
+
+roots in source order and children in dependency order number the components in
+the order a depth first evaluation would finish them; components with more than
+one assignment or a self reference are marked as cycles
+
+graph: assignment graph to search
+*/
+static void findComponents(EvalGraph* graph) {
+    int n = graph->count;
+    int* order = (int*)malloc(n * sizeof(int));
+    int* lowLink = (int*)malloc(n * sizeof(int));
+    int* sccStack = (int*)malloc(n * sizeof(int));
+    int* callStack = (int*)malloc(n * sizeof(int));
+    int* callEdge = (int*)malloc(n * sizeof(int));
+    char* onStack = (char*)malloc(n * sizeof(char));
+    for (int i = 0; i < n; i++) {order[i] = -1; onStack[i] = 0;}
+    int counter = 0;
+    int sccTop = 0;
+    int componentCount = 0;
+
+    for (int root = 0; root < n; root++) {
+        if (order[root] != -1) {continue;}
+        int callTop = 0;
+        order[root] = lowLink[root] = counter++;
+        sccStack[sccTop++] = root;
+        onStack[root] = 1;
+        callStack[callTop] = root;
+        callEdge[callTop++] = graph->edgeStart[root];
+
+        while (callTop > 0) {
+            int v = callStack[callTop - 1];
+
+            // walk the next edge
+            if (callEdge[callTop - 1] < graph->edgeStart[v + 1]) {
+                int w = graph->edges[callEdge[callTop - 1]++];
+                if (order[w] == -1) {
+                    order[w] = lowLink[w] = counter++;
+                    sccStack[sccTop++] = w;
+                    onStack[w] = 1;
+                    callStack[callTop] = w;
+                    callEdge[callTop++] = graph->edgeStart[w];
+                } else if (onStack[w] && order[w] < lowLink[v]) {
+                    lowLink[v] = order[w];
+                }
+                continue;
             }
 
-            // push the error
-            char* errorStr = (char*)malloc((35 + evalLength) * sizeof(char));
-            sprintf(errorStr, "Circular dependency: %s <- %s", nameStr, toEvaluate);
-            ErrorData error = {errorStr, evalData.line, 0, strlen(toEvaluate) + 1, evalData.handle};
-            appendList(errorList, &error, sizeof(ErrorData));
-            return 1;
-        }
-    }
-
-    // evaluate the dependencies
-    appendList(visited, &toEvaluate, sizeof(char*));
-    char retVal = 0;
-    for (Node* node = evalData.dependencies->head; node != NULL; node = node->next) {
-        char* curDep = *(char**)(node->dataptr);
-        if (readStringTable(macroDefs, curDep, strlen(curDep) + 1) == NULL) {
-            retVal |= evaluateVar(errorList, *(char**)(node->dataptr), toEvaluateLut, varDefs, macroDefs, visited);
-        }
-    }
-    removeListElement(visited, -1);
-    // evaluate the current node
-    if (!retVal) {
-        // update definitions
-        List* updatedDefs = newList();
-        for (Node* node = evalData.dependencies->head; node != NULL; node = node->next) {
-            char* name = *(char**)(node->dataptr);
-            uint16_t* val = (uint16_t*)readStringTable(macroDefs, name, strlen(name) + 1);
-            if (val != NULL) {
-                DefData defData = {name, *val, 0, 1};
-                appendList(updatedDefs, &defData, sizeof(DefData));
-                removeStringTableValue(macroDefs, name, strlen(name) + 1);
+            // finish the node
+            callTop--;
+            if (callTop > 0 && lowLink[v] < lowLink[callStack[callTop - 1]]) {lowLink[callStack[callTop - 1]] = lowLink[v];}
+            if (lowLink[v] != order[v]) {continue;}
+
+            // close the component
+            int sccSize = 0;
+            int w;
+            do {
+                w = sccStack[--sccTop];
+                onStack[w] = 0;
+                graph->component[w] = componentCount;
+                sccSize++;
+            } while (w != v);
+            char isCycle = sccSize > 1;
+            for (int e = graph->edgeStart[v]; e < graph->edgeStart[v + 1] && !isCycle; e++) {
+                if (graph->edges[e] == v) {isCycle = 1;}
+            }
+            if (isCycle) {
+                for (int j = sccTop; j < sccTop + sccSize; j++) {graph->status[sccStack[j]] = VAR_SKIPPED;}
+                graph->status[v] = VAR_CYCLE;
             }
+            graph->finishOrder[componentCount++] = v;
         }
-        for (Node* node = evalData.defines->head; node != NULL; node = node->next) {
-            DefData* val = (DefData*)(node->dataptr);
-            DefData newData = *val;
-            uint16_t* oldVal = (uint16_t*)readStringTable(macroDefs, val->name, strlen(val->name) + 1);
-            if (oldVal != NULL) {newData.val = *oldVal;}
-            else {newData.hasValue = 0;}
-            appendList(updatedDefs, &newData, sizeof(DefData));
-            setStringTableValue(macroDefs, val->name, strlen(val->name) + 1, &(val->val), 2);
-        }
-        deleteList(evalData.defines);
-
-        // handle the evaluation
-        ExprErrorShort eval = evalShortExpr(evalData.expr, evalData.exprLen, varDefs, macroDefs);
-
-        // undo def updates
-        for (Node* node = updatedDefs->head; node != NULL; node = node->next) {
-            DefData* val = (DefData*)(node->dataptr);
-            if (val->hasValue) {
-                setStringTableValue(macroDefs, val->name, strlen(val->name) + 1, &(val->val), 2);
-            } else {
-                removeStringTableValue(macroDefs, val->name, strlen(val->name));
+    }
+    graph->componentCount = componentCount;
+
+    free(order);
+    free(lowLink);
+    free(sccStack);
+    free(callStack);
+    free(callEdge);
+    free(onStack);
+}
+
+/*
+evaluates all pending variable assignments in dependency order
+
+the assignments are split into topological levels which are evaluated one after
+another, each level on the worker pool when it is large; the reported error is
+always the one a sequential evaluation in finishing order would hit first
+
+errorList: list of errors
+toEvaluate: names of the assignments in source order
+toEvaluateLut: LUT of the assignments, emptied of owned data on return
+varDefs: defined vars
+
+returns: if an error occured
+*/
+static char evaluateVars(List* errorList, List* toEvaluate, StringTable toEvaluateLut, StringTable varDefs) {
+    int n = toEvaluate->size;
+    if (n == 0) {return 0;}
+
+    // index the assignments
+    EvalGraph graph;
+    graph.count = n;
+    graph.varDefs = varDefs;
+    graph.names = (char**)malloc(n * sizeof(char*));
+    graph.nodes = (VarEvalData**)malloc(n * sizeof(VarEvalData*));
+    int edgeCount = 0;
+    int i = 0;
+    for (Node* node = toEvaluate->head; node != NULL; node = node->next) {
+        graph.names[i] = *(char**)(node->dataptr);
+        graph.nodes[i] = (VarEvalData*)readStringTable(toEvaluateLut, graph.names[i], strlen(graph.names[i]) + 1);
+        graph.nodes[i]->index = i;
+        edgeCount += graph.nodes[i]->dependencies->size;
+        i++;
+    }
+
+    // build the dependency edges, names without an assignment are left to the evaluation
+    graph.edgeStart = (int*)malloc((n + 1) * sizeof(int));
+    graph.edges = (int*)malloc((edgeCount + 1) * sizeof(int));
+    edgeCount = 0;
+    for (i = 0; i < n; i++) {
+        graph.edgeStart[i] = edgeCount;
+        for (Node* node = graph.nodes[i]->dependencies->head; node != NULL; node = node->next) {
+            char* dep = *(char**)(node->dataptr);
+            VarEvalData* depData = (VarEvalData*)readStringTable(toEvaluateLut, dep, strlen(dep) + 1);
+            if (depData != NULL) {graph.edges[edgeCount++] = depData->index;}
+        }
+    }
+    graph.edgeStart[n] = edgeCount;
+
+    // find the components
+    graph.component = (int*)malloc(n * sizeof(int));
+    graph.finishOrder = (int*)malloc(n * sizeof(int));
+    graph.status = (char*)malloc(n * sizeof(char));
+    graph.results = (ExprErrorShort*)malloc(n * sizeof(ExprErrorShort));
+    for (i = 0; i < n; i++) {graph.status[i] = VAR_PENDING; graph.results[i].errorMessage = NULL;}
+    findComponents(&graph);
+
+    // assign levels, every dependency finishes before its dependents
+    int* level = (int*)calloc(n, sizeof(int));
+    int levelCount = 0;
+    for (int c = 0; c < graph.componentCount; c++) {
+        int v = graph.finishOrder[c];
+        for (int e = graph.edgeStart[v]; e < graph.edgeStart[v + 1]; e++) {
+            int w = graph.edges[e];
+            if (graph.component[w] != c && level[w] + 1 > level[v]) {level[v] = level[w] + 1;}
+        }
+        if (level[v] + 1 > levelCount) {levelCount = level[v] + 1;}
+    }
+
+    // bucket the evaluated nodes by level, keeping finishing order inside a level
+    int* levelStart = (int*)calloc(levelCount + 1, sizeof(int));
+    graph.levelNodes = (int*)malloc(graph.componentCount * sizeof(int));
+    for (int c = 0; c < graph.componentCount; c++) {levelStart[level[graph.finishOrder[c]] + 1]++;}
+    for (int l = 0; l < levelCount; l++) {levelStart[l + 1] += levelStart[l];}
+    int* levelFill = (int*)malloc(levelCount * sizeof(int));
+    memcpy(levelFill, levelStart, levelCount * sizeof(int));
+    for (int c = 0; c < graph.componentCount; c++) {
+        int v = graph.finishOrder[c];
+        graph.levelNodes[levelFill[level[v]]++] = v;
+    }
+
+    // setup the pool, threads are only started once a level is large enough
+    EvalPool pool;
+    pool.graph = &graph;
+    pool.threads = NULL;
+    pool.threadCount = 0;
+    pool.generation = 0;
+    pool.stop = 0;
+    if (n >= EVAL_PARALLEL_MIN) {
+        long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+        pool.threadCount = (cpuCount > EVAL_MAX_THREADS ? EVAL_MAX_THREADS : (int)cpuCount) - 1;
+        if (pool.threadCount < 0) {pool.threadCount = 0;}
+    }
+    pthread_mutex_init(&(pool.lock), NULL);
+    pthread_cond_init(&(pool.start), NULL);
+    pthread_cond_init(&(pool.done), NULL);
+    StringTable scratch = newStringTable();
+
+    // evaluate level by level, committing between levels so workers only ever read varDefs
+    for (int l = 0; l < levelCount; l++) {
+        evaluateLevel(&graph, &pool, levelStart[l], levelStart[l + 1], scratch);
+        for (int k = levelStart[l]; k < levelStart[l + 1]; k++) {
+            int v = graph.levelNodes[k];
+            if (graph.status[v] == VAR_DONE) {
+                setStringTableValue(varDefs, graph.names[v], strlen(graph.names[v]) + 1, &(graph.results[v].val), 2);
             }
-            if (val->canFree) {free(val->name);}
         }
-        deleteList(updatedDefs);
+    }
 
-        // handle errors
-        if (eval.errorMessage != NULL) {
-            ErrorData error = {eval.errorMessage, evalData.line, eval.errorPos + evalData.col, eval.errorLen, evalData.handle};
-            appendList(errorList, &error, sizeof(ErrorData));
-            return 1;
+    // stop the pool
+    if (pool.threads != NULL) {
+        pthread_mutex_lock(&(pool.lock));
+        pool.stop = 1;
+        pthread_cond_broadcast(&(pool.start));
+        pthread_mutex_unlock(&(pool.lock));
+        for (i = 0; i < pool.threadCount; i++) {pthread_join(pool.threads[i], NULL);}
+        free(pool.threads);
+    }
+    pthread_mutex_destroy(&(pool.lock));
+    pthread_cond_destroy(&(pool.start));
+    pthread_cond_destroy(&(pool.done));
+
+    // report the first error in finishing order
+    char hasError = 0;
+    for (int c = 0; c < graph.componentCount; c++) {
+        int v = graph.finishOrder[c];
+        if (!hasError && graph.status[v] == VAR_FAILED) {
+            appendError(errorList, ERR_MESSAGE, 0, NULL, graph.results[v].errorMessage, graph.nodes[v]->line, graph.results[v].errorPos + graph.nodes[v]->col, graph.results[v].errorLen, graph.nodes[v]->handle);
+            hasError = 1;
+        } else if (!hasError && graph.status[v] == VAR_CYCLE) {
+            reportCycle(errorList, &graph, v);
+            hasError = 1;
+        } else if (graph.status[v] == VAR_FAILED) {
+            free(graph.results[v].errorMessage);
         }
-        setStringTableValue(varDefs, toEvaluate, evalLength, &(eval.val), 2);
+    }
 
-        // remove from the unevaluated set
-        for (Node* node = evalData.dependencies->head; node != NULL; node = node->next) {
+    // free the assignments
+    for (i = 0; i < n; i++) {
+        for (Node* node = graph.nodes[i]->dependencies->head; node != NULL; node = node->next) {
             free(*(char**)(node->dataptr));
         }
-        deleteList(evalData.dependencies);
-        free(evalData.expr);
-        removeStringTableValue(toEvaluateLut, toEvaluate, evalLength);
+        deleteList(graph.nodes[i]->dependencies);
+        for (Node* node = graph.nodes[i]->defines->head; node != NULL; node = node->next) {
+            DefData* defData = (DefData*)(node->dataptr);
+            if (defData->canFree) {free(defData->name);}
+        }
+        deleteList(graph.nodes[i]->defines);
+        free(graph.nodes[i]->expr);
     }
 
-    return retVal;
+    // cleanup
+    deleteStringTable(scratch);
+    free(level);
+    free(levelStart);
+    free(levelFill);
+    free(graph.levelNodes);
+    free(graph.names);
+    free(graph.nodes);
+    free(graph.edgeStart);
+    free(graph.edges);
+    free(graph.component);
+    free(graph.finishOrder);
+    free(graph.status);
+    free(graph.results);
+    return hasError;
 }
 
 /*
-evaluates all local variables between global vars
+evaluates an assignment whose names are all already defined
 
-handle: handle to the file to read; no lines over 255 chars
-errorList: list of errors
-handleList: list of open handles
-segments: segments defined in the configuration
-instructionSize: size of the instructions in "words"
+name: name of the var, freed if it is defined
+nameLength: length of the name
+expr: expression of the assignment
+exprLen: length of the expression
+dependencies: names in the expression, freed if the var is defined
+defs: defines captured at the assignment, freed if the var is defined
+varDefs: defined vars
+defines: current defined vars
 
-returns: parsed global vars
+returns: if the var was defined
 */
-StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, int instructionSize) {
-    // setup
-    unsigned int lineCount = 0;
-    char line[256];
-    StringTable varDefs = newStringTable();
-    StringTable defines = newStringTable();
-    StringTable toEvaluateLut = newStringTable();
-    List* toEvaluate = newList();
-    SegmentDef* activeSegment = NULL;
-    long filePos;
-    Stack* includeStack = newStack();
-    Stack* ifStack = newStack();
-    Stack* segStack = newStack();
-    Stack* macroStack = newStack();
+static char evalKnownVar(char* name, int nameLength, char* expr, int exprLen, List* dependencies, List* defs, StringTable varDefs, StringTable defines) {
+    for (Node* node = dependencies->head; node != NULL; node = node->next) {
+        char* dep = *(char**)(node->dataptr);
+        if (readStringTable(varDefs, dep, strlen(dep) + 1) == NULL) {return 0;}
+    }
 
-    // add registers
+    // failures are left for the full evaluation to report
+    ExprErrorShort exprOut = evalShortExpr(expr, exprLen, varDefs, defines);
+    if (exprOut.errorMessage != NULL) {
+        free(exprOut.errorMessage);
+        return 0;
+    }
+    setStringTableValue(varDefs, name, nameLength + 1, &(exprOut.val), 2);
+
+    // free the assignment
+    for (Node* node = dependencies->head; node != NULL; node = node->next) {free(*(char**)(node->dataptr));}
+    deleteList(dependencies);
+    for (Node* node = defs->head; node != NULL; node = node->next) {
+        DefData* defData = (DefData*)(node->dataptr);
+        if (defData->canFree) {free(defData->name);}
+    }
+    deleteList(defs);
+    free(name);
+    return 1;
+}
+
+/*
+determines if the directives of a macro body read its arguments, through a .rept count or a call to a macro that does
+
+macroData: macro to check, the answer is kept in it
+macroDefs: macro definitions
+
+returns: if the arguments have to be evaluated before assembling
+*/
+static char macroReadsArgs(MacroDefData* macroData, StringTable macroDefs) {
+    if (macroData->readsArgs != 0) {return macroData->readsArgs == 2;}
+    macroData->readsArgs = 1;
+
+    // look for counts and calls
+    FileHandle* handle = macroData->handle;
+    SourceIndex* index = getSourceIndex(handle);
+    long restorePoint = ftell(handle->fptr);
+    char line[SOURCE_LINE_BUFFER];
+    char readsArgs = 0;
+    for (unsigned int i = findSourceLine(index, macroData->start); !readsArgs && i < index->count && index->lines[i].offset < macroData->end; i++) {
+        SourceLine* sourceLine = index->lines + i;
+        if (sourceLine->directive == DIR_REPT) {readsArgs = 1;}
+        else if (sourceLine->kind == LINE_STATEMENT) {
+            fseek(handle->fptr, sourceLine->offset, SEEK_SET);
+            if (fgets(line, SOURCE_LINE_BUFFER, handle->fptr) == NULL) {break;}
+            char* afterName = line + sourceLine->indent;
+            char* name = extractVar(&afterName, strlen(afterName));
+            MacroDefData* callData = (MacroDefData*)readStringTable(macroDefs, name, strlen(name) + 1);
+            readsArgs = callData != NULL && macroReadsArgs(callData, macroDefs);
+            free(name);
+        }
+    }
+    fseek(handle->fptr, restorePoint, SEEK_SET);
+
+    if (readsArgs) {macroData->readsArgs = 2;}
+    return readsArgs;
+}
+
+/*
+evaluates the arguments of a macro call for the directives of its body
+
+args: text after the macro name
+argCount: number of parameters of the macro
+varDefs: defined vars
+defines: current defined vars
+known: output per argument if it could be evaluated, NULL when they all could
+
+returns: argument values
+*/
+static uint16_t* evalMacroCallArgs(char* args, int argCount, StringTable varDefs, StringTable defines, char** known) {
+    uint16_t* argVals = (uint16_t*)calloc(argCount + 1, sizeof(uint16_t));
+    *known = NULL;
+    if (argCount == 0) {return argVals;}
+
+    // the assembler reports a wrong count
+    int found = isValidLineEnding(args, strlen(args)) ? 0 : countArgs(args, strlen(args));
+    if (found != argCount) {
+        *known = (char*)calloc(argCount, sizeof(char));
+        return argVals;
+    }
+
+    // arguments that use later names are left unknown
+    List* argList = extractArgs(args, strlen(args));
+    int argIndex = 0;
+    for (Node* node = argList->head; node != NULL; node = node->next) {
+        char* expr = *(char**)(node->dataptr);
+        ExprErrorShort exprOut = evalShortExpr(expr, strlen(expr), varDefs, defines);
+        if (exprOut.errorMessage == NULL) {argVals[argIndex] = exprOut.val;}
+        else {
+            if (*known == NULL) {*known = (char*)memset(malloc(argCount * sizeof(char)), 1, argCount * sizeof(char));}
+            (*known)[argIndex] = 0;
+            free(exprOut.errorMessage);
+        }
+        free(expr);
+        argIndex++;
+    }
+    deleteList(argList);
+    return argVals;
+}
+
+/*
+defines the register names as vars
+
+varDefs: table to add the registers to
+*/
+void addRegisterVars(StringTable varDefs) {
     const uint16_t vals_[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
     setStringTableValue(varDefs, "r0", 3, vals_ + 0, 2);
     setStringTableValue(varDefs, "r1", 3, vals_ + 1, 2);
@@ -202,6 +643,36 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
     setStringTableValue(varDefs, "r15", 4, vals_ + 15, 2);
     setStringTableValue(varDefs, "ra", 3, vals_ + 14, 2);
     setStringTableValue(varDefs, "sp", 3, vals_ + 15, 2);
+}
+
+/*
+evaluates all local variables between global vars
+
+handle: handle to the file to read; no lines over 255 chars
+errorList: list of errors
+handleList: list of open handles
+segments: segments defined in the configuration
+instructionSize: size of the instructions in "words"
+
+returns: parsed global vars
+*/
+StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, int instructionSize) {
+    // setup
+    unsigned int lineCount = 0;
+    char line[256];
+    StringTable varDefs = newStringTable();
+    StringTable defines = newStringTable();
+    StringTable toEvaluateLut = newStringTable();
+    List* toEvaluate = newList();
+    SegmentDef* activeSegment = NULL;
+    long filePos;
+    PersistentStack* includeStack = newPersistentStack();
+    PersistentStack* ifStack = newPersistentStack();
+    PersistentStack* segStack = newPersistentStack();
+    PersistentStack* macroStack = newPersistentStack();
+
+    // add registers
+    addRegisterVars(varDefs);
 
     while (1) {
         // handle new line eof
@@ -221,12 +692,13 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
         if (feof(handle->fptr)) {break;}
 
         if (fgets(line, 256, handle->fptr) == NULL && !feof(handle->fptr)) {return NULL;}
+        countPassLine();
 
         // handle non-var lines
         if (!isValidNameChar(line[0]) || (line[0] >= '0' && line[0] <= '9')) {
             // error on the start of the line
             if (line[0] == '.') {
-                    handle = executeType2Macro(handle, errorList, handleList, line, strlen(line), &lineCount, 0, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize);
+                    handle = executeType2Macro(handle, errorList, handleList, line, strlen(line), &lineCount, 0, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize, varDefs);
                     if (handle == NULL) {break;}
             } else if (!isspace(line[0]) && line[0] != '\0' && line[0] != '@' && line[0] != ';') {
                 // get the length of the error
@@ -237,14 +709,11 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
                 line[i] = '\0';
 
                 // append the error
-                char* errorStr = (char*)malloc((36 + i) * sizeof(char));
-                sprintf(errorStr, "Invalid constant or lable name \"%s\"", line);
-                ErrorData error = {errorStr, lineCount, 0, i, handle};
-                appendList(errorList, &error, sizeof(ErrorData));
+                appendError(errorList, ERR_INVALID_NAME, 0, NULL, (char*)memcpy(malloc(i + 1), line, i + 1), lineCount, 0, i, handle);
             } else if (isspace(line[0])) {
                 unsigned int i = countWhitespaceChars(line, strlen(line));
                 if (line[i] == '.') {
-                    handle = executeType2Macro(handle, errorList, handleList, line + i, strlen(line + i), &lineCount, i, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize);
+                    handle = executeType2Macro(handle, errorList, handleList, line + i, strlen(line + i), &lineCount, i, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize, varDefs);
                     if (handle == NULL) {break;}
                 } else if (!isValidLineEnding(line, strlen(line))) {
                     // check for macro
@@ -253,30 +722,28 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
                     if (readStringTable(macroDefs, macroName, strlen(macroName) + 1) != NULL) {
 
                         // transfer position to the macro
-                        IncludeReturnData retData = {handle, 0, lineCount, errorList->size};
+                        MacroDefData* macroDef = (MacroDefData*)readStringTable(macroDefs, macroName, strlen(macroName) + 1);
+                        MacroDefData macroData = *macroDef;
+                        beginTraceEvent(macroName, "macro", handle, lineCount);
+                        IncludeReturnData retData = {handle, 0, lineCount, errorList->size, NULL, macroData.vars->size};
+                        if (macroReadsArgs(macroDef, macroDefs)) {retData.args = evalMacroCallArgs(afterMacro, macroData.vars->size, varDefs, defines, &(retData.known));}
                         retData.filePosition = ftell(handle->fptr);
-                        pushStack(macroStack, &retData, sizeof(IncludeReturnData));
-                        MacroDefData macroData = *(MacroDefData*)readStringTable(macroDefs, macroName, strlen(macroName) + 1);
-                        handle = macroData.handle;
+                        pushPersistentStack(macroStack, &retData, sizeof(IncludeReturnData));
+                        restoreMacroArgs(macroStack);
+                        countMacroDepth(macroStack->size);
+                        handle = enterMacroBody(&macroData);
                         lineCount = macroData.line + 1;
-                        fseek(handle->fptr, macroData.start, SEEK_SET);
                         continue;
                     }
                     // handle as instruction
                     if (activeSegment == NULL) {
-                        char* errorStr = (char*)malloc(18 * sizeof(char));
-                        sprintf(errorStr, "No active segment");
-                        ErrorData errorData = {errorStr, lineCount, i, strlen(macroName), handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, lineCount, i, strlen(macroName), handle);
                         lineCount++;
                         continue;
                     }
                     activeSegment->writeAddr += instructionSize;
                     if (activeSegment->writeAddr > activeSegment->size) {
-                        char* errorStr = (char*)malloc((25 + strlen(activeSegment->name)) * sizeof(char));
-                        sprintf(errorStr, "Segment %s size exceeded", activeSegment->name);
-                        ErrorData errorData = {errorStr, lineCount, 0, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
+                        appendError(errorList, ERR_SEGMENT_SIZE, 0, activeSegment->name, NULL, lineCount, 0, 1, handle);
                         break;
                     }
                 }
@@ -294,16 +761,13 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
         // no definitions in a macro
         if (macroStack->size > 0) {
             // prevent a stack trace
-            for (Node* node = macroStack->head; node != NULL; node = node->next) {
+            for (StackFrame* node = macroStack->head; node != NULL; node = node->next) {
                 IncludeReturnData* retData = (IncludeReturnData*)(node->dataptr);
                 (retData->errorCount)++;
             }
 
             // error
-            char* errorStr = (char*)malloc(54 * sizeof(char));
-            sprintf(errorStr, "Cannot declare global variables in a macro definition");
-            ErrorData errorData = {errorStr, lineCount, 0, strlen(name), handle};
-            appendList(errorList, &errorData, sizeof(ErrorData));
+            appendError(errorList, ERR_GLOBAL_IN_MACRO, 0, NULL, NULL, lineCount, 0, strlen(name), handle);
             free(name);
             lineCount++;
             continue;
@@ -312,23 +776,15 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
         // prevent repeat definitions
         if (readStringTable(varDefs, name, nameLength + 1) != NULL || readStringTable(toEvaluateLut, name, nameLength + 1) != NULL) {
             // append repeat error
-            line[nameLength] = '\0';
-            char* errorStr = (char*)malloc((45 + nameLength) * sizeof(char));
-            sprintf(errorStr, "Repeat definition for constant or lable \"%s\"", line);
-            ErrorData error = {errorStr, lineCount, 0, nameLength, handle};
-            appendList(errorList, &error, sizeof(ErrorData));
+            appendError(errorList, ERR_REPEAT_DEFINITION, 0, NULL, name, lineCount, 0, nameLength, handle);
             lineCount++;
-            free(name);
             continue;
         }
 
         // handle label
         if (endOfVar[0] == ':') {
             if (activeSegment == NULL) {
-                char* errorStr = (char*)malloc(18 * sizeof(char));
-                sprintf(errorStr, "No active segment");
-                ErrorData errorData = {errorStr, lineCount, (endOfVar - line), 1, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
+                appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, lineCount, (endOfVar - line), 1, handle);
                 lineCount++;
                 free(name);
                 continue;
@@ -338,7 +794,7 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
             if (strlen(endOfVar) > 1) {
                 unsigned int i = countWhitespaceChars(endOfVar + 1, strlen(endOfVar + 1));
                 if (endOfVar[i + 1] == '.') {
-                        handle = executeType2Macro(handle, errorList, handleList, endOfVar + i + 1, strlen(endOfVar + i + 1), &lineCount, i + 1, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize);
+                        handle = executeType2Macro(handle, errorList, handleList, endOfVar + i + 1, strlen(endOfVar + i + 1), &lineCount, i + 1, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize, varDefs);
                         if (handle == NULL) {break;}
                 }
             }
@@ -357,89 +813,62 @@ StringTable readGlobalVars(FileHandle* handle, List* errorList, List* handleList
 
         // error if no assignment
         if (endOfVar[0] != '=') {
-            char* errorStr = (char*)malloc(20 * sizeof(char));
-            sprintf(errorStr, "Expected assignment");
-            ErrorData error = {errorStr, lineCount, (endOfVar - line), nameLength, handle};
-            appendList(errorList, &error, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_ASSIGNMENT, 0, NULL, NULL, lineCount, (endOfVar - line), nameLength, handle);
             lineCount++;
             free(name);
             continue;
         }
 
-        // add assignment to the evaluation
-        appendList(toEvaluate, &name, sizeof(char*));
+        // find the expression
         List* dependencies = getVars(endOfVar, 256 - (endOfVar - line));
-        List* defs = newList();
-        for (Node* node = dependencies->head; node != NULL; node = node->next) {
-            char* name = *(char**)(node->dataptr);
-            uint16_t* value = (uint16_t*)readStringTable(defines, name, strlen(name) + 1);
-            if (value != NULL) {
-                // append the value to the list
-                DefData defData = {name, *value, 1, 1};
-                appendList(defs, &defData, sizeof(DefData));
-
-                // remove dependency
-                if (node->prev) {node->prev->next = node->next;}
-                else {dependencies->head = NULL;}
-                if (node->next) {node->next->prev = node->prev;}
-                else {dependencies->tail = NULL;}
-                dependencies->size -= 1;
-                Node* prevNode = node;
-                node = node->next;
-                free(prevNode->dataptr);
-                free(prevNode);
-                if (node == NULL) {break;}
-            }
-        }
+        List* defs = captureDefines(dependencies, defines);
         int i;
         for (i = 0; i < (256 - (endOfVar - line)); i++) {
             if (endOfVar[i] == '\n' || endOfVar[i] == '\0' || endOfVar[i] == ';') {
                 break;
             }
         }
+
+        // evaluate it now if every name is known, so the directives after it can use it
+        if (evalKnownVar(name, nameLength, endOfVar + 1, i - 1, dependencies, defs, varDefs, defines)) {
+            lineCount++;
+            continue;
+        }
+
+        // add assignment to the evaluation
+        appendList(toEvaluate, &name, sizeof(char*));
         char* expr = (char*)memcpy(malloc(strlen(endOfVar + 1) + 1), endOfVar + 1, strlen(endOfVar + 1) + 1);
-        VarEvalData evalData = {dependencies, defs, expr, i - 1, lineCount, (endOfVar - line) + 1, handle};
+        VarEvalData evalData = {dependencies, defs, expr, i - 1, lineCount, (endOfVar - line) + 1, handle, 0};
         setStringTableValue(toEvaluateLut, name, nameLength + 1, &evalData, sizeof(VarEvalData));
 
         lineCount++;
     }
 
-    // evaluate the vars 
-    List* visited = newList();
-    for (Node* nodei = toEvaluate->head; nodei != NULL; nodei = nodei->next) {
-        char* name = *(char**)(nodei->dataptr);
-        if (evaluateVar(errorList, name, toEvaluateLut, varDefs, defines, newList())) {
-            // clear the table
-            for (Node* nodej = toEvaluate->head; nodej != NULL; nodej = nodej->next) {
-                char* nameToClear = *(char**)(nodei->dataptr);
-                VarEvalData* lutValue = (VarEvalData*)readStringTable(toEvaluateLut ,nameToClear, strlen(nameToClear) + 1);
-                if (lutValue != NULL) {
-                    for (Node* nodek = lutValue->dependencies->head; nodek != NULL; nodek = nodek -> next) {
-                        free(*(char**)(nodek->dataptr));
-                    }
-                    deleteList(lutValue->dependencies);
-                    free(lutValue->expr);
-                    removeStringTableValue(toEvaluateLut, nameToClear, strlen(nameToClear) + 1);
-                }
-            }
-            break;
-        }
-    }
+    // evaluate the vars
+    evaluateVars(errorList, toEvaluate, toEvaluateLut, varDefs);
 
     // clear the evaluation list
     for (Node* node = toEvaluate->head; node != NULL; node = node->next) {
         free(*(char**)(node->dataptr));
     }
 
+    // drop the calls left open
+    while (macroStack->size > 0) {
+        IncludeReturnData* retData = (IncludeReturnData*)popPersistentStack(macroStack);
+        free(retData->args);
+        free(retData->known);
+        free(retData);
+    }
+    setMacroArgs(NULL, 0, NULL);
+
     // cleanup
     deleteList(toEvaluate);
-    deleteList(visited);
-    deleteStack(ifStack);
-    deleteStack(segStack);
-    deleteStack(includeStack);
-    deleteStack(macroStack);
+    deletePersistentStack(ifStack);
+    deletePersistentStack(segStack);
+    deletePersistentStack(includeStack);
+    deletePersistentStack(macroStack);
     deleteStringTable(defines);
-    deleteStringTable(toEvaluateLut);// known to be empty
+    deleteStringTable(toEvaluateLut);
     return varDefs;
 }
 
@@ -460,7 +889,7 @@ macroStack_ macroStack to copy
 
 returns: parsed global vars
 */
-char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, StringTable defines, int instructionSize, List* localVars, SegmentDef* activeSeg, unsigned int lineCount, Stack* includeStack_, Stack* ifStack_, Stack* segStack_, Stack* macroStack_) {
+char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List* segments, StringTable macroDefs, StringTable varDefs, StringTable defines, int instructionSize, List* localVars, SegmentDef* activeSeg, unsigned int lineCount, PersistentStack* includeStack_, PersistentStack* ifStack_, PersistentStack* segStack_, PersistentStack* macroStack_) {
     // setup
     char line[256];
     StringTable toEvaluateLut = newStringTable();
@@ -468,27 +897,15 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
     List* defUpdates = newList();
     SegmentDef* activeSegment = activeSeg;
     long filePos;
-    Stack* includeStack = newStack();
-    Stack* ifStack = newStack();
-    Stack* segStack = newStack();
-    Stack* macroStack = newStack();
     FileHandle* retHandle = handle;
     long retPos;
     retPos = ftell(handle->fptr);
 
-    // copy the stacks
-    for (Node* node = includeStack_->head; node != NULL; node = node->next) {
-        appendList(includeStack, node->dataptr, sizeof(IncludeReturnData));
-    }
-    for (Node* node = ifStack_->head; node != NULL; node = node->next) {
-        appendList(ifStack, node->dataptr, sizeof(PosData));
-    }
-    for (Node* node = segStack_->head; node != NULL; node = node->next) {
-        appendList(segStack, node->dataptr, sizeof(SegmentDef));
-    }
-    for (Node* node = macroStack_->head; node != NULL; node = node->next) {
-        appendList(macroStack, node->dataptr, sizeof(IncludeReturnData));
-    }
+    // snapshot the stacks, frames are shared with the caller
+    PersistentStack* includeStack = copyPersistentStack(includeStack_);
+    PersistentStack* ifStack = copyPersistentStack(ifStack_);
+    PersistentStack* segStack = copyPersistentStack(segStack_);
+    PersistentStack* macroStack = copyPersistentStack(macroStack_);
 
     // clear local vars
     for (Node* node = localVars->head; node != NULL; node = node->next) {
@@ -521,24 +938,32 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
         // kill on eof
         if (feof(handle->fptr)) {break;}
 
-        if (fgets(line, 256, handle->fptr) == NULL && !feof(handle->fptr)) {return 1;}
+        long linePos = ftell(handle->fptr);
+        SourceLine* sourceLine = NULL;
+        if (fgets(line, 256, handle->fptr) != NULL) {sourceLine = getSourceLine(handle, linePos, line);}
+        else if (!feof(handle->fptr)) {return 1;}
+        countPassLine();
 
         // handle non-var lines
         if (line[0] != '@') {
-            // error on the start of the line
-            if (line[0] == '.') {
-                char* afterName;
-                char* macroName = extractMacro(line, strlen(line), &afterName);
-                if (!strcmp(macroName, ".define") || !strcmp(macroName, ".redef")) {
+            if (sourceLine == NULL || sourceLine->kind == LINE_EMPTY) {
+                // nothing to read
+            } else if (sourceLine->kind == LINE_LABEL) {
+                // break on global var
+                break;
+            } else if (sourceLine->kind == LINE_DIRECTIVE) {
+                unsigned int i = sourceLine->indent;
+                char* afterName = line + i + 1;
+                while (!isspace(afterName[0]) && afterName[0] != ';' && afterName[0] != '\0') {afterName++;}
+                if (sourceLine->directive == DIR_DEFINE || sourceLine->directive == DIR_REDEF) {
                     char* afterVar;
-                    unsigned int j = countWhitespaceChars(afterName, 249);
-                    char* varName = getVarName(afterName + j, 249 - j, &afterVar);
+                    unsigned int j = countWhitespaceChars(afterName, 249 - i);
+                    char* varName = getVarName(afterName + j, 249 - i - j, &afterVar);
                     uint16_t assignValue = 0;
 
                     // log a change
                     char hasMatch = 0;
-                    for (Node* node = defUpdates->head; node != NULL; node = node->next)
-                    {
+                    for (Node* node = defUpdates->head; node != NULL; node = node->next) {
                         DefData* oldData = (DefData*)(node->dataptr);
                         if (!strcmp(oldData->name, varName)) {
                             hasMatch = 1;
@@ -550,7 +975,7 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
                         DefData defData = {varName, 0, 1, 1};
                         if (val != NULL) {defData.val = *val;}
                         else {defData.hasValue = 0;}
-                            appendList(defUpdates, &defData, sizeof(DefData));
+                        appendList(defUpdates, &defData, sizeof(DefData));
                     }
 
                     // parse expression
@@ -559,10 +984,10 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
                         assignValue = exprOut.val;
                     }
                     setStringTableValue(defines, varName, strlen(varName) + 1, &assignValue, 2);
-                } else if (!strcmp(macroName, ".undef")) {
+                } else if (sourceLine->directive == DIR_UNDEF) {
                     char* afterVar;
-                    unsigned int j = countWhitespaceChars(afterName, 249);
-                    char* varName = getVarName(afterName + j, 249 - j, &afterVar);
+                    unsigned int j = countWhitespaceChars(afterName, 249 - i);
+                    char* varName = getVarName(afterName + j, 249 - i - j, &afterVar);
 
                     // log a change
                     char hasMatch = 0;
@@ -582,108 +1007,53 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
                     }
 
                     removeStringTableValue(defines, varName, strlen(varName) + 1);
-                } else if (macroStack->size > 0 || strcmp(macroName, ".endmacro")) {
-                    handle = executeType2Macro(handle, errorList, handleList, line, strlen(line), &lineCount, 0, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize);
-                    if (handle == NULL) {free(macroName); break;}
+                } else if (startStackSize > 0 && macroStack->size == startStackSize && (sourceLine->directive == DIR_ENDMACRO || sourceLine->directive == DIR_ENDR)) {
+                    // the block belongs to the caller, which ends it
+                    IncludeReturnData* retData = (IncludeReturnData*)peekPersistentStack(macroStack);
+                    if (errorList->size > retData->errorCount) {
+                        if (sourceLine->directive == DIR_ENDR) {appendError(errorList, ERR_REPT_TRACE, 0, NULL, NULL, retData->returnLine, i, 5, retData->returnFile);}
+                        else {appendError(errorList, ERR_MACRO_TRACE, 0, NULL, NULL, retData->returnLine, 0, 1, retData->returnFile);}
+                    }
+                    break;
+                } else if (macroStack->size > 0 || sourceLine->directive != DIR_ENDMACRO) {
+                    handle = executeType2Macro(handle, errorList, handleList, line + i, strlen(line + i), &lineCount, i, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize, varDefs);
+                    if (handle == NULL) {break;}
                 } else {
-                    free(macroName);
-                    printf("t\n");
+                    if (i == 0) {printf("t\n");}
                     break;
                 }
-                free(macroName);
-            } else if (!isspace(line[0]) && line[0] != '\0' && line[0] != ';') {
-                // break on global var
-                break;
-            } else if (isspace(line[0])) {
-                unsigned int i = countWhitespaceChars(line, strlen(line));
-                if (line[i] == '.') {
-                    char* afterName;
-                    char* macroName = extractMacro(line + i, strlen(line + i), &afterName);
-                    if (!strcmp(macroName, ".define") || !strcmp(macroName, ".redef")) {
-                        char* afterVar;
-                        unsigned int j = countWhitespaceChars(afterName, 249 - i);
-                        char* varName = getVarName(afterName + j, 249 - i - j, &afterVar);
-                        uint16_t assignValue = 0;
-
-                        // log a change
-                        char hasMatch = 0;
-                        for (Node* node = defUpdates->head; node != NULL; node = node->next) {
-                            DefData* oldData = (DefData*)(node->dataptr);
-                            if (!strcmp(oldData->name, varName)) {
-                                hasMatch = 1;
-                                break;
-                            }
-                        }
-                        if (!hasMatch) {
-                            uint16_t* val = (uint16_t*)readStringTable(defines, varName, strlen(varName) + 1);
-                            DefData defData = {varName, 0, 1, 1};
-                            if (val != NULL) {defData.val = *val;}
-                            else {defData.hasValue = 0;}
-                            appendList(defUpdates, &defData, sizeof(DefData));
-                        }
-
-                        // parse expression
-                        if (!isValidLineEnding(afterVar, 256 - (afterVar - line))) {
-                            ExprErrorShort exprOut = evalShortExpr(afterVar, strlen(afterVar), defines, defines);
-                            assignValue = exprOut.val;
-                        }
-                        setStringTableValue(defines, varName, strlen(varName) + 1, &assignValue, 2);
-                    } else if (!strcmp(macroName, ".undef")) {
-                        char* afterVar;
-                        unsigned int j = countWhitespaceChars(afterName, 249 - i);
-                        char* varName = getVarName(afterName + j, 249 - i - j, &afterVar);
-
-                        // log a change
-                        char hasMatch = 0;
-                        for (Node* node = defUpdates->head; node != NULL; node = node->next) {
-                            DefData* oldData = (DefData*)(node->dataptr);
-                            if (!strcmp(oldData->name, varName)) {
-                                hasMatch = 1;
-                                break;
-                            }
-                        }
-                        if (!hasMatch) {
-                            uint16_t* val = (uint16_t*)readStringTable(defines, varName, strlen(varName) + 1);
-                            DefData defData = {varName, 0, 1, 1};
-                            if (val != NULL) {defData.val = *val;}
-                            else {defData.hasValue = 0;}
-                            appendList(defUpdates, &defData, sizeof(DefData));
-                        }
-
-                        removeStringTableValue(defines, varName, strlen(varName) + 1);
-                    } else if (macroStack->size > 0 || strcmp(macroName, ".endmacro")) {
-                        handle = executeType2Macro(handle, errorList, handleList, line + i, strlen(line + i), &lineCount, i, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize);
-                        if (handle == NULL) {free(macroName); break;}
-                    } else {
-                        free(macroName);
-                        break;
-                    }
+            } else {
+                // check for macro
+                unsigned int i = sourceLine->indent;
+                char* afterMacro = line + i;
+                char* macroName = extractVar(&afterMacro, strlen(line + i));
+                MacroDefData* macroDef = (MacroDefData*)readStringTable(macroDefs, macroName, strlen(macroName) + 1);
+                if (macroDef != NULL) {
+                    // transfer position to the macro
+                    MacroDefData macroData = *macroDef;
+                    beginTraceEvent(macroName, "macro", handle, lineCount);
+                    IncludeReturnData retData = {handle, 0, lineCount, errorList->size, NULL, macroData.vars->size};
+                    if (macroReadsArgs(macroDef, macroDefs)) {retData.args = evalMacroCallArgs(afterMacro, macroData.vars->size, varDefs, defines, &(retData.known));}
+                    retData.filePosition = ftell(handle->fptr);
+                    pushPersistentStack(macroStack, &retData, sizeof(IncludeReturnData));
+                    restoreMacroArgs(macroStack);
+                    countMacroDepth(macroStack->size);
+                    handle = enterMacroBody(&macroData);
+                    lineCount = macroData.line + 1;
                     free(macroName);
-                } else if (!isValidLineEnding(line, strlen(line))) {
-                    // check for macro
-                    char* afterMacro = line + i;
-                    char* macroName = extractVar(&afterMacro, strlen(line + i));
-                    if (readStringTable(macroDefs, macroName, strlen(macroName) + 1) != NULL) {
-                        // transfer position to the macro
-                        IncludeReturnData retData = {handle, 0, lineCount, errorList->size};
-                        retData.filePosition = ftell(handle->fptr);
-                        pushStack(macroStack, &retData, sizeof(IncludeReturnData));
-                        MacroDefData macroData = *(MacroDefData*)readStringTable(macroDefs, macroName, strlen(macroName) + 1);
-                        handle = macroData.handle;
-                        lineCount = macroData.line + 1;
-                        fseek(handle->fptr, macroData.start, SEEK_SET);
-                        continue;
-                    }
-                    
-                    // handle as instruction
-                    activeSegment->writeAddr += instructionSize;
-                    if (activeSegment->writeAddr > activeSegment->size) {
-                        char* errorStr = (char*)malloc((25 + strlen(activeSegment->name)) * sizeof(char));
-                        sprintf(errorStr, "Segment %s size exceeded", activeSegment->name);
-                        ErrorData errorData = {errorStr, lineCount, 0, 1, handle};
-                        appendList(errorList, &errorData, sizeof(ErrorData));
-                        break;
-                    }
+                    continue;
+                }
+
+                // handle as instruction, the assembler reports a missing segment
+                free(macroName);
+                if (activeSegment == NULL) {
+                    lineCount++;
+                    continue;
+                }
+                activeSegment->writeAddr += instructionSize;
+                if (activeSegment->writeAddr > activeSegment->size) {
+                    appendError(errorList, ERR_SEGMENT_SIZE, 0, activeSegment->name, NULL, lineCount, 0, 1, handle);
+                    break;
                 }
             }
 
@@ -710,29 +1080,19 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
         // prevent repeat definitions
         if (readStringTable(varDefs, name, nameLength + 1) != NULL || readStringTable(toEvaluateLut, name, nameLength + 1) != NULL) {
             // append repeat error
-            line[nameLength] = '\0';
-            char* errorStr = (char*)malloc((45 + nameLength) * sizeof(char));
-            sprintf(errorStr, "Repeat definition for constant or lable \"%s\"", line);
-            ErrorData error = {errorStr, lineCount, 0, nameLength, handle};
-            appendList(errorList, &error, sizeof(ErrorData));
+            appendError(errorList, ERR_REPEAT_DEFINITION, 0, NULL, name, lineCount, 0, nameLength, handle);
             lineCount++;
-            free(name);
             continue;
         }
 
         // handle label
         if (endOfVar[0] == ':') {
             if (activeSegment == NULL) {
-                char* errorStr = (char*)malloc(18 * sizeof(char));
-                sprintf(errorStr, "No active segment");
-                ErrorData errorData = {errorStr, lineCount, (endOfVar - line), 1, handle};
-                appendList(errorList, &errorData, sizeof(ErrorData));
-                uint16_t writeVal = activeSegment->writeAddr + activeSegment->startAddr;
-                setStringTableValue(varDefs, name, nameLength + 1, &writeVal, 2);
+                appendError(errorList, ERR_NO_SEGMENT, 0, NULL, NULL, lineCount, (endOfVar - line), 1, handle);
                 if (strlen(endOfVar) > 1) {
                     unsigned int i = countWhitespaceChars(endOfVar + 1, strlen(endOfVar + 1));
                     if (endOfVar[i + 1] == '.') {
-                            handle = executeType2Macro(handle, errorList, handleList, endOfVar + i + 1, strlen(endOfVar + i + 1), &lineCount, i + 1, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize);
+                            handle = executeType2Macro(handle, errorList, handleList, endOfVar + i + 1, strlen(endOfVar + i + 1), &lineCount, i + 1, includeStack, ifStack, segStack, macroStack, defines, &activeSegment, segments, macroDefs, instructionSize, varDefs);
                             if (handle == NULL) {break;}
                     }
                 }
@@ -757,10 +1117,7 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
 
         // error if no assignment
         if (endOfVar[0] != '=') {
-            char* errorStr = (char*)malloc(20 * sizeof(char));
-            sprintf(errorStr, "Expected assignment");
-            ErrorData error = {errorStr, lineCount, (endOfVar - line), nameLength, handle};
-            appendList(errorList, &error, sizeof(ErrorData));
+            appendError(errorList, ERR_EXPECTED_ASSIGNMENT, 0, NULL, NULL, lineCount, (endOfVar - line), nameLength, handle);
             lineCount++;
             free(name);
             continue;
@@ -769,28 +1126,7 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
         // add assignment to the evaluation
         appendList(toEvaluate, &name, sizeof(char*));
         List* dependencies = getVars(endOfVar, 256 - ((endOfVar - line)));
-        List* defs = newList();
-        for (Node* node = dependencies->head; node != NULL; node = node->next) {
-            char* name = *(char**)(node->dataptr);
-            uint16_t* value = (uint16_t*)readStringTable(defines, name, strlen(name) + 1);
-            if (value != NULL) {
-                // append the value to the list
-                DefData defData = {name, *value, 1, 1};
-                appendList(defs, &defData, sizeof(DefData));
-
-                // remove dependency
-                if (node->prev) {node->prev->next = node->next;}
-                else {dependencies->head = NULL;}
-                if (node->next) {node->next->prev = node->prev;}
-                else {dependencies->tail = NULL;}
-                dependencies->size -= 1;
-                Node* prevNode = node;
-                node = node->next;
-                free(prevNode->dataptr);
-                free(prevNode);
-                if (node == NULL) {break;}
-            }
-        }
+        List* defs = captureDefines(dependencies, defines);
         int i;
         for (i = 0; i < (256 - ((endOfVar - line))); i++) {
             if (endOfVar[i] == '\n' || endOfVar[i] == '\0' || endOfVar[i] == ';') {
@@ -798,39 +1134,29 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
             }
         }
         char* expr = (char*)memcpy(malloc(strlen(endOfVar + 1) + 1), endOfVar + 1, strlen(endOfVar + 1) + 1);
-        VarEvalData evalData = {dependencies, defs, expr, i - 1, lineCount, (endOfVar - line) + 1, handle};
+        VarEvalData evalData = {dependencies, defs, expr, i - 1, lineCount, (endOfVar - line) + 1, handle, 0};
         setStringTableValue(toEvaluateLut, name, nameLength + 1, &evalData, sizeof(VarEvalData));
 
         lineCount++;
     }
 
-    // evaluate the vars 
-    List* visited = newList();
-    for (Node* nodei = toEvaluate->head; nodei != NULL; nodei = nodei->next) {
-        char* name = *(char**)(nodei->dataptr);
-        if (evaluateVar(errorList, name, toEvaluateLut, varDefs, defines, newList())) {
-            // clear the table
-            for (Node* nodej = toEvaluate->head; nodej != NULL; nodej = nodej->next) {
-                char* nameToClear = *(char**)(nodei->dataptr);
-                VarEvalData* lutValue = (VarEvalData*)readStringTable(toEvaluateLut ,nameToClear, strlen(nameToClear) + 1);
-                if (lutValue != NULL) {
-                    for (Node* nodek = lutValue->dependencies->head; nodek != NULL; nodek = nodek -> next) {
-                        free(*(char**)(nodek->dataptr));
-                    }
-                    deleteList(lutValue->dependencies);
-                    free(lutValue->expr);
-                    removeStringTableValue(toEvaluateLut, nameToClear, strlen(nameToClear) + 1);
-                }
-            }
-            break;
-        }
-    }
+    // evaluate the vars
+    evaluateVars(errorList, toEvaluate, toEvaluateLut, varDefs);
 
     // clear the evaluation list
     for (Node* node = toEvaluate->head; node != NULL; node = node->next) {
         free(*(char**)(node->dataptr));
     }
 
+    // drop the calls the scan entered and rebind the caller's arguments
+    while (macroStack->size > startStackSize) {
+        IncludeReturnData* retData = (IncludeReturnData*)popPersistentStack(macroStack);
+        free(retData->args);
+        free(retData->known);
+        free(retData);
+    }
+    restoreMacroArgs(macroStack_);
+
     // reset reading
     char* dir = getDir(retHandle->name);
     if (chdir(dir)) {
@@ -838,6 +1164,7 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
         abort();
     }
     free(dir);
+    countPassRewind(retHandle->fptr, retPos);
     fseek(retHandle->fptr, retPos, SEEK_SET);
 
     // undo defines
@@ -854,11 +1181,10 @@ char readLocalVars(FileHandle* handle, List* errorList, List* handleList, List*
     // cleanup
     deleteList(defUpdates);
     deleteList(toEvaluate);
-    deleteList(visited);
-    deleteStack(ifStack);
-    deleteStack(segStack);
-    deleteStack(includeStack);
-    deleteStack(macroStack);
-    deleteStringTable(toEvaluateLut);// known to be empty
+    deletePersistentStack(ifStack);
+    deletePersistentStack(segStack);
+    deletePersistentStack(includeStack);
+    deletePersistentStack(macroStack);
+    deleteStringTable(toEvaluateLut);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,331 @@
+/*
+generates the benchmark workloads for the assembler
+every workload is written from a fixed seed so the same scale always gives the same files
+
+usage: generate <output_directory> [scale] [seed]
+scale is the size of each workload in thousands of lines (default 10)
+
+Written by Adam Billings
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+// largest segment sizes of the benchmark configuration (in words)
+#define CODE_WORDS 0x7f00
+#define DATA_WORDS 0x7000
+
+// instructions of a branch-free body line
+static const char* const regOps[] = {"add", "addu", "sub", "cmp", "and", "or", "xor", "mov", "lsh", "ashu"};
+static const char* const immOps[] = {"addi", "subi", "cmpi", "andi", "ori", "xori", "movi"};
+static const char* const branchOps[] = {"beq", "bne", "bcs", "bcc", "bhi", "bls", "bgt", "ble", "blo", "bhs", "blt"};
+
+#define COUNT_OF(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+// state of the random number generator
+static uint32_t randState;
+
+/*
+gets the next random number (xorshift32)
+
+returns: random number
+*/
+static uint32_t nextRand() {
+    randState ^= randState << 13;
+    randState ^= randState >> 17;
+    randState ^= randState << 5;
+    return randState;
+}
+
+/*
+gets a random number below a bound
+
+bound: exclusive upper bound
+
+returns: random number in [0, bound)
+*/
+static uint32_t randBelow(uint32_t bound) {
+    return nextRand() % bound;
+}
+
+/*
+opens a file in the output directory
+
+dir: output directory
+name: file name
+
+returns: opened file, exits on failure
+*/
+static FILE* openOutput(const char* dir, const char* name) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "ERROR: Could not open %s\n", path);
+        exit(1);
+    }
+    return file;
+}
+
+/*
+writes one branch-free instruction
+
+file: file to write to
+*/
+static void writeBodyLine(FILE* file) {
+    if (randBelow(2)) {
+        fprintf(file, "    %s r%u, r%u\n", regOps[randBelow(COUNT_OF(regOps))], randBelow(16), randBelow(16));
+    } else {
+        fprintf(file, "    %s %u, r%u\n", immOps[randBelow(COUNT_OF(immOps))], randBelow(128), randBelow(16));
+    }
+}
+
+/*
+writes the configuration every workload is assembled with
+
+dir: output directory
+*/
+static void writeConfig(const char* dir) {
+    FILE* file = openOutput(dir, "bench.cfg");
+    fprintf(file, "MEMORY {\n");
+    fprintf(file, "    ROM: start = $0000, size = $%04x, type = ro;\n", CODE_WORDS);
+    fprintf(file, "    RAM: start = $8000, size = $%04x, type = rw;\n", DATA_WORDS);
+    fprintf(file, "    WRK: start = $f000, size = $0f00, type = bss;\n");
+    fprintf(file, "}\n");
+    fprintf(file, "SEGMENTS {\n");
+    fprintf(file, "    CODE: load = ROM, fill = no;\n");
+    fprintf(file, "    DATA: load = RAM, fill = no;\n");
+    fprintf(file, "    BSS: load = WRK;\n");
+    fprintf(file, "}"); // the reader does not accept a line after the last block
+    fclose(file);
+}
+
+/*
+writes a program mixing functions, loops, constants, calls and data
+
+dir: output directory
+lines: number of lines to write
+*/
+static void writeProgram(const char* dir, long lines) {
+    FILE* file = openOutput(dir, "program.s");
+    long written = 0;
+    int function = 0;
+    fprintf(file, "; mixed program\n.segment \"CODE\"\n");
+    while (written < lines) {
+        // a function with a constant, a loop and a call to the previous function
+        fprintf(file, "SIZE_%d = %u\n", function, randBelow(100) + 1);
+        fprintf(file, "func_%d:\n", function);
+        fprintf(file, "    movi SIZE_%d, r1\n", function);
+        fprintf(file, "@loop:\n");
+        int body = 4 + randBelow(12);
+        for (int i = 0; i < body; i++) {writeBodyLine(file);}
+        fprintf(file, "    subi 1, r1\n");
+        fprintf(file, "    bne @loop\n");
+        if (function > 0) {
+            fprintf(file, "    movi <func_%d, r2\n", function - 1);
+            fprintf(file, "    jal ra, r2\n");
+        }
+        fprintf(file, "@done:\n    juc ra\n\n");
+        written += 13 + body;
+        function++;
+
+        // some data for the function
+        if (function % 8 == 0) {
+            fprintf(file, ".segment \"DATA\"\ntable_%d: .word SIZE_%d, func_%d, %u\n.segment \"CODE\"\n", function, function - 1, function - 1, randBelow(0x10000));
+            written += 3;
+        }
+    }
+    fclose(file);
+}
+
+/*
+writes global labels that are each followed by many local labels
+
+dir: output directory
+lines: number of lines to write
+*/
+static void writeLocals(const char* dir, long lines) {
+    FILE* file = openOutput(dir, "locals.s");
+    long written = 0;
+    int scope = 0;
+    fprintf(file, "; dense local labels\n.segment \"CODE\"\n");
+    while (written < lines) {
+        fprintf(file, "scope_%d:\n", scope);
+        int labelCount = 8 + randBelow(8);
+        for (int i = 0; i < labelCount; i++) {
+            fprintf(file, "@l%d:\n", i);
+            writeBodyLine(file);
+            // branch backwards or forwards inside the scope
+            int target = randBelow(labelCount);
+            fprintf(file, "    %s @l%d\n", branchOps[randBelow(COUNT_OF(branchOps))], target);
+        }
+        written += 1 + labelCount * 3;
+        scope++;
+    }
+    fclose(file);
+}
+
+/*
+writes one file of the include tree and its children
+
+dir: output directory
+depth: depth of this file
+maxDepth: depth of the leaves
+index: index of this file in its level
+lines: number of lines of code in each file
+*/
+static void writeIncludeNode(const char* dir, int depth, int maxDepth, int index, long lines) {
+    char name[64];
+    sprintf(name, "inc_%d_%d.s", depth, index);
+    FILE* file = openOutput(dir, name);
+    fprintf(file, "; include tree depth %d\n", depth);
+    fprintf(file, "inc_%d_%d:\n", depth, index);
+    for (long i = 0; i < lines; i++) {writeBodyLine(file);}
+    if (depth < maxDepth) {
+        for (int child = 0; child < 2; child++) {
+            fprintf(file, ".include \"inc_%d_%d.s\"\n", depth + 1, index * 2 + child);
+            writeIncludeNode(dir, depth + 1, maxDepth, index * 2 + child, lines);
+        }
+    }
+    fclose(file);
+}
+
+/*
+writes a binary tree of included files
+
+dir: output directory
+lines: total number of lines to write
+*/
+static void writeIncludes(const char* dir, long lines) {
+    const int maxDepth = 8;
+    long fileCount = (1L << (maxDepth + 1)) - 1;
+    FILE* file = openOutput(dir, "includes.s");
+    fprintf(file, "; deep include tree\n.segment \"CODE\"\n.include \"inc_0_0.s\"\n");
+    fclose(file);
+    writeIncludeNode(dir, 0, maxDepth, 0, lines / fileCount + 1);
+}
+
+/*
+writes macro definitions, including macros that call other macros, and many calls to them
+
+dir: output directory
+lines: number of lines to write
+*/
+static void writeMacros(const char* dir, long lines) {
+    FILE* file = openOutput(dir, "macros.s");
+    fprintf(file, "; macro heavy code\n.segment \"CODE\"\n");
+    fprintf(file, ".macro load16 val, rDst\n    movi <val, rDst\n    lui >val, rDst\n.endmacro\n");
+    fprintf(file, ".macro addto val, rSrc, rDst\n    load16 val, rSrc\n    add rSrc, rDst\n.endmacro\n");
+    fprintf(file, ".macro clear rDst\n    xor rDst, rDst\n.endmacro\n");
+    fprintf(file, ".macro ldz rDst\n@opcode = $d\n    .word (@opcode << 12) | (rDst << 8)\n.endmacro\n");
+    fprintf(file, ".macro sum3 a, b, c, rDst\n    clear rDst\n    addto a, r1, rDst\n    addto b, r1, rDst\n    addto c, r1, rDst\n.endmacro\n");
+    fprintf(file, ".macro spin n\n    movi n, r2\n@again:\n    subi 1, r2\n    bne @again\n.endmacro\n");
+    long written = 27;
+    int label = 0;
+    while (written < lines) {
+        if (written % 64 < 4) {fprintf(file, "block_%d:\n", label++); written++;}
+        switch (randBelow(6)) {
+            case 0: fprintf(file, "    load16 %u, r%u\n", randBelow(0x10000), randBelow(16)); break;
+            case 1: fprintf(file, "    addto %u, r%u, r%u\n", randBelow(0x10000), randBelow(16), randBelow(16)); break;
+            case 2: fprintf(file, "    clear r%u\n", randBelow(16)); break;
+            case 3: fprintf(file, "    ldz r%u\n", randBelow(16)); break;
+            case 4: fprintf(file, "    sum3 %u, %u, %u, r%u\n", randBelow(256), randBelow(256), randBelow(256), randBelow(16)); break;
+            default: fprintf(file, "    spin %u\n", randBelow(100) + 1); break;
+        }
+        written++;
+    }
+    fclose(file);
+}
+
+/*
+writes large tables of .word data
+
+dir: output directory
+lines: number of lines to write
+*/
+static void writeWords(const char* dir, long lines) {
+    // eight words a line, the table has to fit in the data segment
+    long maxLines = DATA_WORDS / 8 - 16;
+    if (lines > maxLines) {lines = maxLines;}
+    FILE* file = openOutput(dir, "words.s");
+    fprintf(file, "; huge .word tables\n.segment \"DATA\"\n");
+    for (long i = 0; i < lines; i++) {
+        if (i % 512 == 0) {fprintf(file, "table_%ld:\n", i / 512);}
+        fprintf(file, "    .word");
+        for (int j = 0; j < 8; j++) {fprintf(file, "%s$%04x", j ? ", " : " ", randBelow(0x10000));}
+        fprintf(file, "\n");
+    }
+    fclose(file);
+}
+
+/*
+writes a large binary asset and a file that includes it
+
+dir: output directory
+lines: size of the workload, one thousand lines gives four kilobytes of asset
+*/
+static void writeIncbin(const char* dir, long lines) {
+    // the asset has to fit in the data segment
+    long size = lines * 4;
+    if (size > DATA_WORDS * 2 - 64) {size = DATA_WORDS * 2 - 64;}
+    FILE* asset = openOutput(dir, "asset.bin");
+    for (long i = 0; i < size; i++) {fputc(randBelow(256), asset);}
+    fclose(asset);
+
+    FILE* file = openOutput(dir, "incbin.s");
+    fprintf(file, "; large .incbin asset\n.segment \"DATA\"\nasset:\n    .incbin \"asset.bin\"\nassetEnd:\n");
+    fprintf(file, ".segment \"CODE\"\n    movi <asset, r1\n    movi <assetEnd, r2\n");
+    fclose(file);
+}
+
+/*
+writes long chains of constants, each defined before the constant it depends on
+
+dir: output directory
+lines: number of lines to write
+*/
+static void writeConstants(const char* dir, long lines) {
+    FILE* file = openOutput(dir, "constants.s");
+    fprintf(file, "; long constant dependency chains\n.segment \"CODE\"\n");
+    const long chainLength = 1000;
+    long chains = lines / chainLength + 1;
+    for (long chain = 0; chain < chains; chain++) {
+        for (long i = 0; i < chainLength - 1; i++) {
+            fprintf(file, "k%ld_%ld = k%ld_%ld + %u\n", chain, i, chain, i + 1, randBelow(4));
+        }
+        fprintf(file, "k%ld_%ld = %u\n", chain, chainLength - 1, randBelow(16));
+        fprintf(file, "    movi k%ld_0 & $7f, r1\n", chain);
+    }
+    fclose(file);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <output_directory> [scale] [seed]\n", argv[0]);
+        return 1;
+    }
+    const char* dir = argv[1];
+    long scale = (argc > 2) ? atol(argv[2]) : 10;
+    randState = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : 0x3710;
+    if (scale < 1) {scale = 1;}
+    if (randState == 0) {randState = 1;}
+    mkdir(dir, 0755);
+
+    // the code segment holds at most CODE_WORDS instructions
+    long lines = scale * 1000;
+    long codeLines = (lines > CODE_WORDS - 0x100) ? CODE_WORDS - 0x100 : lines;
+    if (codeLines < lines) {fprintf(stderr, "NOTE: code workloads are limited to %ld lines by the 16 bit address space\n", codeLines);}
+
+    writeConfig(dir);
+    writeProgram(dir, codeLines * 3 / 4);
+    writeLocals(dir, codeLines);
+    writeIncludes(dir, codeLines);
+    writeMacros(dir, codeLines / 4);
+    writeWords(dir, lines);
+    writeIncbin(dir, lines);
+    writeConstants(dir, lines);
+    return 0;
+}
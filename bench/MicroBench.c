@@ -0,0 +1,332 @@
+/*
+microbenchmarks for the data structures and expression evaluation used by every pass
+allocations are counted by wrapping the allocator at link time (see the microbench target in the makefile)
+
+usage: microbench [scale]
+scale multiplies the number of operations of each benchmark (default 1)
+
+Written by Adam Billings
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "DataStructures/List.h"
+#include "DataStructures/StringTable.h"
+#include "ExpressionEvaluation.h"
+
+// number of distinct symbol names
+#define NAME_COUNT 4096
+
+// longest symbol name
+#define NAME_LENGTH 32
+
+// allocations made through the wrapped allocator
+static unsigned long allocCount = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+/*
+counted malloc, every call to malloc is linked here
+
+size: bytes to allocate
+
+returns: new block
+*/
+void* __wrap_malloc(size_t size) {
+    allocCount++;
+    return __real_malloc(size);
+}
+
+/*
+counted calloc, every call to calloc is linked here
+
+count: number of elements
+size: size of an element
+
+returns: new zeroed block
+*/
+void* __wrap_calloc(size_t count, size_t size) {
+    allocCount++;
+    return __real_calloc(count, size);
+}
+
+/*
+counted realloc, every call to realloc is linked here
+
+ptr: block to resize
+size: new size
+
+returns: resized block
+*/
+void* __wrap_realloc(void* ptr, size_t size) {
+    allocCount++;
+    return __real_realloc(ptr, size);
+}
+
+// state of the random number generator
+static uint32_t randState = 0x3710;
+
+// keeps results alive so the compiler cannot drop the work
+static volatile unsigned long sink;
+
+/*
+gets the next random number (xorshift32)
+
+returns: random number
+*/
+static uint32_t nextRand() {
+    randState ^= randState << 13;
+    randState ^= randState >> 17;
+    randState ^= randState << 5;
+    return randState;
+}
+
+/*
+reads the monotonic clock
+
+returns: time (in nanoseconds)
+*/
+static uint64_t nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+// a running measurement
+typedef struct Measure {
+    uint64_t start;
+    unsigned long allocs;
+} Measure;
+
+/*
+starts a measurement
+
+returns: measurement to finish with endMeasure
+*/
+static Measure startMeasure() {
+    Measure measure = {nowNs(), allocCount};
+    return measure;
+}
+
+/*
+finishes a measurement and prints one row
+
+measure: measurement from startMeasure
+name: name of the benchmark
+ops: number of operations measured
+*/
+static void endMeasure(Measure measure, const char* name, unsigned long ops) {
+    uint64_t elapsed = nowNs() - measure.start;
+    unsigned long allocs = allocCount - measure.allocs;
+    printf("    %-32s %12lu %12.1f %12.3f\n", name, ops, (double)elapsed / ops, (double)allocs / ops);
+}
+
+/*
+fills the symbol names with the shapes seen in real sources
+registers, global labels, local labels, constants and short names
+
+names: array of NAME_COUNT names
+*/
+static void makeNames(char names[][NAME_LENGTH]) {
+    static const char* const prefixes[] = {"func_", "loop_", "SIZE_", "table_", "handle", "@l", "@skip", "tmp", "PORT_", "isr_"};
+    int n = 0;
+    for (; n < 16; n++) {sprintf(names[n], "r%d", n);}
+    sprintf(names[n++], "ra");
+    sprintf(names[n++], "sp");
+    for (; n < NAME_COUNT; n++) {
+        uint32_t kind = nextRand() % 10;
+        if (kind < 7) {sprintf(names[n], "%s%d", prefixes[nextRand() % 10], n);}
+        else if (kind < 9) {
+            // short names of two to six letters
+            int length = 2 + nextRand() % 5;
+            for (int i = 0; i < length; i++) {names[n][i] = 'a' + nextRand() % 26;}
+            sprintf(names[n] + length, "%d", n);
+        } else {
+            // long descriptive names
+            sprintf(names[n], "interruptVectorTableEntry%d", n);
+        }
+    }
+}
+
+/*
+picks a name index with a skewed distribution, a few names are used far more than the rest
+
+returns: index of a name
+*/
+static int pickSkewed() {
+    uint32_t r = nextRand();
+    if ((r & 3) != 0) {return (r >> 2) % 64;}
+    return (r >> 2) % NAME_COUNT;
+}
+
+/*
+benchmarks StringTable insert, lookup and remove
+
+scale: multiplier of the operation counts
+*/
+static void benchStringTable(int scale) {
+    static char names[NAME_COUNT][NAME_LENGTH];
+    makeNames(names);
+    int lengths[NAME_COUNT];
+    for (int i = 0; i < NAME_COUNT; i++) {lengths[i] = strlen(names[i]) + 1;}
+    int rounds = 8 * scale;
+    unsigned long checksum = 0;
+
+    // insert every name into new tables
+    StringTable tables[rounds];
+    Measure measure = startMeasure();
+    for (int r = 0; r < rounds; r++) {
+        tables[r] = newStringTable();
+        for (uint16_t i = 0; i < NAME_COUNT; i++) {setStringTableValue(tables[r], names[i], lengths[i], &i, sizeof(uint16_t));}
+    }
+    endMeasure(measure, "StringTable insert", (unsigned long)rounds * NAME_COUNT);
+
+    // overwrite existing names
+    measure = startMeasure();
+    for (int r = 0; r < rounds; r++) {
+        for (uint16_t i = 0; i < NAME_COUNT; i++) {setStringTableValue(tables[r], names[i], lengths[i], &i, sizeof(uint16_t));}
+    }
+    endMeasure(measure, "StringTable overwrite", (unsigned long)rounds * NAME_COUNT);
+
+    // lookups with a skewed mix of names
+    int lookups = 200000 * scale;
+    int* order = (int*)malloc(lookups * sizeof(int));
+    for (int i = 0; i < lookups; i++) {order[i] = pickSkewed();}
+    measure = startMeasure();
+    for (int i = 0; i < lookups; i++) {
+        uint16_t* val = (uint16_t*)readStringTable(tables[0], names[order[i]], lengths[order[i]]);
+        checksum += *val;
+    }
+    endMeasure(measure, "StringTable lookup hit", lookups);
+
+    // lookups of names that are not in the table
+    static char missNames[NAME_COUNT][NAME_LENGTH];
+    for (int i = 0; i < NAME_COUNT; i++) {sprintf(missNames[i], "%s_", names[i]);}
+    measure = startMeasure();
+    for (int i = 0; i < lookups; i++) {
+        checksum += (readStringTable(tables[0], missNames[order[i]], lengths[order[i]] + 1) == NULL);
+    }
+    endMeasure(measure, "StringTable lookup miss", lookups);
+    free(order);
+
+    // remove every name
+    measure = startMeasure();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < NAME_COUNT; i++) {removeStringTableValue(tables[r], names[i], lengths[i]);}
+    }
+    endMeasure(measure, "StringTable remove", (unsigned long)rounds * NAME_COUNT);
+
+    // create and delete empty tables, as every scope and macro call does
+    measure = startMeasure();
+    for (int r = 0; r < rounds; r++) {deleteStringTable(tables[r]);}
+    int creates = 1000 * scale;
+    for (int i = 0; i < creates; i++) {deleteStringTable(newStringTable());}
+    endMeasure(measure, "StringTable new + delete", rounds + creates);
+    sink = checksum;
+}
+
+/*
+benchmarks List append, iterate and index
+
+scale: multiplier of the operation counts
+*/
+static void benchList(int scale) {
+    const int size = 1024;
+    int rounds = 64 * scale;
+    unsigned long checksum = 0;
+
+    // append to new lists
+    List* lists[rounds];
+    Measure measure = startMeasure();
+    for (int r = 0; r < rounds; r++) {
+        lists[r] = newList();
+        for (int i = 0; i < size; i++) {appendList(lists[r], &i, sizeof(int));}
+    }
+    endMeasure(measure, "List append", (unsigned long)rounds * size);
+
+    // walk the nodes
+    measure = startMeasure();
+    for (int r = 0; r < rounds; r++) {
+        for (Node* node = lists[r]->head; node != NULL; node = node->next) {checksum += *(int*)(node->dataptr);}
+    }
+    endMeasure(measure, "List iterate", (unsigned long)rounds * size);
+
+    // index random elements
+    int indexes = 20000 * scale;
+    measure = startMeasure();
+    for (int i = 0; i < indexes; i++) {checksum += *(int*)indexList(lists[i % rounds], nextRand() % size);}
+    endMeasure(measure, "List index (1024 elements)", indexes);
+
+    // delete the lists
+    measure = startMeasure();
+    for (int r = 0; r < rounds; r++) {deleteList(lists[r]);}
+    endMeasure(measure, "List delete", (unsigned long)rounds * size);
+    sink = checksum;
+}
+
+/*
+benchmarks evalShortExpr over mixes of operators
+
+scale: multiplier of the operation counts
+*/
+static void benchExpressions(int scale) {
+    static const char* const mixes[][2] = {
+        {"expr constant", "$1234"},
+        {"expr arithmetic", "13 + 4 * 7 - (20 / 3)"},
+        {"expr bitwise", "($f0f0 & $ff) | (1 << 4) ^ ~%1010"},
+        {"expr compare/logical", "(3 < 7) && (5 >= 2) || !(4 == 4)"},
+        {"expr variables", "SIZE_12 + table_7 * 2 - func_3"},
+        {"expr registers", "r1"},
+        {"expr byte select", "<func_3 + >table_7"},
+        {"expr ternary", "SIZE_12 > 5 ? 'A' : 'B'"}
+    };
+
+    // symbols the expressions read
+    StringTable vars = newStringTable();
+    StringTable defines = newStringTable();
+    const char* const varNames[] = {"SIZE_12", "table_7", "func_3", "r1"};
+    for (uint16_t i = 0; i < sizeof(varNames) / sizeof(varNames[0]); i++) {
+        uint16_t val = 100 + i * 37;
+        setStringTableValue(vars, (char*)varNames[i], strlen(varNames[i]) + 1, &val, sizeof(uint16_t));
+    }
+
+    int evaluations = 100000 * scale;
+    unsigned long checksum = 0;
+    for (int m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        char expr[64];
+        strcpy(expr, mixes[m][1]);
+        int length = strlen(expr);
+        Measure measure = startMeasure();
+        for (int i = 0; i < evaluations; i++) {
+            ExprErrorShort out = evalShortExpr(expr, length, vars, defines);
+            if (out.errorMessage != NULL) {
+                printf("ERROR: %s: %s\n", mixes[m][0], out.errorMessage);
+                free(out.errorMessage);
+                break;
+            }
+            checksum += out.val;
+        }
+        endMeasure(measure, mixes[m][0], evaluations);
+    }
+    deleteStringTable(vars);
+    deleteStringTable(defines);
+    sink = checksum;
+}
+
+int main(int argc, char* argv[]) {
+    int scale = (argc > 1) ? atoi(argv[1]) : 1;
+    if (scale < 1) {scale = 1;}
+
+    printf("  -- Microbenchmarks --\n");
+    printf("    %-32s %12s %12s %12s\n", "benchmark", "ops", "ns/op", "allocs/op");
+    benchStringTable(scale);
+    benchList(scale);
+    benchExpressions(scale);
+    printf("\n");
+    return 0;
+}
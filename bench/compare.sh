@@ -0,0 +1,27 @@
+#!/bin/sh
+# compares the minimum times of two benchmark results
+#
+# usage: bench/compare.sh <old_results.json> <new_results.json>
+#
+# Written by Adam Billings
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 <old_results.json> <new_results.json>" >&2
+    exit 1
+fi
+
+# every workload is on its own line in the results
+extract() {
+    sed -n 's/.*"name": "\([a-z]*\)", "lines": [0-9]*, "min_ms": \([0-9.]*\).*/\1 \2/p' "$1"
+}
+
+extract "$1" > /tmp/ace3710-bench-old.$$
+extract "$2" | while read NAME NEW; do
+    OLD=$(sed -n "s/^$NAME //p" /tmp/ace3710-bench-old.$$)
+    if [ -z "$OLD" ]; then
+        printf '  %-10s %10s ms -> %10s ms\n' "$NAME" "-" "$NEW"
+    else
+        awk -v n="$NAME" -v o="$OLD" -v c="$NEW" 'BEGIN {printf "  %-10s %10.3f ms -> %10.3f ms  %+7.1f%%\n", n, o, c, (o > 0) ? (c - o) * 100 / o : 0}'
+    fi
+done
+rm -f /tmp/ace3710-bench-old.$$
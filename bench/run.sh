@@ -0,0 +1,73 @@
+#!/bin/sh
+# times the assembler over the generated workloads
+#
+# usage: bench/run.sh [scale] [runs]
+# scale is passed to the generator, runs is the number of timed runs of each workload
+# results are written to bench/results/<commit>.json, one workload per line
+#
+# Written by Adam Billings
+
+set -e
+cd "$(dirname "$0")"
+
+SCALE=${1:-10}
+RUNS=${2:-5}
+ACE=../ace3710
+WORK=$(pwd)/workloads # the assembler moves to the directory of the source, so paths are absolute
+WORKLOADS="program locals includes macros words incbin constants"
+
+if [ ! -x "$ACE" ]; then
+    echo "ERROR: $ACE not found, run make first" >&2
+    exit 1
+fi
+
+# the same scale always generates the same files
+rm -rf "$WORK"
+./generate "$WORK" "$SCALE"
+
+COMMIT=$(git describe --always --dirty 2>/dev/null || echo unknown)
+mkdir -p results
+OUT=results/$COMMIT.json
+
+{
+    printf '{\n'
+    printf '  "commit": "%s",\n' "$COMMIT"
+    printf '  "date": "%s",\n' "$(date -u +%Y-%m-%dT%H:%M:%SZ)"
+    printf '  "scale": %s,\n' "$SCALE"
+    printf '  "runs": %s,\n' "$RUNS"
+    printf '  "workloads": [\n'
+} > "$OUT"
+
+SEP=""
+for NAME in $WORKLOADS; do
+    if [ "$NAME" = "includes" ]; then LINES=$(cat "$WORK/$NAME.s" "$WORK"/inc_*.s | wc -l)
+    else LINES=$(wc -l < "$WORK/$NAME.s"); fi
+
+    # time every run, the pass times are kept from the last run
+    TIMES=""
+    for RUN in $(seq "$RUNS"); do
+        START=$(date +%s%N)
+        if ! "$ACE" -w -r -c "$WORK/bench.cfg" -o "$WORK/$NAME.out" --perf-counters --time-passes-json "$WORK/$NAME.passes.json" "$WORK/$NAME.s" > "$WORK/$NAME.log" 2>&1; then
+            echo "ERROR: $NAME failed to assemble, see $WORK/$NAME.log" >&2
+            exit 1
+        fi
+        END=$(date +%s%N)
+        TIMES="$TIMES $(( (END - START) / 1000 ))"
+    done
+
+    # minimum and median in milliseconds
+    SORTED=$(echo $TIMES | tr ' ' '\n' | sort -n)
+    MIN=$(echo "$SORTED" | head -n 1)
+    MEDIAN=$(echo "$SORTED" | sed -n "$(( (RUNS + 1) / 2 ))p")
+    RUN_LIST=$(echo $TIMES | sed 's/ /, /g')
+    PASSES=$(tr -d '\n' < "$WORK/$NAME.passes.json" | sed 's/  */ /g')
+
+    printf '%s    {"name": "%s", "lines": %s, "min_ms": %s.%03d, "median_ms": %s.%03d, "runs_us": [%s], "passes": %s}' \
+        "$SEP" "$NAME" "$LINES" $((MIN / 1000)) $((MIN % 1000)) $((MEDIAN / 1000)) $((MEDIAN % 1000)) "$RUN_LIST" "$PASSES" >> "$OUT"
+    SEP=",
+"
+    printf '  %-10s %8s lines  min %6d.%03d ms  median %6d.%03d ms\n' "$NAME" "$LINES" $((MIN / 1000)) $((MIN % 1000)) $((MEDIAN / 1000)) $((MEDIAN % 1000))
+done
+
+printf '\n  ]\n}\n' >> "$OUT"
+echo "results written to bench/$OUT"
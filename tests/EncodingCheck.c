@@ -0,0 +1,83 @@
+/*
+round trip check of the instruction table
+every instruction is encoded over the whole range of its operand fields, decoded and compared
+
+usage: encodingcheck
+returns 0 when every word decodes back to the instruction and operands it was encoded from
+
+Written by Adam Billings
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "DataStructures/StringTable.h"
+#include "CodeGeneration.h"
+
+/*
+gets the value of an operand field from its bits, sign extended like the decoder
+
+field: operand field
+bits: field bits
+
+returns: operand value
+*/
+static uint16_t getFieldValue(const OperandField* field, uint16_t bits) {
+    if (field->isSigned && (bits & ((field->mask + 1) >> 1))) {return bits | ~field->mask;}
+    return bits;
+}
+
+/*
+checks one instruction over every operand combination
+
+instData: instruction to check
+
+returns: number of failed words
+*/
+static unsigned long checkInstruction(const InstData* instData) {
+    unsigned long failures = 0;
+    const OperandField* fields = instData->args;
+    for (uint32_t bits1 = 0; bits1 <= fields[0].mask; bits1++) {
+        for (uint32_t bits2 = 0; bits2 <= fields[1].mask; bits2++) {
+            uint16_t args[2] = {getFieldValue(fields, bits1), getFieldValue(fields + 1, bits2)};
+            uint16_t inst = encodeFields(instData, args);
+
+            // aliased words decode to the implied form, which has to encode the same word
+            uint16_t decodedArgs[2] = {0, 0};
+            const InstData* decoded = decodeInstruction(inst, decodedArgs);
+            const char* problem = NULL;
+            if (decoded == NULL) {problem = "does not decode";}
+            else if (encodeFields(decoded, decodedArgs) != inst) {problem = "re-encodes to a different word";}
+            else if (strcmp(decoded->mnemonic, instData->mnemonic) && decoded->type != imp) {problem = "decodes to another instruction";}
+            else if (!strcmp(decoded->mnemonic, instData->mnemonic)) {
+                for (int i = 0; i < instData->argCount; i++) {
+                    if (decodedArgs[i] != args[i]) {problem = "decodes to other operands";}
+                    else if (!isOperandInRange(fields + i, decodedArgs[i])) {problem = "decodes to an operand out of range";}
+                }
+            }
+            if (problem != NULL) {
+                printf("    %-6s %04x %s (%s)\n", instData->mnemonic, inst, problem, (decoded != NULL) ? decoded->mnemonic : "none");
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+int main() {
+    // the instruction table holds every entry of the instruction set
+    StringTable instructions = newInstructionTable();
+    unsigned long instructionCount = 0;
+    unsigned long failures = 0;
+    for (int i = 0; i < 256; i++) {
+        for (Node* node = instructions[i]->head; node != NULL; node = node->next) {
+            failures += checkInstruction((const InstData*)((KeyValuePair*)(node->dataptr))->valueptr);
+            instructionCount++;
+        }
+    }
+    deleteStringTable(instructions);
+
+    printf("  -- Encoding Check --\n");
+    printf("    %lu instructions, %lu failed words\n\n", instructionCount, failures);
+    return failures != 0;
+}
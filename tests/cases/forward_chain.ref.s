@@ -0,0 +1,5 @@
+; a long chain of constants that each use the next one resolves in one pass
+.segment "CODE"
+start:
+    movi 125, r2
+    movi 1, r3
@@ -0,0 +1,2006 @@
+; args: -1
+; a long chain of constants that each use the next one resolves in one pass
+.segment "CODE"
+start:
+    movi C0 / 16, r2
+    movi C1999, r3
+C0 = C1 + 1
+C1 = C2 + 1
+C2 = C3 + 1
+C3 = C4 + 1
+C4 = C5 + 1
+C5 = C6 + 1
+C6 = C7 + 1
+C7 = C8 + 1
+C8 = C9 + 1
+C9 = C10 + 1
+C10 = C11 + 1
+C11 = C12 + 1
+C12 = C13 + 1
+C13 = C14 + 1
+C14 = C15 + 1
+C15 = C16 + 1
+C16 = C17 + 1
+C17 = C18 + 1
+C18 = C19 + 1
+C19 = C20 + 1
+C20 = C21 + 1
+C21 = C22 + 1
+C22 = C23 + 1
+C23 = C24 + 1
+C24 = C25 + 1
+C25 = C26 + 1
+C26 = C27 + 1
+C27 = C28 + 1
+C28 = C29 + 1
+C29 = C30 + 1
+C30 = C31 + 1
+C31 = C32 + 1
+C32 = C33 + 1
+C33 = C34 + 1
+C34 = C35 + 1
+C35 = C36 + 1
+C36 = C37 + 1
+C37 = C38 + 1
+C38 = C39 + 1
+C39 = C40 + 1
+C40 = C41 + 1
+C41 = C42 + 1
+C42 = C43 + 1
+C43 = C44 + 1
+C44 = C45 + 1
+C45 = C46 + 1
+C46 = C47 + 1
+C47 = C48 + 1
+C48 = C49 + 1
+C49 = C50 + 1
+C50 = C51 + 1
+C51 = C52 + 1
+C52 = C53 + 1
+C53 = C54 + 1
+C54 = C55 + 1
+C55 = C56 + 1
+C56 = C57 + 1
+C57 = C58 + 1
+C58 = C59 + 1
+C59 = C60 + 1
+C60 = C61 + 1
+C61 = C62 + 1
+C62 = C63 + 1
+C63 = C64 + 1
+C64 = C65 + 1
+C65 = C66 + 1
+C66 = C67 + 1
+C67 = C68 + 1
+C68 = C69 + 1
+C69 = C70 + 1
+C70 = C71 + 1
+C71 = C72 + 1
+C72 = C73 + 1
+C73 = C74 + 1
+C74 = C75 + 1
+C75 = C76 + 1
+C76 = C77 + 1
+C77 = C78 + 1
+C78 = C79 + 1
+C79 = C80 + 1
+C80 = C81 + 1
+C81 = C82 + 1
+C82 = C83 + 1
+C83 = C84 + 1
+C84 = C85 + 1
+C85 = C86 + 1
+C86 = C87 + 1
+C87 = C88 + 1
+C88 = C89 + 1
+C89 = C90 + 1
+C90 = C91 + 1
+C91 = C92 + 1
+C92 = C93 + 1
+C93 = C94 + 1
+C94 = C95 + 1
+C95 = C96 + 1
+C96 = C97 + 1
+C97 = C98 + 1
+C98 = C99 + 1
+C99 = C100 + 1
+C100 = C101 + 1
+C101 = C102 + 1
+C102 = C103 + 1
+C103 = C104 + 1
+C104 = C105 + 1
+C105 = C106 + 1
+C106 = C107 + 1
+C107 = C108 + 1
+C108 = C109 + 1
+C109 = C110 + 1
+C110 = C111 + 1
+C111 = C112 + 1
+C112 = C113 + 1
+C113 = C114 + 1
+C114 = C115 + 1
+C115 = C116 + 1
+C116 = C117 + 1
+C117 = C118 + 1
+C118 = C119 + 1
+C119 = C120 + 1
+C120 = C121 + 1
+C121 = C122 + 1
+C122 = C123 + 1
+C123 = C124 + 1
+C124 = C125 + 1
+C125 = C126 + 1
+C126 = C127 + 1
+C127 = C128 + 1
+C128 = C129 + 1
+C129 = C130 + 1
+C130 = C131 + 1
+C131 = C132 + 1
+C132 = C133 + 1
+C133 = C134 + 1
+C134 = C135 + 1
+C135 = C136 + 1
+C136 = C137 + 1
+C137 = C138 + 1
+C138 = C139 + 1
+C139 = C140 + 1
+C140 = C141 + 1
+C141 = C142 + 1
+C142 = C143 + 1
+C143 = C144 + 1
+C144 = C145 + 1
+C145 = C146 + 1
+C146 = C147 + 1
+C147 = C148 + 1
+C148 = C149 + 1
+C149 = C150 + 1
+C150 = C151 + 1
+C151 = C152 + 1
+C152 = C153 + 1
+C153 = C154 + 1
+C154 = C155 + 1
+C155 = C156 + 1
+C156 = C157 + 1
+C157 = C158 + 1
+C158 = C159 + 1
+C159 = C160 + 1
+C160 = C161 + 1
+C161 = C162 + 1
+C162 = C163 + 1
+C163 = C164 + 1
+C164 = C165 + 1
+C165 = C166 + 1
+C166 = C167 + 1
+C167 = C168 + 1
+C168 = C169 + 1
+C169 = C170 + 1
+C170 = C171 + 1
+C171 = C172 + 1
+C172 = C173 + 1
+C173 = C174 + 1
+C174 = C175 + 1
+C175 = C176 + 1
+C176 = C177 + 1
+C177 = C178 + 1
+C178 = C179 + 1
+C179 = C180 + 1
+C180 = C181 + 1
+C181 = C182 + 1
+C182 = C183 + 1
+C183 = C184 + 1
+C184 = C185 + 1
+C185 = C186 + 1
+C186 = C187 + 1
+C187 = C188 + 1
+C188 = C189 + 1
+C189 = C190 + 1
+C190 = C191 + 1
+C191 = C192 + 1
+C192 = C193 + 1
+C193 = C194 + 1
+C194 = C195 + 1
+C195 = C196 + 1
+C196 = C197 + 1
+C197 = C198 + 1
+C198 = C199 + 1
+C199 = C200 + 1
+C200 = C201 + 1
+C201 = C202 + 1
+C202 = C203 + 1
+C203 = C204 + 1
+C204 = C205 + 1
+C205 = C206 + 1
+C206 = C207 + 1
+C207 = C208 + 1
+C208 = C209 + 1
+C209 = C210 + 1
+C210 = C211 + 1
+C211 = C212 + 1
+C212 = C213 + 1
+C213 = C214 + 1
+C214 = C215 + 1
+C215 = C216 + 1
+C216 = C217 + 1
+C217 = C218 + 1
+C218 = C219 + 1
+C219 = C220 + 1
+C220 = C221 + 1
+C221 = C222 + 1
+C222 = C223 + 1
+C223 = C224 + 1
+C224 = C225 + 1
+C225 = C226 + 1
+C226 = C227 + 1
+C227 = C228 + 1
+C228 = C229 + 1
+C229 = C230 + 1
+C230 = C231 + 1
+C231 = C232 + 1
+C232 = C233 + 1
+C233 = C234 + 1
+C234 = C235 + 1
+C235 = C236 + 1
+C236 = C237 + 1
+C237 = C238 + 1
+C238 = C239 + 1
+C239 = C240 + 1
+C240 = C241 + 1
+C241 = C242 + 1
+C242 = C243 + 1
+C243 = C244 + 1
+C244 = C245 + 1
+C245 = C246 + 1
+C246 = C247 + 1
+C247 = C248 + 1
+C248 = C249 + 1
+C249 = C250 + 1
+C250 = C251 + 1
+C251 = C252 + 1
+C252 = C253 + 1
+C253 = C254 + 1
+C254 = C255 + 1
+C255 = C256 + 1
+C256 = C257 + 1
+C257 = C258 + 1
+C258 = C259 + 1
+C259 = C260 + 1
+C260 = C261 + 1
+C261 = C262 + 1
+C262 = C263 + 1
+C263 = C264 + 1
+C264 = C265 + 1
+C265 = C266 + 1
+C266 = C267 + 1
+C267 = C268 + 1
+C268 = C269 + 1
+C269 = C270 + 1
+C270 = C271 + 1
+C271 = C272 + 1
+C272 = C273 + 1
+C273 = C274 + 1
+C274 = C275 + 1
+C275 = C276 + 1
+C276 = C277 + 1
+C277 = C278 + 1
+C278 = C279 + 1
+C279 = C280 + 1
+C280 = C281 + 1
+C281 = C282 + 1
+C282 = C283 + 1
+C283 = C284 + 1
+C284 = C285 + 1
+C285 = C286 + 1
+C286 = C287 + 1
+C287 = C288 + 1
+C288 = C289 + 1
+C289 = C290 + 1
+C290 = C291 + 1
+C291 = C292 + 1
+C292 = C293 + 1
+C293 = C294 + 1
+C294 = C295 + 1
+C295 = C296 + 1
+C296 = C297 + 1
+C297 = C298 + 1
+C298 = C299 + 1
+C299 = C300 + 1
+C300 = C301 + 1
+C301 = C302 + 1
+C302 = C303 + 1
+C303 = C304 + 1
+C304 = C305 + 1
+C305 = C306 + 1
+C306 = C307 + 1
+C307 = C308 + 1
+C308 = C309 + 1
+C309 = C310 + 1
+C310 = C311 + 1
+C311 = C312 + 1
+C312 = C313 + 1
+C313 = C314 + 1
+C314 = C315 + 1
+C315 = C316 + 1
+C316 = C317 + 1
+C317 = C318 + 1
+C318 = C319 + 1
+C319 = C320 + 1
+C320 = C321 + 1
+C321 = C322 + 1
+C322 = C323 + 1
+C323 = C324 + 1
+C324 = C325 + 1
+C325 = C326 + 1
+C326 = C327 + 1
+C327 = C328 + 1
+C328 = C329 + 1
+C329 = C330 + 1
+C330 = C331 + 1
+C331 = C332 + 1
+C332 = C333 + 1
+C333 = C334 + 1
+C334 = C335 + 1
+C335 = C336 + 1
+C336 = C337 + 1
+C337 = C338 + 1
+C338 = C339 + 1
+C339 = C340 + 1
+C340 = C341 + 1
+C341 = C342 + 1
+C342 = C343 + 1
+C343 = C344 + 1
+C344 = C345 + 1
+C345 = C346 + 1
+C346 = C347 + 1
+C347 = C348 + 1
+C348 = C349 + 1
+C349 = C350 + 1
+C350 = C351 + 1
+C351 = C352 + 1
+C352 = C353 + 1
+C353 = C354 + 1
+C354 = C355 + 1
+C355 = C356 + 1
+C356 = C357 + 1
+C357 = C358 + 1
+C358 = C359 + 1
+C359 = C360 + 1
+C360 = C361 + 1
+C361 = C362 + 1
+C362 = C363 + 1
+C363 = C364 + 1
+C364 = C365 + 1
+C365 = C366 + 1
+C366 = C367 + 1
+C367 = C368 + 1
+C368 = C369 + 1
+C369 = C370 + 1
+C370 = C371 + 1
+C371 = C372 + 1
+C372 = C373 + 1
+C373 = C374 + 1
+C374 = C375 + 1
+C375 = C376 + 1
+C376 = C377 + 1
+C377 = C378 + 1
+C378 = C379 + 1
+C379 = C380 + 1
+C380 = C381 + 1
+C381 = C382 + 1
+C382 = C383 + 1
+C383 = C384 + 1
+C384 = C385 + 1
+C385 = C386 + 1
+C386 = C387 + 1
+C387 = C388 + 1
+C388 = C389 + 1
+C389 = C390 + 1
+C390 = C391 + 1
+C391 = C392 + 1
+C392 = C393 + 1
+C393 = C394 + 1
+C394 = C395 + 1
+C395 = C396 + 1
+C396 = C397 + 1
+C397 = C398 + 1
+C398 = C399 + 1
+C399 = C400 + 1
+C400 = C401 + 1
+C401 = C402 + 1
+C402 = C403 + 1
+C403 = C404 + 1
+C404 = C405 + 1
+C405 = C406 + 1
+C406 = C407 + 1
+C407 = C408 + 1
+C408 = C409 + 1
+C409 = C410 + 1
+C410 = C411 + 1
+C411 = C412 + 1
+C412 = C413 + 1
+C413 = C414 + 1
+C414 = C415 + 1
+C415 = C416 + 1
+C416 = C417 + 1
+C417 = C418 + 1
+C418 = C419 + 1
+C419 = C420 + 1
+C420 = C421 + 1
+C421 = C422 + 1
+C422 = C423 + 1
+C423 = C424 + 1
+C424 = C425 + 1
+C425 = C426 + 1
+C426 = C427 + 1
+C427 = C428 + 1
+C428 = C429 + 1
+C429 = C430 + 1
+C430 = C431 + 1
+C431 = C432 + 1
+C432 = C433 + 1
+C433 = C434 + 1
+C434 = C435 + 1
+C435 = C436 + 1
+C436 = C437 + 1
+C437 = C438 + 1
+C438 = C439 + 1
+C439 = C440 + 1
+C440 = C441 + 1
+C441 = C442 + 1
+C442 = C443 + 1
+C443 = C444 + 1
+C444 = C445 + 1
+C445 = C446 + 1
+C446 = C447 + 1
+C447 = C448 + 1
+C448 = C449 + 1
+C449 = C450 + 1
+C450 = C451 + 1
+C451 = C452 + 1
+C452 = C453 + 1
+C453 = C454 + 1
+C454 = C455 + 1
+C455 = C456 + 1
+C456 = C457 + 1
+C457 = C458 + 1
+C458 = C459 + 1
+C459 = C460 + 1
+C460 = C461 + 1
+C461 = C462 + 1
+C462 = C463 + 1
+C463 = C464 + 1
+C464 = C465 + 1
+C465 = C466 + 1
+C466 = C467 + 1
+C467 = C468 + 1
+C468 = C469 + 1
+C469 = C470 + 1
+C470 = C471 + 1
+C471 = C472 + 1
+C472 = C473 + 1
+C473 = C474 + 1
+C474 = C475 + 1
+C475 = C476 + 1
+C476 = C477 + 1
+C477 = C478 + 1
+C478 = C479 + 1
+C479 = C480 + 1
+C480 = C481 + 1
+C481 = C482 + 1
+C482 = C483 + 1
+C483 = C484 + 1
+C484 = C485 + 1
+C485 = C486 + 1
+C486 = C487 + 1
+C487 = C488 + 1
+C488 = C489 + 1
+C489 = C490 + 1
+C490 = C491 + 1
+C491 = C492 + 1
+C492 = C493 + 1
+C493 = C494 + 1
+C494 = C495 + 1
+C495 = C496 + 1
+C496 = C497 + 1
+C497 = C498 + 1
+C498 = C499 + 1
+C499 = C500 + 1
+C500 = C501 + 1
+C501 = C502 + 1
+C502 = C503 + 1
+C503 = C504 + 1
+C504 = C505 + 1
+C505 = C506 + 1
+C506 = C507 + 1
+C507 = C508 + 1
+C508 = C509 + 1
+C509 = C510 + 1
+C510 = C511 + 1
+C511 = C512 + 1
+C512 = C513 + 1
+C513 = C514 + 1
+C514 = C515 + 1
+C515 = C516 + 1
+C516 = C517 + 1
+C517 = C518 + 1
+C518 = C519 + 1
+C519 = C520 + 1
+C520 = C521 + 1
+C521 = C522 + 1
+C522 = C523 + 1
+C523 = C524 + 1
+C524 = C525 + 1
+C525 = C526 + 1
+C526 = C527 + 1
+C527 = C528 + 1
+C528 = C529 + 1
+C529 = C530 + 1
+C530 = C531 + 1
+C531 = C532 + 1
+C532 = C533 + 1
+C533 = C534 + 1
+C534 = C535 + 1
+C535 = C536 + 1
+C536 = C537 + 1
+C537 = C538 + 1
+C538 = C539 + 1
+C539 = C540 + 1
+C540 = C541 + 1
+C541 = C542 + 1
+C542 = C543 + 1
+C543 = C544 + 1
+C544 = C545 + 1
+C545 = C546 + 1
+C546 = C547 + 1
+C547 = C548 + 1
+C548 = C549 + 1
+C549 = C550 + 1
+C550 = C551 + 1
+C551 = C552 + 1
+C552 = C553 + 1
+C553 = C554 + 1
+C554 = C555 + 1
+C555 = C556 + 1
+C556 = C557 + 1
+C557 = C558 + 1
+C558 = C559 + 1
+C559 = C560 + 1
+C560 = C561 + 1
+C561 = C562 + 1
+C562 = C563 + 1
+C563 = C564 + 1
+C564 = C565 + 1
+C565 = C566 + 1
+C566 = C567 + 1
+C567 = C568 + 1
+C568 = C569 + 1
+C569 = C570 + 1
+C570 = C571 + 1
+C571 = C572 + 1
+C572 = C573 + 1
+C573 = C574 + 1
+C574 = C575 + 1
+C575 = C576 + 1
+C576 = C577 + 1
+C577 = C578 + 1
+C578 = C579 + 1
+C579 = C580 + 1
+C580 = C581 + 1
+C581 = C582 + 1
+C582 = C583 + 1
+C583 = C584 + 1
+C584 = C585 + 1
+C585 = C586 + 1
+C586 = C587 + 1
+C587 = C588 + 1
+C588 = C589 + 1
+C589 = C590 + 1
+C590 = C591 + 1
+C591 = C592 + 1
+C592 = C593 + 1
+C593 = C594 + 1
+C594 = C595 + 1
+C595 = C596 + 1
+C596 = C597 + 1
+C597 = C598 + 1
+C598 = C599 + 1
+C599 = C600 + 1
+C600 = C601 + 1
+C601 = C602 + 1
+C602 = C603 + 1
+C603 = C604 + 1
+C604 = C605 + 1
+C605 = C606 + 1
+C606 = C607 + 1
+C607 = C608 + 1
+C608 = C609 + 1
+C609 = C610 + 1
+C610 = C611 + 1
+C611 = C612 + 1
+C612 = C613 + 1
+C613 = C614 + 1
+C614 = C615 + 1
+C615 = C616 + 1
+C616 = C617 + 1
+C617 = C618 + 1
+C618 = C619 + 1
+C619 = C620 + 1
+C620 = C621 + 1
+C621 = C622 + 1
+C622 = C623 + 1
+C623 = C624 + 1
+C624 = C625 + 1
+C625 = C626 + 1
+C626 = C627 + 1
+C627 = C628 + 1
+C628 = C629 + 1
+C629 = C630 + 1
+C630 = C631 + 1
+C631 = C632 + 1
+C632 = C633 + 1
+C633 = C634 + 1
+C634 = C635 + 1
+C635 = C636 + 1
+C636 = C637 + 1
+C637 = C638 + 1
+C638 = C639 + 1
+C639 = C640 + 1
+C640 = C641 + 1
+C641 = C642 + 1
+C642 = C643 + 1
+C643 = C644 + 1
+C644 = C645 + 1
+C645 = C646 + 1
+C646 = C647 + 1
+C647 = C648 + 1
+C648 = C649 + 1
+C649 = C650 + 1
+C650 = C651 + 1
+C651 = C652 + 1
+C652 = C653 + 1
+C653 = C654 + 1
+C654 = C655 + 1
+C655 = C656 + 1
+C656 = C657 + 1
+C657 = C658 + 1
+C658 = C659 + 1
+C659 = C660 + 1
+C660 = C661 + 1
+C661 = C662 + 1
+C662 = C663 + 1
+C663 = C664 + 1
+C664 = C665 + 1
+C665 = C666 + 1
+C666 = C667 + 1
+C667 = C668 + 1
+C668 = C669 + 1
+C669 = C670 + 1
+C670 = C671 + 1
+C671 = C672 + 1
+C672 = C673 + 1
+C673 = C674 + 1
+C674 = C675 + 1
+C675 = C676 + 1
+C676 = C677 + 1
+C677 = C678 + 1
+C678 = C679 + 1
+C679 = C680 + 1
+C680 = C681 + 1
+C681 = C682 + 1
+C682 = C683 + 1
+C683 = C684 + 1
+C684 = C685 + 1
+C685 = C686 + 1
+C686 = C687 + 1
+C687 = C688 + 1
+C688 = C689 + 1
+C689 = C690 + 1
+C690 = C691 + 1
+C691 = C692 + 1
+C692 = C693 + 1
+C693 = C694 + 1
+C694 = C695 + 1
+C695 = C696 + 1
+C696 = C697 + 1
+C697 = C698 + 1
+C698 = C699 + 1
+C699 = C700 + 1
+C700 = C701 + 1
+C701 = C702 + 1
+C702 = C703 + 1
+C703 = C704 + 1
+C704 = C705 + 1
+C705 = C706 + 1
+C706 = C707 + 1
+C707 = C708 + 1
+C708 = C709 + 1
+C709 = C710 + 1
+C710 = C711 + 1
+C711 = C712 + 1
+C712 = C713 + 1
+C713 = C714 + 1
+C714 = C715 + 1
+C715 = C716 + 1
+C716 = C717 + 1
+C717 = C718 + 1
+C718 = C719 + 1
+C719 = C720 + 1
+C720 = C721 + 1
+C721 = C722 + 1
+C722 = C723 + 1
+C723 = C724 + 1
+C724 = C725 + 1
+C725 = C726 + 1
+C726 = C727 + 1
+C727 = C728 + 1
+C728 = C729 + 1
+C729 = C730 + 1
+C730 = C731 + 1
+C731 = C732 + 1
+C732 = C733 + 1
+C733 = C734 + 1
+C734 = C735 + 1
+C735 = C736 + 1
+C736 = C737 + 1
+C737 = C738 + 1
+C738 = C739 + 1
+C739 = C740 + 1
+C740 = C741 + 1
+C741 = C742 + 1
+C742 = C743 + 1
+C743 = C744 + 1
+C744 = C745 + 1
+C745 = C746 + 1
+C746 = C747 + 1
+C747 = C748 + 1
+C748 = C749 + 1
+C749 = C750 + 1
+C750 = C751 + 1
+C751 = C752 + 1
+C752 = C753 + 1
+C753 = C754 + 1
+C754 = C755 + 1
+C755 = C756 + 1
+C756 = C757 + 1
+C757 = C758 + 1
+C758 = C759 + 1
+C759 = C760 + 1
+C760 = C761 + 1
+C761 = C762 + 1
+C762 = C763 + 1
+C763 = C764 + 1
+C764 = C765 + 1
+C765 = C766 + 1
+C766 = C767 + 1
+C767 = C768 + 1
+C768 = C769 + 1
+C769 = C770 + 1
+C770 = C771 + 1
+C771 = C772 + 1
+C772 = C773 + 1
+C773 = C774 + 1
+C774 = C775 + 1
+C775 = C776 + 1
+C776 = C777 + 1
+C777 = C778 + 1
+C778 = C779 + 1
+C779 = C780 + 1
+C780 = C781 + 1
+C781 = C782 + 1
+C782 = C783 + 1
+C783 = C784 + 1
+C784 = C785 + 1
+C785 = C786 + 1
+C786 = C787 + 1
+C787 = C788 + 1
+C788 = C789 + 1
+C789 = C790 + 1
+C790 = C791 + 1
+C791 = C792 + 1
+C792 = C793 + 1
+C793 = C794 + 1
+C794 = C795 + 1
+C795 = C796 + 1
+C796 = C797 + 1
+C797 = C798 + 1
+C798 = C799 + 1
+C799 = C800 + 1
+C800 = C801 + 1
+C801 = C802 + 1
+C802 = C803 + 1
+C803 = C804 + 1
+C804 = C805 + 1
+C805 = C806 + 1
+C806 = C807 + 1
+C807 = C808 + 1
+C808 = C809 + 1
+C809 = C810 + 1
+C810 = C811 + 1
+C811 = C812 + 1
+C812 = C813 + 1
+C813 = C814 + 1
+C814 = C815 + 1
+C815 = C816 + 1
+C816 = C817 + 1
+C817 = C818 + 1
+C818 = C819 + 1
+C819 = C820 + 1
+C820 = C821 + 1
+C821 = C822 + 1
+C822 = C823 + 1
+C823 = C824 + 1
+C824 = C825 + 1
+C825 = C826 + 1
+C826 = C827 + 1
+C827 = C828 + 1
+C828 = C829 + 1
+C829 = C830 + 1
+C830 = C831 + 1
+C831 = C832 + 1
+C832 = C833 + 1
+C833 = C834 + 1
+C834 = C835 + 1
+C835 = C836 + 1
+C836 = C837 + 1
+C837 = C838 + 1
+C838 = C839 + 1
+C839 = C840 + 1
+C840 = C841 + 1
+C841 = C842 + 1
+C842 = C843 + 1
+C843 = C844 + 1
+C844 = C845 + 1
+C845 = C846 + 1
+C846 = C847 + 1
+C847 = C848 + 1
+C848 = C849 + 1
+C849 = C850 + 1
+C850 = C851 + 1
+C851 = C852 + 1
+C852 = C853 + 1
+C853 = C854 + 1
+C854 = C855 + 1
+C855 = C856 + 1
+C856 = C857 + 1
+C857 = C858 + 1
+C858 = C859 + 1
+C859 = C860 + 1
+C860 = C861 + 1
+C861 = C862 + 1
+C862 = C863 + 1
+C863 = C864 + 1
+C864 = C865 + 1
+C865 = C866 + 1
+C866 = C867 + 1
+C867 = C868 + 1
+C868 = C869 + 1
+C869 = C870 + 1
+C870 = C871 + 1
+C871 = C872 + 1
+C872 = C873 + 1
+C873 = C874 + 1
+C874 = C875 + 1
+C875 = C876 + 1
+C876 = C877 + 1
+C877 = C878 + 1
+C878 = C879 + 1
+C879 = C880 + 1
+C880 = C881 + 1
+C881 = C882 + 1
+C882 = C883 + 1
+C883 = C884 + 1
+C884 = C885 + 1
+C885 = C886 + 1
+C886 = C887 + 1
+C887 = C888 + 1
+C888 = C889 + 1
+C889 = C890 + 1
+C890 = C891 + 1
+C891 = C892 + 1
+C892 = C893 + 1
+C893 = C894 + 1
+C894 = C895 + 1
+C895 = C896 + 1
+C896 = C897 + 1
+C897 = C898 + 1
+C898 = C899 + 1
+C899 = C900 + 1
+C900 = C901 + 1
+C901 = C902 + 1
+C902 = C903 + 1
+C903 = C904 + 1
+C904 = C905 + 1
+C905 = C906 + 1
+C906 = C907 + 1
+C907 = C908 + 1
+C908 = C909 + 1
+C909 = C910 + 1
+C910 = C911 + 1
+C911 = C912 + 1
+C912 = C913 + 1
+C913 = C914 + 1
+C914 = C915 + 1
+C915 = C916 + 1
+C916 = C917 + 1
+C917 = C918 + 1
+C918 = C919 + 1
+C919 = C920 + 1
+C920 = C921 + 1
+C921 = C922 + 1
+C922 = C923 + 1
+C923 = C924 + 1
+C924 = C925 + 1
+C925 = C926 + 1
+C926 = C927 + 1
+C927 = C928 + 1
+C928 = C929 + 1
+C929 = C930 + 1
+C930 = C931 + 1
+C931 = C932 + 1
+C932 = C933 + 1
+C933 = C934 + 1
+C934 = C935 + 1
+C935 = C936 + 1
+C936 = C937 + 1
+C937 = C938 + 1
+C938 = C939 + 1
+C939 = C940 + 1
+C940 = C941 + 1
+C941 = C942 + 1
+C942 = C943 + 1
+C943 = C944 + 1
+C944 = C945 + 1
+C945 = C946 + 1
+C946 = C947 + 1
+C947 = C948 + 1
+C948 = C949 + 1
+C949 = C950 + 1
+C950 = C951 + 1
+C951 = C952 + 1
+C952 = C953 + 1
+C953 = C954 + 1
+C954 = C955 + 1
+C955 = C956 + 1
+C956 = C957 + 1
+C957 = C958 + 1
+C958 = C959 + 1
+C959 = C960 + 1
+C960 = C961 + 1
+C961 = C962 + 1
+C962 = C963 + 1
+C963 = C964 + 1
+C964 = C965 + 1
+C965 = C966 + 1
+C966 = C967 + 1
+C967 = C968 + 1
+C968 = C969 + 1
+C969 = C970 + 1
+C970 = C971 + 1
+C971 = C972 + 1
+C972 = C973 + 1
+C973 = C974 + 1
+C974 = C975 + 1
+C975 = C976 + 1
+C976 = C977 + 1
+C977 = C978 + 1
+C978 = C979 + 1
+C979 = C980 + 1
+C980 = C981 + 1
+C981 = C982 + 1
+C982 = C983 + 1
+C983 = C984 + 1
+C984 = C985 + 1
+C985 = C986 + 1
+C986 = C987 + 1
+C987 = C988 + 1
+C988 = C989 + 1
+C989 = C990 + 1
+C990 = C991 + 1
+C991 = C992 + 1
+C992 = C993 + 1
+C993 = C994 + 1
+C994 = C995 + 1
+C995 = C996 + 1
+C996 = C997 + 1
+C997 = C998 + 1
+C998 = C999 + 1
+C999 = C1000 + 1
+C1000 = C1001 + 1
+C1001 = C1002 + 1
+C1002 = C1003 + 1
+C1003 = C1004 + 1
+C1004 = C1005 + 1
+C1005 = C1006 + 1
+C1006 = C1007 + 1
+C1007 = C1008 + 1
+C1008 = C1009 + 1
+C1009 = C1010 + 1
+C1010 = C1011 + 1
+C1011 = C1012 + 1
+C1012 = C1013 + 1
+C1013 = C1014 + 1
+C1014 = C1015 + 1
+C1015 = C1016 + 1
+C1016 = C1017 + 1
+C1017 = C1018 + 1
+C1018 = C1019 + 1
+C1019 = C1020 + 1
+C1020 = C1021 + 1
+C1021 = C1022 + 1
+C1022 = C1023 + 1
+C1023 = C1024 + 1
+C1024 = C1025 + 1
+C1025 = C1026 + 1
+C1026 = C1027 + 1
+C1027 = C1028 + 1
+C1028 = C1029 + 1
+C1029 = C1030 + 1
+C1030 = C1031 + 1
+C1031 = C1032 + 1
+C1032 = C1033 + 1
+C1033 = C1034 + 1
+C1034 = C1035 + 1
+C1035 = C1036 + 1
+C1036 = C1037 + 1
+C1037 = C1038 + 1
+C1038 = C1039 + 1
+C1039 = C1040 + 1
+C1040 = C1041 + 1
+C1041 = C1042 + 1
+C1042 = C1043 + 1
+C1043 = C1044 + 1
+C1044 = C1045 + 1
+C1045 = C1046 + 1
+C1046 = C1047 + 1
+C1047 = C1048 + 1
+C1048 = C1049 + 1
+C1049 = C1050 + 1
+C1050 = C1051 + 1
+C1051 = C1052 + 1
+C1052 = C1053 + 1
+C1053 = C1054 + 1
+C1054 = C1055 + 1
+C1055 = C1056 + 1
+C1056 = C1057 + 1
+C1057 = C1058 + 1
+C1058 = C1059 + 1
+C1059 = C1060 + 1
+C1060 = C1061 + 1
+C1061 = C1062 + 1
+C1062 = C1063 + 1
+C1063 = C1064 + 1
+C1064 = C1065 + 1
+C1065 = C1066 + 1
+C1066 = C1067 + 1
+C1067 = C1068 + 1
+C1068 = C1069 + 1
+C1069 = C1070 + 1
+C1070 = C1071 + 1
+C1071 = C1072 + 1
+C1072 = C1073 + 1
+C1073 = C1074 + 1
+C1074 = C1075 + 1
+C1075 = C1076 + 1
+C1076 = C1077 + 1
+C1077 = C1078 + 1
+C1078 = C1079 + 1
+C1079 = C1080 + 1
+C1080 = C1081 + 1
+C1081 = C1082 + 1
+C1082 = C1083 + 1
+C1083 = C1084 + 1
+C1084 = C1085 + 1
+C1085 = C1086 + 1
+C1086 = C1087 + 1
+C1087 = C1088 + 1
+C1088 = C1089 + 1
+C1089 = C1090 + 1
+C1090 = C1091 + 1
+C1091 = C1092 + 1
+C1092 = C1093 + 1
+C1093 = C1094 + 1
+C1094 = C1095 + 1
+C1095 = C1096 + 1
+C1096 = C1097 + 1
+C1097 = C1098 + 1
+C1098 = C1099 + 1
+C1099 = C1100 + 1
+C1100 = C1101 + 1
+C1101 = C1102 + 1
+C1102 = C1103 + 1
+C1103 = C1104 + 1
+C1104 = C1105 + 1
+C1105 = C1106 + 1
+C1106 = C1107 + 1
+C1107 = C1108 + 1
+C1108 = C1109 + 1
+C1109 = C1110 + 1
+C1110 = C1111 + 1
+C1111 = C1112 + 1
+C1112 = C1113 + 1
+C1113 = C1114 + 1
+C1114 = C1115 + 1
+C1115 = C1116 + 1
+C1116 = C1117 + 1
+C1117 = C1118 + 1
+C1118 = C1119 + 1
+C1119 = C1120 + 1
+C1120 = C1121 + 1
+C1121 = C1122 + 1
+C1122 = C1123 + 1
+C1123 = C1124 + 1
+C1124 = C1125 + 1
+C1125 = C1126 + 1
+C1126 = C1127 + 1
+C1127 = C1128 + 1
+C1128 = C1129 + 1
+C1129 = C1130 + 1
+C1130 = C1131 + 1
+C1131 = C1132 + 1
+C1132 = C1133 + 1
+C1133 = C1134 + 1
+C1134 = C1135 + 1
+C1135 = C1136 + 1
+C1136 = C1137 + 1
+C1137 = C1138 + 1
+C1138 = C1139 + 1
+C1139 = C1140 + 1
+C1140 = C1141 + 1
+C1141 = C1142 + 1
+C1142 = C1143 + 1
+C1143 = C1144 + 1
+C1144 = C1145 + 1
+C1145 = C1146 + 1
+C1146 = C1147 + 1
+C1147 = C1148 + 1
+C1148 = C1149 + 1
+C1149 = C1150 + 1
+C1150 = C1151 + 1
+C1151 = C1152 + 1
+C1152 = C1153 + 1
+C1153 = C1154 + 1
+C1154 = C1155 + 1
+C1155 = C1156 + 1
+C1156 = C1157 + 1
+C1157 = C1158 + 1
+C1158 = C1159 + 1
+C1159 = C1160 + 1
+C1160 = C1161 + 1
+C1161 = C1162 + 1
+C1162 = C1163 + 1
+C1163 = C1164 + 1
+C1164 = C1165 + 1
+C1165 = C1166 + 1
+C1166 = C1167 + 1
+C1167 = C1168 + 1
+C1168 = C1169 + 1
+C1169 = C1170 + 1
+C1170 = C1171 + 1
+C1171 = C1172 + 1
+C1172 = C1173 + 1
+C1173 = C1174 + 1
+C1174 = C1175 + 1
+C1175 = C1176 + 1
+C1176 = C1177 + 1
+C1177 = C1178 + 1
+C1178 = C1179 + 1
+C1179 = C1180 + 1
+C1180 = C1181 + 1
+C1181 = C1182 + 1
+C1182 = C1183 + 1
+C1183 = C1184 + 1
+C1184 = C1185 + 1
+C1185 = C1186 + 1
+C1186 = C1187 + 1
+C1187 = C1188 + 1
+C1188 = C1189 + 1
+C1189 = C1190 + 1
+C1190 = C1191 + 1
+C1191 = C1192 + 1
+C1192 = C1193 + 1
+C1193 = C1194 + 1
+C1194 = C1195 + 1
+C1195 = C1196 + 1
+C1196 = C1197 + 1
+C1197 = C1198 + 1
+C1198 = C1199 + 1
+C1199 = C1200 + 1
+C1200 = C1201 + 1
+C1201 = C1202 + 1
+C1202 = C1203 + 1
+C1203 = C1204 + 1
+C1204 = C1205 + 1
+C1205 = C1206 + 1
+C1206 = C1207 + 1
+C1207 = C1208 + 1
+C1208 = C1209 + 1
+C1209 = C1210 + 1
+C1210 = C1211 + 1
+C1211 = C1212 + 1
+C1212 = C1213 + 1
+C1213 = C1214 + 1
+C1214 = C1215 + 1
+C1215 = C1216 + 1
+C1216 = C1217 + 1
+C1217 = C1218 + 1
+C1218 = C1219 + 1
+C1219 = C1220 + 1
+C1220 = C1221 + 1
+C1221 = C1222 + 1
+C1222 = C1223 + 1
+C1223 = C1224 + 1
+C1224 = C1225 + 1
+C1225 = C1226 + 1
+C1226 = C1227 + 1
+C1227 = C1228 + 1
+C1228 = C1229 + 1
+C1229 = C1230 + 1
+C1230 = C1231 + 1
+C1231 = C1232 + 1
+C1232 = C1233 + 1
+C1233 = C1234 + 1
+C1234 = C1235 + 1
+C1235 = C1236 + 1
+C1236 = C1237 + 1
+C1237 = C1238 + 1
+C1238 = C1239 + 1
+C1239 = C1240 + 1
+C1240 = C1241 + 1
+C1241 = C1242 + 1
+C1242 = C1243 + 1
+C1243 = C1244 + 1
+C1244 = C1245 + 1
+C1245 = C1246 + 1
+C1246 = C1247 + 1
+C1247 = C1248 + 1
+C1248 = C1249 + 1
+C1249 = C1250 + 1
+C1250 = C1251 + 1
+C1251 = C1252 + 1
+C1252 = C1253 + 1
+C1253 = C1254 + 1
+C1254 = C1255 + 1
+C1255 = C1256 + 1
+C1256 = C1257 + 1
+C1257 = C1258 + 1
+C1258 = C1259 + 1
+C1259 = C1260 + 1
+C1260 = C1261 + 1
+C1261 = C1262 + 1
+C1262 = C1263 + 1
+C1263 = C1264 + 1
+C1264 = C1265 + 1
+C1265 = C1266 + 1
+C1266 = C1267 + 1
+C1267 = C1268 + 1
+C1268 = C1269 + 1
+C1269 = C1270 + 1
+C1270 = C1271 + 1
+C1271 = C1272 + 1
+C1272 = C1273 + 1
+C1273 = C1274 + 1
+C1274 = C1275 + 1
+C1275 = C1276 + 1
+C1276 = C1277 + 1
+C1277 = C1278 + 1
+C1278 = C1279 + 1
+C1279 = C1280 + 1
+C1280 = C1281 + 1
+C1281 = C1282 + 1
+C1282 = C1283 + 1
+C1283 = C1284 + 1
+C1284 = C1285 + 1
+C1285 = C1286 + 1
+C1286 = C1287 + 1
+C1287 = C1288 + 1
+C1288 = C1289 + 1
+C1289 = C1290 + 1
+C1290 = C1291 + 1
+C1291 = C1292 + 1
+C1292 = C1293 + 1
+C1293 = C1294 + 1
+C1294 = C1295 + 1
+C1295 = C1296 + 1
+C1296 = C1297 + 1
+C1297 = C1298 + 1
+C1298 = C1299 + 1
+C1299 = C1300 + 1
+C1300 = C1301 + 1
+C1301 = C1302 + 1
+C1302 = C1303 + 1
+C1303 = C1304 + 1
+C1304 = C1305 + 1
+C1305 = C1306 + 1
+C1306 = C1307 + 1
+C1307 = C1308 + 1
+C1308 = C1309 + 1
+C1309 = C1310 + 1
+C1310 = C1311 + 1
+C1311 = C1312 + 1
+C1312 = C1313 + 1
+C1313 = C1314 + 1
+C1314 = C1315 + 1
+C1315 = C1316 + 1
+C1316 = C1317 + 1
+C1317 = C1318 + 1
+C1318 = C1319 + 1
+C1319 = C1320 + 1
+C1320 = C1321 + 1
+C1321 = C1322 + 1
+C1322 = C1323 + 1
+C1323 = C1324 + 1
+C1324 = C1325 + 1
+C1325 = C1326 + 1
+C1326 = C1327 + 1
+C1327 = C1328 + 1
+C1328 = C1329 + 1
+C1329 = C1330 + 1
+C1330 = C1331 + 1
+C1331 = C1332 + 1
+C1332 = C1333 + 1
+C1333 = C1334 + 1
+C1334 = C1335 + 1
+C1335 = C1336 + 1
+C1336 = C1337 + 1
+C1337 = C1338 + 1
+C1338 = C1339 + 1
+C1339 = C1340 + 1
+C1340 = C1341 + 1
+C1341 = C1342 + 1
+C1342 = C1343 + 1
+C1343 = C1344 + 1
+C1344 = C1345 + 1
+C1345 = C1346 + 1
+C1346 = C1347 + 1
+C1347 = C1348 + 1
+C1348 = C1349 + 1
+C1349 = C1350 + 1
+C1350 = C1351 + 1
+C1351 = C1352 + 1
+C1352 = C1353 + 1
+C1353 = C1354 + 1
+C1354 = C1355 + 1
+C1355 = C1356 + 1
+C1356 = C1357 + 1
+C1357 = C1358 + 1
+C1358 = C1359 + 1
+C1359 = C1360 + 1
+C1360 = C1361 + 1
+C1361 = C1362 + 1
+C1362 = C1363 + 1
+C1363 = C1364 + 1
+C1364 = C1365 + 1
+C1365 = C1366 + 1
+C1366 = C1367 + 1
+C1367 = C1368 + 1
+C1368 = C1369 + 1
+C1369 = C1370 + 1
+C1370 = C1371 + 1
+C1371 = C1372 + 1
+C1372 = C1373 + 1
+C1373 = C1374 + 1
+C1374 = C1375 + 1
+C1375 = C1376 + 1
+C1376 = C1377 + 1
+C1377 = C1378 + 1
+C1378 = C1379 + 1
+C1379 = C1380 + 1
+C1380 = C1381 + 1
+C1381 = C1382 + 1
+C1382 = C1383 + 1
+C1383 = C1384 + 1
+C1384 = C1385 + 1
+C1385 = C1386 + 1
+C1386 = C1387 + 1
+C1387 = C1388 + 1
+C1388 = C1389 + 1
+C1389 = C1390 + 1
+C1390 = C1391 + 1
+C1391 = C1392 + 1
+C1392 = C1393 + 1
+C1393 = C1394 + 1
+C1394 = C1395 + 1
+C1395 = C1396 + 1
+C1396 = C1397 + 1
+C1397 = C1398 + 1
+C1398 = C1399 + 1
+C1399 = C1400 + 1
+C1400 = C1401 + 1
+C1401 = C1402 + 1
+C1402 = C1403 + 1
+C1403 = C1404 + 1
+C1404 = C1405 + 1
+C1405 = C1406 + 1
+C1406 = C1407 + 1
+C1407 = C1408 + 1
+C1408 = C1409 + 1
+C1409 = C1410 + 1
+C1410 = C1411 + 1
+C1411 = C1412 + 1
+C1412 = C1413 + 1
+C1413 = C1414 + 1
+C1414 = C1415 + 1
+C1415 = C1416 + 1
+C1416 = C1417 + 1
+C1417 = C1418 + 1
+C1418 = C1419 + 1
+C1419 = C1420 + 1
+C1420 = C1421 + 1
+C1421 = C1422 + 1
+C1422 = C1423 + 1
+C1423 = C1424 + 1
+C1424 = C1425 + 1
+C1425 = C1426 + 1
+C1426 = C1427 + 1
+C1427 = C1428 + 1
+C1428 = C1429 + 1
+C1429 = C1430 + 1
+C1430 = C1431 + 1
+C1431 = C1432 + 1
+C1432 = C1433 + 1
+C1433 = C1434 + 1
+C1434 = C1435 + 1
+C1435 = C1436 + 1
+C1436 = C1437 + 1
+C1437 = C1438 + 1
+C1438 = C1439 + 1
+C1439 = C1440 + 1
+C1440 = C1441 + 1
+C1441 = C1442 + 1
+C1442 = C1443 + 1
+C1443 = C1444 + 1
+C1444 = C1445 + 1
+C1445 = C1446 + 1
+C1446 = C1447 + 1
+C1447 = C1448 + 1
+C1448 = C1449 + 1
+C1449 = C1450 + 1
+C1450 = C1451 + 1
+C1451 = C1452 + 1
+C1452 = C1453 + 1
+C1453 = C1454 + 1
+C1454 = C1455 + 1
+C1455 = C1456 + 1
+C1456 = C1457 + 1
+C1457 = C1458 + 1
+C1458 = C1459 + 1
+C1459 = C1460 + 1
+C1460 = C1461 + 1
+C1461 = C1462 + 1
+C1462 = C1463 + 1
+C1463 = C1464 + 1
+C1464 = C1465 + 1
+C1465 = C1466 + 1
+C1466 = C1467 + 1
+C1467 = C1468 + 1
+C1468 = C1469 + 1
+C1469 = C1470 + 1
+C1470 = C1471 + 1
+C1471 = C1472 + 1
+C1472 = C1473 + 1
+C1473 = C1474 + 1
+C1474 = C1475 + 1
+C1475 = C1476 + 1
+C1476 = C1477 + 1
+C1477 = C1478 + 1
+C1478 = C1479 + 1
+C1479 = C1480 + 1
+C1480 = C1481 + 1
+C1481 = C1482 + 1
+C1482 = C1483 + 1
+C1483 = C1484 + 1
+C1484 = C1485 + 1
+C1485 = C1486 + 1
+C1486 = C1487 + 1
+C1487 = C1488 + 1
+C1488 = C1489 + 1
+C1489 = C1490 + 1
+C1490 = C1491 + 1
+C1491 = C1492 + 1
+C1492 = C1493 + 1
+C1493 = C1494 + 1
+C1494 = C1495 + 1
+C1495 = C1496 + 1
+C1496 = C1497 + 1
+C1497 = C1498 + 1
+C1498 = C1499 + 1
+C1499 = C1500 + 1
+C1500 = C1501 + 1
+C1501 = C1502 + 1
+C1502 = C1503 + 1
+C1503 = C1504 + 1
+C1504 = C1505 + 1
+C1505 = C1506 + 1
+C1506 = C1507 + 1
+C1507 = C1508 + 1
+C1508 = C1509 + 1
+C1509 = C1510 + 1
+C1510 = C1511 + 1
+C1511 = C1512 + 1
+C1512 = C1513 + 1
+C1513 = C1514 + 1
+C1514 = C1515 + 1
+C1515 = C1516 + 1
+C1516 = C1517 + 1
+C1517 = C1518 + 1
+C1518 = C1519 + 1
+C1519 = C1520 + 1
+C1520 = C1521 + 1
+C1521 = C1522 + 1
+C1522 = C1523 + 1
+C1523 = C1524 + 1
+C1524 = C1525 + 1
+C1525 = C1526 + 1
+C1526 = C1527 + 1
+C1527 = C1528 + 1
+C1528 = C1529 + 1
+C1529 = C1530 + 1
+C1530 = C1531 + 1
+C1531 = C1532 + 1
+C1532 = C1533 + 1
+C1533 = C1534 + 1
+C1534 = C1535 + 1
+C1535 = C1536 + 1
+C1536 = C1537 + 1
+C1537 = C1538 + 1
+C1538 = C1539 + 1
+C1539 = C1540 + 1
+C1540 = C1541 + 1
+C1541 = C1542 + 1
+C1542 = C1543 + 1
+C1543 = C1544 + 1
+C1544 = C1545 + 1
+C1545 = C1546 + 1
+C1546 = C1547 + 1
+C1547 = C1548 + 1
+C1548 = C1549 + 1
+C1549 = C1550 + 1
+C1550 = C1551 + 1
+C1551 = C1552 + 1
+C1552 = C1553 + 1
+C1553 = C1554 + 1
+C1554 = C1555 + 1
+C1555 = C1556 + 1
+C1556 = C1557 + 1
+C1557 = C1558 + 1
+C1558 = C1559 + 1
+C1559 = C1560 + 1
+C1560 = C1561 + 1
+C1561 = C1562 + 1
+C1562 = C1563 + 1
+C1563 = C1564 + 1
+C1564 = C1565 + 1
+C1565 = C1566 + 1
+C1566 = C1567 + 1
+C1567 = C1568 + 1
+C1568 = C1569 + 1
+C1569 = C1570 + 1
+C1570 = C1571 + 1
+C1571 = C1572 + 1
+C1572 = C1573 + 1
+C1573 = C1574 + 1
+C1574 = C1575 + 1
+C1575 = C1576 + 1
+C1576 = C1577 + 1
+C1577 = C1578 + 1
+C1578 = C1579 + 1
+C1579 = C1580 + 1
+C1580 = C1581 + 1
+C1581 = C1582 + 1
+C1582 = C1583 + 1
+C1583 = C1584 + 1
+C1584 = C1585 + 1
+C1585 = C1586 + 1
+C1586 = C1587 + 1
+C1587 = C1588 + 1
+C1588 = C1589 + 1
+C1589 = C1590 + 1
+C1590 = C1591 + 1
+C1591 = C1592 + 1
+C1592 = C1593 + 1
+C1593 = C1594 + 1
+C1594 = C1595 + 1
+C1595 = C1596 + 1
+C1596 = C1597 + 1
+C1597 = C1598 + 1
+C1598 = C1599 + 1
+C1599 = C1600 + 1
+C1600 = C1601 + 1
+C1601 = C1602 + 1
+C1602 = C1603 + 1
+C1603 = C1604 + 1
+C1604 = C1605 + 1
+C1605 = C1606 + 1
+C1606 = C1607 + 1
+C1607 = C1608 + 1
+C1608 = C1609 + 1
+C1609 = C1610 + 1
+C1610 = C1611 + 1
+C1611 = C1612 + 1
+C1612 = C1613 + 1
+C1613 = C1614 + 1
+C1614 = C1615 + 1
+C1615 = C1616 + 1
+C1616 = C1617 + 1
+C1617 = C1618 + 1
+C1618 = C1619 + 1
+C1619 = C1620 + 1
+C1620 = C1621 + 1
+C1621 = C1622 + 1
+C1622 = C1623 + 1
+C1623 = C1624 + 1
+C1624 = C1625 + 1
+C1625 = C1626 + 1
+C1626 = C1627 + 1
+C1627 = C1628 + 1
+C1628 = C1629 + 1
+C1629 = C1630 + 1
+C1630 = C1631 + 1
+C1631 = C1632 + 1
+C1632 = C1633 + 1
+C1633 = C1634 + 1
+C1634 = C1635 + 1
+C1635 = C1636 + 1
+C1636 = C1637 + 1
+C1637 = C1638 + 1
+C1638 = C1639 + 1
+C1639 = C1640 + 1
+C1640 = C1641 + 1
+C1641 = C1642 + 1
+C1642 = C1643 + 1
+C1643 = C1644 + 1
+C1644 = C1645 + 1
+C1645 = C1646 + 1
+C1646 = C1647 + 1
+C1647 = C1648 + 1
+C1648 = C1649 + 1
+C1649 = C1650 + 1
+C1650 = C1651 + 1
+C1651 = C1652 + 1
+C1652 = C1653 + 1
+C1653 = C1654 + 1
+C1654 = C1655 + 1
+C1655 = C1656 + 1
+C1656 = C1657 + 1
+C1657 = C1658 + 1
+C1658 = C1659 + 1
+C1659 = C1660 + 1
+C1660 = C1661 + 1
+C1661 = C1662 + 1
+C1662 = C1663 + 1
+C1663 = C1664 + 1
+C1664 = C1665 + 1
+C1665 = C1666 + 1
+C1666 = C1667 + 1
+C1667 = C1668 + 1
+C1668 = C1669 + 1
+C1669 = C1670 + 1
+C1670 = C1671 + 1
+C1671 = C1672 + 1
+C1672 = C1673 + 1
+C1673 = C1674 + 1
+C1674 = C1675 + 1
+C1675 = C1676 + 1
+C1676 = C1677 + 1
+C1677 = C1678 + 1
+C1678 = C1679 + 1
+C1679 = C1680 + 1
+C1680 = C1681 + 1
+C1681 = C1682 + 1
+C1682 = C1683 + 1
+C1683 = C1684 + 1
+C1684 = C1685 + 1
+C1685 = C1686 + 1
+C1686 = C1687 + 1
+C1687 = C1688 + 1
+C1688 = C1689 + 1
+C1689 = C1690 + 1
+C1690 = C1691 + 1
+C1691 = C1692 + 1
+C1692 = C1693 + 1
+C1693 = C1694 + 1
+C1694 = C1695 + 1
+C1695 = C1696 + 1
+C1696 = C1697 + 1
+C1697 = C1698 + 1
+C1698 = C1699 + 1
+C1699 = C1700 + 1
+C1700 = C1701 + 1
+C1701 = C1702 + 1
+C1702 = C1703 + 1
+C1703 = C1704 + 1
+C1704 = C1705 + 1
+C1705 = C1706 + 1
+C1706 = C1707 + 1
+C1707 = C1708 + 1
+C1708 = C1709 + 1
+C1709 = C1710 + 1
+C1710 = C1711 + 1
+C1711 = C1712 + 1
+C1712 = C1713 + 1
+C1713 = C1714 + 1
+C1714 = C1715 + 1
+C1715 = C1716 + 1
+C1716 = C1717 + 1
+C1717 = C1718 + 1
+C1718 = C1719 + 1
+C1719 = C1720 + 1
+C1720 = C1721 + 1
+C1721 = C1722 + 1
+C1722 = C1723 + 1
+C1723 = C1724 + 1
+C1724 = C1725 + 1
+C1725 = C1726 + 1
+C1726 = C1727 + 1
+C1727 = C1728 + 1
+C1728 = C1729 + 1
+C1729 = C1730 + 1
+C1730 = C1731 + 1
+C1731 = C1732 + 1
+C1732 = C1733 + 1
+C1733 = C1734 + 1
+C1734 = C1735 + 1
+C1735 = C1736 + 1
+C1736 = C1737 + 1
+C1737 = C1738 + 1
+C1738 = C1739 + 1
+C1739 = C1740 + 1
+C1740 = C1741 + 1
+C1741 = C1742 + 1
+C1742 = C1743 + 1
+C1743 = C1744 + 1
+C1744 = C1745 + 1
+C1745 = C1746 + 1
+C1746 = C1747 + 1
+C1747 = C1748 + 1
+C1748 = C1749 + 1
+C1749 = C1750 + 1
+C1750 = C1751 + 1
+C1751 = C1752 + 1
+C1752 = C1753 + 1
+C1753 = C1754 + 1
+C1754 = C1755 + 1
+C1755 = C1756 + 1
+C1756 = C1757 + 1
+C1757 = C1758 + 1
+C1758 = C1759 + 1
+C1759 = C1760 + 1
+C1760 = C1761 + 1
+C1761 = C1762 + 1
+C1762 = C1763 + 1
+C1763 = C1764 + 1
+C1764 = C1765 + 1
+C1765 = C1766 + 1
+C1766 = C1767 + 1
+C1767 = C1768 + 1
+C1768 = C1769 + 1
+C1769 = C1770 + 1
+C1770 = C1771 + 1
+C1771 = C1772 + 1
+C1772 = C1773 + 1
+C1773 = C1774 + 1
+C1774 = C1775 + 1
+C1775 = C1776 + 1
+C1776 = C1777 + 1
+C1777 = C1778 + 1
+C1778 = C1779 + 1
+C1779 = C1780 + 1
+C1780 = C1781 + 1
+C1781 = C1782 + 1
+C1782 = C1783 + 1
+C1783 = C1784 + 1
+C1784 = C1785 + 1
+C1785 = C1786 + 1
+C1786 = C1787 + 1
+C1787 = C1788 + 1
+C1788 = C1789 + 1
+C1789 = C1790 + 1
+C1790 = C1791 + 1
+C1791 = C1792 + 1
+C1792 = C1793 + 1
+C1793 = C1794 + 1
+C1794 = C1795 + 1
+C1795 = C1796 + 1
+C1796 = C1797 + 1
+C1797 = C1798 + 1
+C1798 = C1799 + 1
+C1799 = C1800 + 1
+C1800 = C1801 + 1
+C1801 = C1802 + 1
+C1802 = C1803 + 1
+C1803 = C1804 + 1
+C1804 = C1805 + 1
+C1805 = C1806 + 1
+C1806 = C1807 + 1
+C1807 = C1808 + 1
+C1808 = C1809 + 1
+C1809 = C1810 + 1
+C1810 = C1811 + 1
+C1811 = C1812 + 1
+C1812 = C1813 + 1
+C1813 = C1814 + 1
+C1814 = C1815 + 1
+C1815 = C1816 + 1
+C1816 = C1817 + 1
+C1817 = C1818 + 1
+C1818 = C1819 + 1
+C1819 = C1820 + 1
+C1820 = C1821 + 1
+C1821 = C1822 + 1
+C1822 = C1823 + 1
+C1823 = C1824 + 1
+C1824 = C1825 + 1
+C1825 = C1826 + 1
+C1826 = C1827 + 1
+C1827 = C1828 + 1
+C1828 = C1829 + 1
+C1829 = C1830 + 1
+C1830 = C1831 + 1
+C1831 = C1832 + 1
+C1832 = C1833 + 1
+C1833 = C1834 + 1
+C1834 = C1835 + 1
+C1835 = C1836 + 1
+C1836 = C1837 + 1
+C1837 = C1838 + 1
+C1838 = C1839 + 1
+C1839 = C1840 + 1
+C1840 = C1841 + 1
+C1841 = C1842 + 1
+C1842 = C1843 + 1
+C1843 = C1844 + 1
+C1844 = C1845 + 1
+C1845 = C1846 + 1
+C1846 = C1847 + 1
+C1847 = C1848 + 1
+C1848 = C1849 + 1
+C1849 = C1850 + 1
+C1850 = C1851 + 1
+C1851 = C1852 + 1
+C1852 = C1853 + 1
+C1853 = C1854 + 1
+C1854 = C1855 + 1
+C1855 = C1856 + 1
+C1856 = C1857 + 1
+C1857 = C1858 + 1
+C1858 = C1859 + 1
+C1859 = C1860 + 1
+C1860 = C1861 + 1
+C1861 = C1862 + 1
+C1862 = C1863 + 1
+C1863 = C1864 + 1
+C1864 = C1865 + 1
+C1865 = C1866 + 1
+C1866 = C1867 + 1
+C1867 = C1868 + 1
+C1868 = C1869 + 1
+C1869 = C1870 + 1
+C1870 = C1871 + 1
+C1871 = C1872 + 1
+C1872 = C1873 + 1
+C1873 = C1874 + 1
+C1874 = C1875 + 1
+C1875 = C1876 + 1
+C1876 = C1877 + 1
+C1877 = C1878 + 1
+C1878 = C1879 + 1
+C1879 = C1880 + 1
+C1880 = C1881 + 1
+C1881 = C1882 + 1
+C1882 = C1883 + 1
+C1883 = C1884 + 1
+C1884 = C1885 + 1
+C1885 = C1886 + 1
+C1886 = C1887 + 1
+C1887 = C1888 + 1
+C1888 = C1889 + 1
+C1889 = C1890 + 1
+C1890 = C1891 + 1
+C1891 = C1892 + 1
+C1892 = C1893 + 1
+C1893 = C1894 + 1
+C1894 = C1895 + 1
+C1895 = C1896 + 1
+C1896 = C1897 + 1
+C1897 = C1898 + 1
+C1898 = C1899 + 1
+C1899 = C1900 + 1
+C1900 = C1901 + 1
+C1901 = C1902 + 1
+C1902 = C1903 + 1
+C1903 = C1904 + 1
+C1904 = C1905 + 1
+C1905 = C1906 + 1
+C1906 = C1907 + 1
+C1907 = C1908 + 1
+C1908 = C1909 + 1
+C1909 = C1910 + 1
+C1910 = C1911 + 1
+C1911 = C1912 + 1
+C1912 = C1913 + 1
+C1913 = C1914 + 1
+C1914 = C1915 + 1
+C1915 = C1916 + 1
+C1916 = C1917 + 1
+C1917 = C1918 + 1
+C1918 = C1919 + 1
+C1919 = C1920 + 1
+C1920 = C1921 + 1
+C1921 = C1922 + 1
+C1922 = C1923 + 1
+C1923 = C1924 + 1
+C1924 = C1925 + 1
+C1925 = C1926 + 1
+C1926 = C1927 + 1
+C1927 = C1928 + 1
+C1928 = C1929 + 1
+C1929 = C1930 + 1
+C1930 = C1931 + 1
+C1931 = C1932 + 1
+C1932 = C1933 + 1
+C1933 = C1934 + 1
+C1934 = C1935 + 1
+C1935 = C1936 + 1
+C1936 = C1937 + 1
+C1937 = C1938 + 1
+C1938 = C1939 + 1
+C1939 = C1940 + 1
+C1940 = C1941 + 1
+C1941 = C1942 + 1
+C1942 = C1943 + 1
+C1943 = C1944 + 1
+C1944 = C1945 + 1
+C1945 = C1946 + 1
+C1946 = C1947 + 1
+C1947 = C1948 + 1
+C1948 = C1949 + 1
+C1949 = C1950 + 1
+C1950 = C1951 + 1
+C1951 = C1952 + 1
+C1952 = C1953 + 1
+C1953 = C1954 + 1
+C1954 = C1955 + 1
+C1955 = C1956 + 1
+C1956 = C1957 + 1
+C1957 = C1958 + 1
+C1958 = C1959 + 1
+C1959 = C1960 + 1
+C1960 = C1961 + 1
+C1961 = C1962 + 1
+C1962 = C1963 + 1
+C1963 = C1964 + 1
+C1964 = C1965 + 1
+C1965 = C1966 + 1
+C1966 = C1967 + 1
+C1967 = C1968 + 1
+C1968 = C1969 + 1
+C1969 = C1970 + 1
+C1970 = C1971 + 1
+C1971 = C1972 + 1
+C1972 = C1973 + 1
+C1973 = C1974 + 1
+C1974 = C1975 + 1
+C1975 = C1976 + 1
+C1976 = C1977 + 1
+C1977 = C1978 + 1
+C1978 = C1979 + 1
+C1979 = C1980 + 1
+C1980 = C1981 + 1
+C1981 = C1982 + 1
+C1982 = C1983 + 1
+C1983 = C1984 + 1
+C1984 = C1985 + 1
+C1985 = C1986 + 1
+C1986 = C1987 + 1
+C1987 = C1988 + 1
+C1988 = C1989 + 1
+C1989 = C1990 + 1
+C1990 = C1991 + 1
+C1991 = C1992 + 1
+C1992 = C1993 + 1
+C1993 = C1994 + 1
+C1994 = C1995 + 1
+C1995 = C1996 + 1
+C1996 = C1997 + 1
+C1997 = C1998 + 1
+C1998 = C1999 + 1
+C1999 = 1
@@ -0,0 +1,10 @@
+; a .rept count can use global constants
+.segment "CODE"
+start:
+    .word 0
+    .word 1
+    .word 2
+    .word 3
+    .word 4
+    mov r1, r2
+    mov r1, r2
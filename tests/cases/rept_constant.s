@@ -0,0 +1,11 @@
+; a .rept count can use global constants
+SIZE = 2
+TOTAL = SIZE * 2 + 1
+.segment "CODE"
+start:
+    .rept TOTAL, i
+    .word i
+    .endr
+    .rept SIZE
+    mov r1, r2
+    .endr
@@ -0,0 +1,18 @@
+; each iteration of a .rept block has its own local labels
+.segment "CODE"
+start:
+    bne @done
+@loop0:
+    .word 0
+    bne @loop0
+@loop1:
+    .word 1
+    bne @loop1
+    beq @loop1
+@loop2:
+    .word 2
+    bne @loop2
+    beq @loop2
+    beq @loop2
+@done:
+    mov r1, r2
@@ -0,0 +1,14 @@
+; each iteration of a .rept block has its own local labels
+.segment "CODE"
+start:
+    bne @done
+    .rept 3, i
+@loop:
+    .word i
+    bne @loop
+    .rept i
+    beq @loop
+    .endr
+    .endr
+@done:
+    mov r1, r2
@@ -0,0 +1,15 @@
+; a .rept count can use the parameters of the enclosing macro call, even when other arguments are later labels
+.segment "CODE"
+start:
+@top0:
+    .word 7 + 0
+    .word 7 + 1
+    bne @top0
+@top1:
+    .word later + 0
+    .word later + 1
+    .word later + 2
+    bne @top1
+    bne @top1
+later:
+    mov r1, r2
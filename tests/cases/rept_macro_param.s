@@ -0,0 +1,16 @@
+; a .rept count can use the parameters of the enclosing macro call, even when other arguments are later labels
+.macro fill n, v
+@top:
+    .rept n, i
+    .word v + i
+    .endr
+    .rept n - 1
+    bne @top
+    .endr
+.endmacro
+.segment "CODE"
+start:
+    fill 2, 7
+    fill 3, later
+later:
+    mov r1, r2
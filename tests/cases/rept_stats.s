@@ -0,0 +1,12 @@
+; args: --stats
+; .rept blocks are not listed with the macros
+.macro twice
+    .rept 2
+    mov r1, r2
+    .endr
+.endmacro
+.segment "CODE"
+start:
+    .rept 2
+    twice
+    .endr
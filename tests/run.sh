@@ -0,0 +1,65 @@
+#!/bin/sh
+# assembles the test cases and compares their output with the output of their references
+#
+# usage: tests/run.sh
+# tests/cases/<name>.s is assembled with the default configuration and compared with <name>.ref.s,
+# the same code written without the feature under test
+# a first line of "; args: <options>" passes extra options when assembling the case
+# every line of <name>.expect, if there is one, has to be printed when assembling the case
+#
+# Written by Adam Billings
+
+cd "$(dirname "$0")"
+ACE=../ace3710
+CASES=$(pwd)/cases # the assembler moves to the directory of the source, so paths are absolute
+
+if [ ! -x "$ACE" ]; then
+    echo "ERROR: $ACE not found, run make first" >&2
+    exit 1
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+echo "  -- Assembly Cases --"
+COUNT=0
+FAILED=0
+for CASE in "$CASES"/*.s; do
+    case "$CASE" in *.ref.s) continue ;; esac
+    NAME=$(basename "$CASE" .s)
+    ARGS=$(head -n 1 "$CASE" | sed -n 's/^; args: //p')
+    COUNT=$((COUNT + 1))
+
+    # the case has to assemble
+    if ! "$ACE" -d --ihex $ARGS -o "$WORK/$NAME.hex" "$CASE" > "$WORK/$NAME.log" 2>&1; then
+        echo "    $NAME: did not assemble"
+        sed 's/^/      /' "$WORK/$NAME.log"
+        FAILED=$((FAILED + 1))
+        continue
+    fi
+
+    # same output as the reference
+    if [ -f "$CASES/$NAME.ref.s" ]; then
+        "$ACE" -d --ihex -o "$WORK/$NAME.ref.hex" "$CASES/$NAME.ref.s" > "$WORK/$NAME.ref.log" 2>&1
+        if ! cmp -s "$WORK/$NAME.hex" "$WORK/$NAME.ref.hex"; then
+            echo "    $NAME: output differs from $NAME.ref.s"
+            FAILED=$((FAILED + 1))
+            continue
+        fi
+    fi
+
+    # expected lines in the printout
+    if [ -f "$CASES/$NAME.expect" ]; then
+        while IFS= read -r LINE; do
+            if ! grep -qF -- "$LINE" "$WORK/$NAME.log"; then
+                echo "    $NAME: missing \"$LINE\""
+                FAILED=$((FAILED + 1))
+                continue 2
+            fi
+        done < "$CASES/$NAME.expect"
+    fi
+done
+
+echo "    $COUNT cases, $FAILED failed"
+echo
+[ "$FAILED" -eq 0 ]